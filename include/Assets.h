@@ -0,0 +1,10 @@
+// Gerado por tools/asset_converter.py a partir de assets/assets.json. Não editar.
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "CompressedAsset.h"
+
+// logo.pbm: 128x64, 1024 -> 370 bytes (ASSET_RLE)
+extern const CompressedBitmap logoBitmap;
+
+#endif
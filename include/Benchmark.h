@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+#include "EncoderHandler.h"
+
+// Benchmarks e verificações executados no próprio dispositivo.
+// Cada resultado é impresso como uma linha JSON, para que possa ser
+// coletado pelo monitor serial e comparado entre versões do firmware:
+//   {"fw":"1.1.0","bench":"shortest_path","iterations":100000,"total_us":...,"ns_per_op":...,"pass":true}
+class Benchmark {
+private:
+    static void report(Print& out, const char* name, uint32_t iterations, uint32_t totalUs, bool pass);
+    static bool benchShortestPath(Print& out);
+    static bool benchPositionViews(Print& out);
+    static bool benchSpeedPlanning(Print& out);
+    static bool benchStepEncoding(Print& out);
+    static void benchCyclePhases(Print& out);
+    static void benchEncoderDecode(Print& out, EncoderHandler& encoder);
+    static void benchScreens(Print& out, DisplayManager& display);
+    static void benchFlush(Print& out, DisplayManager& display);
+    static bool benchAssets(Print& out, DisplayManager& display);
+
+public:
+    static void runAll(Print& out, DisplayManager& display, EncoderHandler& encoder);
+};
+
+#endif
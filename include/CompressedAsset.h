@@ -0,0 +1,38 @@
+#ifndef COMPRESSED_ASSET_H
+#define COMPRESSED_ASSET_H
+
+#include <Arduino.h>
+
+// Imagens e glifos gerados por tools/asset_converter.py (Assets.h). Os dados
+// já estão no formato de páginas do framebuffer (uma coluna de 8 pixels por
+// byte, bit 0 em cima), comprimidos em RLE:
+//   0x00-0x7F  literal: seguem c + 1 bytes
+//   0x80-0xFF  repetição: o byte seguinte, c - 0x80 + 3 vezes
+// Com ASSET_RLE_DELTA cada byte é o XOR com o anterior da mesma página.
+// FrameCanvas::drawPacked() decodifica direto no framebuffer.
+
+enum AssetEncoding {
+    ASSET_RLE,
+    ASSET_RLE_DELTA
+};
+
+struct CompressedBitmap {
+    uint8_t width;
+    uint8_t height;
+    uint8_t encoding;           // AssetEncoding
+    uint16_t size;              // Bytes comprimidos
+    const uint8_t* data;
+};
+
+// Fonte monoespaçada: cada glifo é um fluxo separado, com acesso direto
+struct CompressedFont {
+    uint8_t width;              // Largura de cada glifo (e avanço)
+    uint8_t height;
+    uint8_t encoding;           // AssetEncoding
+    uint8_t first;              // Código do primeiro glifo
+    uint8_t count;
+    const uint16_t* offsets;    // count + 1 posições em data
+    const uint8_t* data;
+};
+
+#endif
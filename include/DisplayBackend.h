@@ -0,0 +1,94 @@
+#ifndef DISPLAY_BACKEND_H
+#define DISPLAY_BACKEND_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "FrameCanvas.h"
+
+// Backends do display. O ativo é escolhido em tempo de compilação por
+// DISPLAY_BACKEND (config.h) e exposto como ActiveDisplayBackend, sem
+// chamadas virtuais. Todos oferecem a mesma interface:
+//   NAME, begin(), transferFrame(frame)
+// transferFrame() recebe o framebuffer no formato de páginas do FrameCanvas e
+// bloqueia até o quadro inteiro ser entregue.
+
+#define DISPLAY_BACKEND_I2C   1   // Painel por I2C (driver do ESP-IDF)
+#define DISPLAY_BACKEND_SPI   2   // Painel por SPI de hardware
+#define DISPLAY_BACKEND_HOST  3   // Quadros gravados em arquivos PBM (compilação no host)
+
+#define OLED_SSD1306  1
+#define OLED_SH1106   2           // RAM de 132 colunas, imagem deslocada de 2
+
+#if OLED_CONTROLLER == OLED_SH1106
+#define OLED_CONTROLLER_NAME "sh1106"
+#else
+#define OLED_CONTROLLER_NAME "ssd1306"
+#endif
+
+// Comandos do controlador, iguais nos dois barramentos. Os quadros são
+// enviados em endereçamento por página, que o SSD1306 e o SH1106 aceitam.
+class PanelCommands {
+public:
+    static const uint8_t* initSequence(size_t& length);
+    // Comandos que posicionam a escrita no início de 'page' (3 bytes)
+    static void pageAddress(int page, uint8_t commands[3]);
+};
+
+#if DISPLAY_BACKEND == DISPLAY_BACKEND_I2C
+
+#include <driver/i2c.h>
+
+class I2CDisplayBackend {
+private:
+    bool writeChunk(uint8_t control, const uint8_t* data, size_t length);
+
+public:
+    static const char* const NAME;
+    bool begin();
+    bool transferFrame(const uint8_t* frame);
+};
+
+typedef I2CDisplayBackend ActiveDisplayBackend;
+
+#elif DISPLAY_BACKEND == DISPLAY_BACKEND_SPI
+
+#include <SPI.h>
+
+// Escrita de 4 fios: CS, DC (0 = comando, 1 = dados), SCK e MOSI. Uma página
+// de 128 bytes a 10 MHz leva ~100 us, contra ~3 ms no I2C a 400 kHz.
+class SPIDisplayBackend {
+private:
+    SPIClass spi;
+    void write(bool data, const uint8_t* bytes, size_t length);
+
+public:
+    static const char* const NAME;
+    SPIDisplayBackend();
+    bool begin();
+    bool transferFrame(const uint8_t* frame);
+};
+
+typedef SPIDisplayBackend ActiveDisplayBackend;
+
+#elif DISPLAY_BACKEND == DISPLAY_BACKEND_HOST
+
+// Cada quadro vira um arquivo OLED_HOST_FRAME_PREFIX00001.pbm (P4, 1 bit por
+// pixel), que qualquer visualizador de imagens abre ou converte para PNG
+class HostDisplayBackend {
+private:
+    uint32_t frameNumber;
+
+public:
+    static const char* const NAME;
+    HostDisplayBackend();
+    bool begin();
+    bool transferFrame(const uint8_t* frame);
+};
+
+typedef HostDisplayBackend ActiveDisplayBackend;
+
+#else
+#error "DISPLAY_BACKEND invalido (use DISPLAY_BACKEND_I2C, DISPLAY_BACKEND_SPI ou DISPLAY_BACKEND_HOST)"
+#endif
+
+#endif
@@ -1,34 +1,109 @@
 #ifndef DISPLAY_MANAGER_H
 #define DISPLAY_MANAGER_H
 
-#include <Wire.h>
 #include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
 #include "config.h"
+#include "FrameCanvas.h"
+#include "DisplayBackend.h"
+#include "History.h"
+#include "MenuTree.h"
+
+// No host não há tarefa de flush: os quadros são gravados na hora
+#define DISPLAY_ASYNC_FLUSH (OLED_ASYNC_FLUSH && DISPLAY_BACKEND != DISPLAY_BACKEND_HOST)
+
+#define PROGRESS_BAR_WIDTH  100
+#define PROGRESS_BAR_HEIGHT 8
+
+// Telas cuja camada estática (título, ajuda, molduras) fica pré-rasterizada.
+// Cada template ocupa FRAMEBUFFER_SIZE bytes de DRAM; telas com só duas
+// linhas fixas (menu, editores, diagnóstico) as desenham direto, já que o
+// ganho é de poucos µs por quadro (render_us_per_frame no benchmark 'b').
+enum ScreenTemplate {
+    TPL_CYCLE_PROGRESS,
+    TPL_POSITIONING_SETUP,
+    TPL_JOG,
+    TPL_COUNT
+};
 
 class DisplayManager {
 private:
-    Adafruit_SSD1306 display;
+    FrameCanvas display;
+    ActiveDisplayBackend backend;
+    uint8_t templateCache[TPL_COUNT][FRAMEBUFFER_SIZE];
+    bool templateReady[TPL_COUNT];
+
+    void flush();
+    void drawStaticLayer(ScreenTemplate tpl);
+    void loadTemplate(ScreenTemplate tpl);
+
+#if DISPLAY_ASYNC_FLUSH
+    // --- Transferência assíncrona ---
+    // flush() copia o framebuffer para queuedFrame e retorna; a tarefa de
+    // flush troca os ponteiros e entrega sendingFrame ao backend.
+    // Se um novo quadro chega antes do anterior sair, vale o mais recente.
+    uint8_t frameBuffers[2][FRAMEBUFFER_SIZE];
+    uint8_t* sendingFrame;
+    uint8_t* queuedFrame;
+    volatile bool frameQueued;
+    volatile bool transferActive;
+    portMUX_TYPE frameLock;
+    TaskHandle_t flushTask;
+    bool asyncEnabled;          // false = caminho bloqueante (comparação no benchmark)
+    // Evento de entrada em vigor quando cada quadro foi desenhado
+    // (InputTrace::currentEvent) e a primeira transferência concluída ainda
+    // não repassada à InputTrace, que só é tocada pela tarefa da interface
+    uint32_t queuedEvent;
+    uint32_t sendingEvent;
+    bool flushDone;
+    uint32_t doneEvent;
+    uint32_t doneUs;
+
+    static void flushTaskEntry(void* param);
+    void flushTaskLoop();
+#endif
     
 public:
     DisplayManager();
     void begin();
     void clear();
     // void showMainMenu(int selectedIndex = 0);
-    // MODIFICADO: Assinatura da função para suportar a lista de itens e a rolagem
-    void showMainMenu(const char* items[], int totalItems, int selectedIndex, int startIndex);
-    void showCycleProgress(int currentStep, int totalSteps);
+    // Qualquer nível da árvore de menus; showBack acrescenta a linha "Voltar"
+    void showMainMenu(const MenuNode& menu, int selectedIndex, int startIndex, bool showBack);
+    void showCycleProgress(int currentStep, int totalSteps, int batchIndex, int batchTotal, int partsPerHour);
+    void showCyclePaused(int currentStep, int totalSteps, int batchIndex, int batchTotal, int selectedOption);
+    // Lote interrompido por um reinício; positionUncertain = reinício durante um movimento
+    void showResumePrompt(const char* cause, int currentStep, int totalSteps, int batchIndex, int batchTotal,
+                          bool positionUncertain, int selectedOption);
+    void showIndexSetup(int stations);   // 0 = tabela de ângulos de config.h
     void showCycleComplete();
     // void showAngleSetup(int angle);
     // void showPositioning(int targetAngle, int stepsToMove);
     void showPositioning(int targetStep, int stepsToMove);
     void showPositioningSetup(int steps); 
+    void showAbsolutePositioningSetup(int32_t revolution, int step, bool editingRevolution);
+    void showAbsolutePositioning(int32_t revolution, int step, int64_t stepsToMove);
     void showMotorDisabled();
-    void showMicrostepSetup(int selectedIndex);
-    void showRelayTimeSetup(int timeMs);
-    void showRelayOffTimeSetup(int timeMs);
+    void showEmergencyStop(const char* cause, bool inputActive);
+    void showMicrostepSetup(const char* const options[], int totalOptions, int selectedIndex);
+    void showNumberEditor(const NumberEditor& editor, int value);
+    void showSpeedSetup(const char* const modes[], const int rpm[], int totalModes,
+                        int selectedIndex, bool editing, int maxRpm);
     void showError(const char* message);
-    Adafruit_SSD1306* getDisplay();
+    void showDiagnostics();
+    void showHistoryStats(const HistoryStats& stats);
+    void showJog(int position, int stepsPerSec, const char* resolution = NULL);
+    void showBitmap(const CompressedBitmap& bitmap);   // Imagem centralizada (logo de boot)
+    // true enquanto há um quadro aguardando ou em transferência
+    bool flushPending();
+    // Repassa à InputTrace as transferências concluídas pela tarefa de flush;
+    // chamada a cada volta do loop(), na tarefa da interface
+    void reportFlushes();
+    // Liga/desliga o flush assíncrono em tempo de execução; ao desligar, espera
+    // o quadro em andamento para que só uma tarefa use o backend
+    void setAsyncFlush(bool enabled);
+    // true se flush() retorna sem esperar a transferência (nunca no host)
+    bool isAsyncFlush();
+    FrameCanvas* getDisplay();
 };
 
 #endif
\ No newline at end of file
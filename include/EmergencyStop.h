@@ -0,0 +1,72 @@
+#ifndef EMERGENCY_STOP_H
+#define EMERGENCY_STOP_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class MotionTask;
+
+// Parada de emergência / fim de curso.
+//
+// A borda de acionamento do ESTOP_PIN dispara uma ISR em IRAM que, sem
+// depender de nenhuma tarefa, leva ENABLE_PIN e RELAY_PIN ao nível seguro e
+// trava o estado. Com a trava ativa a ISR de passos e pulseStep() não emitem
+// pulsos e as escritas que energizariam o motor ou o relé são recusadas. A
+// tarefa de movimento aborta o que estava fazendo no tick seguinte; a trava só
+// é liberada por reset() com a entrada já desacionada.
+//
+// Pior caso da ENTRADA até o ENABLE cortado (núcleo 1, onde a ISR é instalada):
+//   latência de entrada de interrupção nível 1 (~2 us a 240 MHz)
+//   + maior seção crítica do núcleo 1 com interrupções mascaradas
+//     (cópia do quadro do display, 1 KiB sob frameLock: poucos us)
+//   + ISR de passos em andamento no mesmo nível (pulso de STEP_PULSE_US)
+//   + a própria ISR (duas escritas de GPIO: < 1 us, ver estop_handler_ns)
+// Operações de flash (gravações e apagamentos do histórico, que podem cair
+// no meio de um lote) desligam o cache e adiam as ISRs comuns. Por isso a ISR
+// é registrada pelo serviço de ISR do GPIO com ESP_INTR_FLAG_IRAM e corta as
+// saídas direto nos registradores do GPIO (digitalWrite() e micros() ficam na
+// flash): o limite acima vale também durante essas operações. O comando
+// serial 'e' mede o valor real com ESTOP_TEST_PIN.
+
+enum EmergencyStopCause {
+    ESTOP_NONE,
+    ESTOP_INPUT,        // Contato de emergência/fim de curso aberto
+    ESTOP_WATCHDOG,     // Reinício pelo watchdog da tarefa de movimento
+    ESTOP_BROWNOUT      // Queda de tensão (o chip reinicia em seguida)
+};
+
+class EmergencyStop {
+private:
+    static volatile bool tripped;
+    static volatile uint8_t cause;
+    static volatile uint32_t handlerCycles;    // Duração da última ISR (ciclos de CPU)
+    static volatile uint32_t cutCycles;        // Contador de ciclos com as saídas cortadas
+    static portMUX_TYPE outputLock;            // Trava x escritas que energizam saídas
+
+    static void IRAM_ATTR onInterrupt(void* arg);
+
+public:
+    // Chamar antes de qualquer saída ser energizada
+    static void begin();
+
+    static inline bool isTripped() { return tripped; }
+    static uint8_t getCause() { return cause; }
+    static const char* causeName(uint8_t reason);
+    static bool inputActive();
+
+    // Corta ENABLE e relé e trava. Chamado pela ISR; também pela verificação
+    // periódica da tarefa de movimento (borda perdida, p.ex. em light sleep).
+    static void IRAM_ATTR trip(uint8_t reason);
+    // Libera a trava; false se a entrada continua acionada
+    static bool reset();
+    // Escreve 'level' em 'pin' somente sem a trava ativa (atômico em relação à ISR)
+    static bool guardedWrite(uint8_t pin, uint8_t level);
+
+    static uint32_t lastHandlerNs();
+    // Mede a latência pino -> saídas cortadas com ESTOP_TEST_PIN (uma linha
+    // JSON). Entre os acionamentos rearma pela fila da tarefa de movimento,
+    // como o operador, depois que ela tratou a parada.
+    static void runLatencyTest(Print& out, MotionTask& motion);
+};
+
+#endif
@@ -13,6 +13,9 @@ private:
     unsigned long lastDebounceTime;
     static const unsigned long debounceDelay = 50;
     int pulseCounter;
+    unsigned long lastActivityTime;
+
+    void updateFromReplay();
     
 public:
     EncoderHandler();
@@ -21,6 +24,7 @@ public:
     int getDirection();
     bool isPressed();
     void resetDirection();
+    unsigned long getLastActivityTime();
 };
 
 #endif
\ No newline at end of file
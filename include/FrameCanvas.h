@@ -0,0 +1,39 @@
+#ifndef FRAME_CANVAS_H
+#define FRAME_CANVAS_H
+
+#include <Adafruit_GFX.h>
+#include "config.h"
+#include "CompressedAsset.h"
+
+#define FRAMEBUFFER_SIZE    (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+
+#define PIXEL_OFF   0
+#define PIXEL_ON    1
+
+// Superfície de desenho da Adafruit GFX sobre um framebuffer fixo no formato
+// de páginas do SSD1306/SH1106: cada byte é uma coluna de 8 pixels de uma
+// página (bit 0 em cima). As telas desenham aqui sem saber qual painel (ou
+// arquivo, no host) vai receber o quadro.
+class FrameCanvas : public Adafruit_GFX {
+private:
+    uint8_t buffer[FRAMEBUFFER_SIZE];
+
+    void writeColumn(int16_t x, int16_t page, uint8_t shift, uint8_t bits, uint8_t mask);
+    void drawPacked(int16_t x, int16_t y, uint8_t width, uint8_t height, uint8_t encoding,
+                    const uint8_t* data);
+
+public:
+    FrameCanvas();
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void clearDisplay() { fillScreen(PIXEL_OFF); }
+    // Imagens e glifos de Assets.h, opacos: a área inteira é sobrescrita
+    void drawCompressedBitmap(int16_t x, int16_t y, const CompressedBitmap& bitmap);
+    int16_t drawGlyph(int16_t x, int16_t y, const CompressedFont& font, char c);  // Devolve o avanço
+    void drawCompressedText(int16_t x, int16_t y, const CompressedFont& font, const char* text);
+    uint8_t* getBuffer() { return buffer; }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+
+// Histórico de produção: um registro binário de 16 bytes por ciclo, gravado
+// na partição HISTORY_PARTITION_LABEL (partitions.csv).
+//
+// A partição é um buffer circular de setores de 4 KiB. Cada setor tem um
+// cabeçalho com número de sequência e 255 registros; os registros só são
+// acrescentados (a flash não é reescrita) e o acréscimo é uma única escrita
+// na posição guardada em RAM, O(1). Cada setor é apagado uma vez por volta
+// completa do buffer, então o desgaste se distribui por toda a partição.
+//
+// Apagar um setor leva dezenas de ms e trava o cache das duas CPUs; por isso
+// maintain() mantém HISTORY_SPARE_SECTORS setores apagados à frente e só é
+// chamada com a tarefa de movimento parada há HISTORY_MAINTAIN_IDLE_MS, no
+// máximo um apagamento por HISTORY_MAINTAIN_INTERVAL_MS. append() nunca
+// apaga: sem setor pronto o registro é descartado e contado em dropped.
+//
+// Sem relógio de tempo real, o instante do registro é o número do boot mais
+// os segundos desde o boot.
+//
+// Formato do registro (little-endian):
+//   0  uint32  início do ciclo, segundos desde o boot
+//   4  uint32  duração em ms (sem as pausas)
+//   8  uint16  número do boot
+//   10 uint16  estações (indexador) ou passos por ciclo
+//   12 uint8   bits 0-1: HistoryMode, bits 2-3: HistoryOutcome
+//   13 uint8   maior atraso da fase do relé no ciclo, ms (satura em 255)
+//   14 uint8   maior atraso da estabilização no ciclo, ms (satura em 255)
+//   15 uint8   CRC-8 dos bytes 0-14
+
+enum HistoryMode {
+    HIST_MODE_CYCLE,        // Ciclo completo (um passo por acionamento)
+    HIST_MODE_INDEXER
+};
+
+enum HistoryOutcome {
+    HIST_COMPLETED,
+    HIST_CANCELLED,         // Cancelado pelo operador
+    HIST_EMERGENCY          // Interrompido pela parada de emergência
+};
+
+struct HistoryRecord {
+    uint32_t startS;
+    uint32_t durationMs;
+    uint16_t boot;
+    uint16_t length;
+    uint8_t flags;
+    uint8_t relayOverrunMs;
+    uint8_t settleOverrunMs;
+    uint8_t crc;
+};
+
+// Resumo dos registros presentes no log (mantido em RAM a cada acréscimo)
+struct HistoryStats {
+    uint32_t records;
+    uint32_t capacity;
+    uint32_t outcomes[3];           // Por HistoryOutcome
+    uint64_t completedDurationMs;   // Soma das durações dos ciclos concluídos
+    uint32_t relayOverrunMs;        // Soma dos maiores atrasos por ciclo
+    uint32_t settleOverrunMs;
+    uint32_t dropped;               // Registros descartados desde o boot
+    uint16_t boot;
+    bool available;                 // Partição encontrada
+};
+
+#define HISTORY_SECTOR_SIZE         4096
+#define HISTORY_RECORD_SIZE         16
+#define HISTORY_RECORDS_PER_SECTOR  ((HISTORY_SECTOR_SIZE - HISTORY_RECORD_SIZE) / HISTORY_RECORD_SIZE)
+
+class History {
+private:
+    static const esp_partition_t* partition;
+    static uint32_t sectorCount;
+    static uint32_t headSector;         // Setor em gravação
+    static uint32_t headSlot;           // Próximo registro livre no setor
+    static uint32_t headSequence;
+    static uint32_t sparesReady;        // Setores apagados depois do cabeçalho
+    static volatile bool exporting;     // Exportação em andamento: não apaga setores
+    static HistoryStats stats;
+    static portMUX_TYPE statsLock;      // Tarefa de movimento x interface
+
+    static uint32_t nextSector(uint32_t sector) { return (sector + 1) % sectorCount; }
+    static size_t slotOffset(uint32_t sector, uint32_t slot);
+    static bool readHeader(uint32_t sector, uint32_t& sequence);
+    static bool writeHeader(uint32_t sector, uint32_t sequence);
+    static bool sectorBlank(uint32_t sector);
+    static bool readChunk(uint32_t sector, uint32_t firstSlot, HistoryRecord* records, uint32_t count);
+    static int classify(const HistoryRecord& record);
+    static void accumulate(const HistoryRecord& record, int sign);
+    static void countDropped();
+    static uint16_t scanSector(uint32_t sector, int sign);
+
+public:
+    static uint8_t crc8(const uint8_t* data, size_t length);
+    static HistoryRecord makeRecord(uint32_t startS, uint32_t durationMs, uint16_t length,
+                                    HistoryMode mode, HistoryOutcome outcome,
+                                    uint32_t relayOverrunMs, uint32_t settleOverrunMs);
+    static uint8_t modeOf(const HistoryRecord& record) { return record.flags & 0x03; }
+    static uint8_t outcomeOf(const HistoryRecord& record) { return (record.flags >> 2) & 0x03; }
+
+    // Localiza o início do log e reconstrói o resumo. Chamar no setup(), parado.
+    static bool begin();
+    // Acrescenta um registro sem apagar setores (tarefa de movimento, motor parado)
+    static bool append(const HistoryRecord& record);
+    // Apaga no máximo um setor à frente, se faltar algum. Só com o motor
+    // parado. Retorna true se apagou (ou reaproveitou) um setor.
+    static bool maintain();
+
+    static uint16_t currentBoot() { return stats.boot; }
+    static HistoryStats getStats();
+    // Todos os registros, do mais antigo ao mais recente, em hexadecimal
+    static void exportDump(Print& out);
+};
+
+#endif
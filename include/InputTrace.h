@@ -0,0 +1,91 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Gravação e reprodução determinística dos eventos do encoder.
+//
+// Formato binário: cada evento ocupa 2 bytes (little-endian)
+//   bits 15-14: tipo (0 = horário, 1 = anti-horário, 2 = clique, 3 = extensão de tempo)
+//   bits 13-0 : intervalo em ms desde o evento anterior (0-16383)
+// Intervalos maiores são precedidos por palavras de extensão (tipo 3), cada uma
+// somando o seu valor ao intervalo do próximo evento.
+//
+// Durante a reprodução, cada evento entregue mede a latência até o próximo
+// flush do display e até o início de um movimento do motor. Tudo roda na
+// tarefa da interface: o início do movimento é visto no snapshot publicado
+// pela tarefa de movimento (observeMotion), e o fim de uma transferência da
+// tarefa de flush é repassado pelo DisplayManager (reportFlushes), com o
+// evento em vigor quando o quadro foi desenhado.
+//
+// exportHex() e importHex() usam o mesmo texto, de modo que uma gravação
+// exportada pode ser carregada de volta (em outra placa ou no host):
+//   === TRACE <n> bytes ===
+//   <n bytes em hexadecimal, 32 por linha>
+//   === END ===
+
+enum InputEventType {
+    INPUT_CW = 0,
+    INPUT_CCW = 1,
+    INPUT_PRESS = 2
+};
+
+class InputTrace {
+private:
+    static uint8_t buffer[INPUT_TRACE_CAPACITY];
+    static size_t length;
+    static size_t readIndex;
+    static bool recording;
+    static bool replaying;
+    static uint32_t lastEventUs;        // Gravação: instante do último evento
+    static uint32_t nextDueUs;          // Reprodução: instante do próximo evento
+    static int nextType;                // Reprodução: tipo do próximo evento (-1 = fim)
+    static unsigned long (*clock)();
+
+    // Latência do último evento reproduzido
+    static int eventIndex;
+    static int eventType;
+    static uint32_t eventUs;
+    static int32_t flushLatencyUs;
+    static int32_t motionLatencyUs;
+    static uint32_t eventSerial;        // Eventos entregues desde a partida (não volta a 0)
+    static bool motionActive;           // Último snapshot visto fora de PHASE_IDLE
+
+    static bool appendWord(uint16_t word);
+    static void loadNextEvent();
+    static void reportEvent();
+
+public:
+    // Relógio em microssegundos (micros() por padrão; um relógio virtual no host)
+    static void setClock(unsigned long (*clockUs)());
+
+    static void startRecording();
+    static void stopRecording();
+    static bool isRecording() { return recording; }
+    static void record(InputEventType type);
+
+    static void startReplay();
+    static void stopReplay();
+    static bool isReplaying() { return replaying; }
+    // Retorna o próximo evento cujo instante já chegou, ou -1
+    static int nextDueEvent();
+
+    // Pontos de medição de latência. Cada quadro leva o currentEvent() do
+    // momento em que foi desenhado; markFlush() só conta quadros desenhados
+    // depois do evento em medição, com o instante (now()) em que chegaram ao painel.
+    static uint32_t currentEvent() { return eventSerial; }
+    static uint32_t now() { return clock(); }
+    static void markFlush(uint32_t frameEvent, uint32_t flushedUs);
+    // Chamada a cada snapshot da tarefa de movimento: a passagem para uma
+    // fase diferente de PHASE_IDLE marca o início do movimento
+    static void observeMotion(bool moving);
+
+    static size_t size() { return length; }
+    static void exportHex(Print& out);
+    // Lê uma gravação no formato de exportHex() até a linha END. Com texto
+    // inválido ou sem dado por INPUT_TRACE_IMPORT_TIMEOUT_MS, fica vazia
+    static bool importHex(Stream& in);
+};
+
+#endif
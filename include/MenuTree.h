@@ -0,0 +1,108 @@
+#ifndef MENU_TREE_H
+#define MENU_TREE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Menu hierárquico descrito em tempo de compilação. Os nós são constexpr:
+// ficam na flash (.rodata), sem heap, e a RAM usada pelo menu é só a pilha
+// de MENU_MAX_DEPTH níveis do MenuNavigator, qualquer que seja o tamanho da
+// árvore. Cada item leva o próprio tratador, então selecionar é chamar um
+// ponteiro de função, sem switch por índice.
+//
+//   constexpr MenuNode settings[] = {
+//       menuNumber("Tempo do Rele", relayOnEditor),
+//       menuAction("Velocidades", openSpeedSetup),
+//   };
+//   constexpr MenuNode rootItems[] = {
+//       menuAction("Ciclo Completo", startSingleCycle),
+//       menuSubmenu("Configuracoes", settings),
+//   };
+//   constexpr MenuNode mainMenu = menuSubmenu("Menu Principal", rootItems);
+
+enum MenuNodeType : uint8_t {
+    MENU_SUBMENU,   // Abre outro nível
+    MENU_ACTION,    // Chama action()
+    MENU_NUMBER     // Abre o editor numérico genérico
+};
+
+// Editor numérico: ajusta uma cópia de *value entre min e max em passos de
+// step; ao confirmar grava em *value e chama apply(). Com divisor > 1 o valor
+// é mostrado dividido, com duas casas (ms mostrados em segundos).
+struct NumberEditor {
+    const char* title;      // Título da tela, em maiúsculas
+    const char* unit;
+    int* value;
+    int min;
+    int max;
+    int step;
+    int divisor;
+    void (*apply)();
+};
+
+struct MenuNode {
+    const char* label;
+    MenuNodeType type;
+    uint8_t childCount;
+    const MenuNode* children;
+    void (*action)();
+    const NumberEditor* editor;
+};
+
+constexpr MenuNode menuAction(const char* label, void (*action)()) {
+    return MenuNode{label, MENU_ACTION, 0, nullptr, action, nullptr};
+}
+
+constexpr MenuNode menuNumber(const char* label, const NumberEditor& editor) {
+    return MenuNode{label, MENU_NUMBER, 0, nullptr, nullptr, &editor};
+}
+
+template <size_t N>
+constexpr MenuNode menuSubmenu(const char* label, const MenuNode (&children)[N]) {
+    static_assert(N < 255, "Submenu com itens demais");
+    return MenuNode{label, MENU_SUBMENU, (uint8_t)N, children, nullptr, nullptr};
+}
+
+// Profundidade da árvore (a raiz conta 1), para conferir MENU_MAX_DEPTH com static_assert
+constexpr int menuDepth(const MenuNode& node);
+
+constexpr int menuChildrenDepth(const MenuNode* children, int count) {
+    return count == 0 ? 0
+         : menuDepth(children[0]) > menuChildrenDepth(children + 1, count - 1)
+             ? menuDepth(children[0]) : menuChildrenDepth(children + 1, count - 1);
+}
+
+constexpr int menuDepth(const MenuNode& node) {
+    return node.type == MENU_SUBMENU ? 1 + menuChildrenDepth(node.children, node.childCount) : 0;
+}
+
+// Caminho da raiz até o nível mostrado. Fora da raiz, a última linha de cada
+// nível é "Voltar", que não existe na árvore.
+class MenuNavigator {
+private:
+    struct Level {
+        const MenuNode* menu;
+        uint8_t selected;       // Item com o cursor
+        uint8_t top;            // Item no topo da janela visível
+    };
+    Level levels[MENU_MAX_DEPTH];
+    uint8_t depth;              // Índice do nível mostrado
+
+public:
+    explicit MenuNavigator(const MenuNode& root);
+
+    // Volta à raiz, com o cursor no primeiro item
+    void reset();
+    void move(int direction);
+    // Entra no submenu ou volta um nível e retorna NULL; para ações e
+    // editores retorna o item, que o chamador executa
+    const MenuNode* select();
+
+    const MenuNode& current() const { return *levels[depth].menu; }
+    int selected() const { return levels[depth].selected; }
+    int top() const { return levels[depth].top; }
+    bool atRoot() const { return depth == 0; }
+    int itemCount() const { return current().childCount + (depth > 0 ? 1 : 0); }
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// Registro de métricas de execução: contadores, medidores (gauges) e
+// temporizadores com mínimo/máximo/média. Todas as entradas são fixas
+// (sem alocação dinâmica) e o registro de uma amostra custa poucas instruções.
+//
+// As amostras chegam da ISR de passos, da tarefa de movimento (núcleo 0) e do
+// loop() (núcleo 1). Contadores e medidores são palavras de 32 bits
+// atualizadas atomicamente. Um temporizador tem vários campos e é atualizado
+// sob um spinlock, que também serve dentro de ISR.
+
+enum CounterId {
+    CNT_LOOP_ITERATIONS,    // Iterações do loop() principal
+    CNT_STEPS_EMITTED,      // Pulsos de STEP gerados
+    CNT_DIRECTION_REVERSALS, // Inversões de sentido (cada uma paga o setup do DIR e a folga)
+    CNT_ENCODER_DETENTS,    // Passos do encoder consumidos pela interface
+    CNT_ENCODER_DROPPED,    // Passos do encoder sobrescritos antes de serem lidos
+    CNT_BUTTON_PRESSES,     // Cliques do botão do encoder
+    CNT_DISPLAY_FLUSHES,    // Transferências do framebuffer para o display
+    CNT_DISPLAY_FRAMES_SKIPPED, // Quadros substituídos por um mais novo antes de serem enviados
+    CNT_CYCLES_COMPLETED,   // Ciclos completos finalizados
+    CNT_CYCLES_CANCELLED,   // Ciclos cancelados pelo operador
+    CNT_HOLD_RELEASES,      // Vezes em que o torque de retenção foi liberado por inatividade
+    CNT_SLEEP_ENTRIES,      // Entradas em light sleep
+    CNT_COMMANDS_DROPPED,   // Comandos descartados com a fila da tarefa de movimento cheia
+    CNT_EMERGENCY_STOPS,    // Acionamentos da parada de emergência (entrada ou watchdog)
+    CNT_WATCHDOG_ERRORS,    // Falhas ao configurar o watchdog da tarefa de movimento
+    COUNTER_COUNT
+};
+
+enum GaugeId {
+    GAUGE_STEP_RATE,        // Passos/s alcançados no último movimento
+    GAUGE_CYCLE_RATE,       // Passos/min alcançados no último ciclo
+    GAUGE_COUNT
+};
+
+enum TimerId {
+    TMR_LOOP,               // Tempo de processamento de uma iteração do loop (us)
+    TMR_DISPLAY_FLUSH,      // Tempo em que flush() bloqueia quem desenha (us)
+    TMR_DISPLAY_TRANSFER,   // Transferência de um quadro pelo backend do display (us)
+    TMR_MOVE,               // Duração de um posicionamento (us)
+    TMR_CYCLE,              // Duração de um ciclo completo (ms)
+    TMR_RELAY_OVERRUN,      // Atraso da fase "relé ligado" além de RELAY_ON_TIME (ms)
+    TMR_SETTLE_OVERRUN,     // Atraso da fase de estabilização além de STEP_SETTLE_TIME (ms)
+    TMR_INPUT_TO_FLUSH,     // Evento reproduzido -> flush do display (us)
+    TMR_INPUT_TO_MOTION,    // Evento reproduzido -> início de movimento (us)
+    TMR_MOTION_TICK,        // Processamento de uma iteração da tarefa de movimento (us)
+    TMR_ESTOP_HANDLER,      // Entrada da ISR de emergência -> saídas cortadas (ns)
+    TMR_RESUME_SAVE,        // Gravação do ponto de retomada na memória RTC (ns)
+    TIMER_COUNT
+};
+
+struct TimerStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+};
+
+class Metrics {
+private:
+    static uint32_t counters[COUNTER_COUNT];
+    static int32_t gauges[GAUGE_COUNT];
+    static TimerStats timers[TIMER_COUNT];
+    static portMUX_TYPE timerLock;
+
+public:
+    static inline void count(CounterId id, uint32_t amount = 1) {
+        __atomic_fetch_add(&counters[id], amount, __ATOMIC_RELAXED);
+    }
+
+    static inline void setGauge(GaugeId id, int32_t value) {
+        __atomic_store_n(&gauges[id], value, __ATOMIC_RELAXED);
+    }
+
+    static inline void recordTime(TimerId id, uint32_t value) {
+        portENTER_CRITICAL_SAFE(&timerLock);
+        TimerStats& t = timers[id];
+        t.count++;
+        t.total += value;
+        if (value < t.min) t.min = value;
+        if (value > t.max) t.max = value;
+        portEXIT_CRITICAL_SAFE(&timerLock);
+    }
+
+    static uint32_t getCounter(CounterId id) { return __atomic_load_n(&counters[id], __ATOMIC_RELAXED); }
+    static int32_t getGauge(GaugeId id) { return __atomic_load_n(&gauges[id], __ATOMIC_RELAXED); }
+    // Cópia consistente (os campos mudam juntos sob o spinlock)
+    static TimerStats getTimer(TimerId id);
+    static uint32_t getTimerAverage(TimerId id);
+
+    static void reset();
+    static void dump(Print& out);
+};
+
+// Mede o tempo (em microssegundos) de um bloco de código até o fim do escopo
+class ScopedTimer {
+private:
+    TimerId id;
+    uint32_t start;
+
+public:
+    explicit ScopedTimer(TimerId timerId) : id(timerId), start(micros()) {}
+    ~ScopedTimer() { Metrics::recordTime(id, micros() - start); }
+};
+
+#endif
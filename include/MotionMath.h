@@ -0,0 +1,109 @@
+#ifndef MOTION_MATH_H
+#define MOTION_MATH_H
+
+#include <stdint.h>
+
+// Funções puras de cálculo de movimento (sem acesso a hardware), usadas pela
+// máquina de estados e pelos benchmarks.
+
+// Calcula o menor caminho (em steps, com sinal) entre duas posições de uma volta.
+// Positivo = horário, negativo = anti-horário.
+inline int shortestPathSteps(int currentStep, int targetStep, int stepsPerRev) {
+    int stepsToMove = targetStep - currentStep;
+    int halfWay = stepsPerRev / 2;
+
+    if (stepsToMove > halfWay) {
+        stepsToMove -= stepsPerRev;
+    } else if (stepsToMove < -halfWay) {
+        stepsToMove += stepsPerRev;
+    }
+    return stepsToMove;
+}
+
+// Mantém uma posição dentro do intervalo 0..stepsPerRev-1
+inline int wrapPosition(int position, int stepsPerRev) {
+    position %= stepsPerRev;
+    if (position < 0) position += stepsPerRev;
+    return position;
+}
+
+// Visões de uma posição absoluta multivoltas. A divisão é arredondada para
+// baixo: -1 fica na volta -1, passo stepsPerRev-1.
+inline int32_t revolutionOf(int64_t position, int32_t stepsPerRev) {
+    int64_t revolution = position / stepsPerRev;
+    if (position % stepsPerRev < 0) revolution--;
+    return (int32_t)revolution;
+}
+
+inline int stepInRevolution(int64_t position, int32_t stepsPerRev) {
+    int64_t step = position % stepsPerRev;
+    if (step < 0) step += stepsPerRev;
+    return (int)step;
+}
+
+// Deslocamento (em passos, a partir da origem do ciclo) da estação 'index' de
+// 'stations' estações igualmente espaçadas, arredondado ao passo mais próximo.
+// index == stations retorna uma volta completa.
+inline int32_t equalStationOffset(int index, int stations, int32_t stepsPerRev) {
+    return (int32_t)(((int64_t)index * stepsPerRev * 2 + stations) / (2 * stations));
+}
+
+// Ângulo em décimos de grau (0-3600) para passos, arredondado
+inline int32_t angleToSteps(int32_t tenthsOfDegree, int32_t stepsPerRev) {
+    return (int32_t)(((int64_t)tenthsOfDegree * stepsPerRev * 2 + 3600) / 7200);
+}
+
+// Posição absoluta a partir de volta e passo dentro da volta
+inline int64_t absoluteFrom(int32_t revolution, int step, int32_t stepsPerRev) {
+    return (int64_t)revolution * stepsPerRev + step;
+}
+
+// Velocidade do eixo em RPM para passos/s numa resolução de stepsPerRev
+inline float rpmToStepsPerSec(int32_t rpm, int32_t stepsPerRev) {
+    return rpm * (float)stepsPerRev / 60;
+}
+
+// Maior velocidade (RPM) cuja taxa de pulsos cabe em maxPulseRate, com os
+// passos emitidos numa resolução de pulseStepsPerRev, sem passar de limitRpm
+inline int32_t maxSpeedRpm(int32_t pulseStepsPerRev, int32_t maxPulseRate, int32_t limitRpm) {
+    int32_t rpm = (int32_t)((int64_t)maxPulseRate * 60 / pulseStepsPerRev);
+    return rpm < limitRpm ? rpm : limitRpm;
+}
+
+// Troca automática de micro-passo: quantas vezes a resolução fina deve ser
+// dividida por 2 para que 'speed' (passos finos/s) caiba em maxPulseRate.
+// Só refina de novo quando a taxa na resolução mais fina fica abaixo de
+// maxPulseRate * hysteresis, evitando alternar na fronteira.
+inline int autoMicrostepShift(float speed, int currentShift, int maxShift,
+                              float maxPulseRate, float hysteresis) {
+    if (speed < 0) speed = -speed;
+    int shift = 0;
+    while (shift < maxShift && speed / (1 << shift) > maxPulseRate) {
+        shift++;
+    }
+    while (shift < currentShift && speed / (1 << shift) > maxPulseRate * hysteresis) {
+        shift++;
+    }
+    return shift;
+}
+
+// Faixas de ressonância: uma velocidade (em módulo) dentro de [início, fim] é
+// levada à borda que a rampa atravessa. Acelerando salta para o fim, freando
+// para o início; com o objetivo dentro da faixa para na borda mais próxima dele.
+// Faixas com início >= fim são ignoradas.
+inline float skipResonanceBands(float speed, float goal, const uint16_t (*bands)[2], int count) {
+    for (int i = 0; i < count; i++) {
+        float low = bands[i][0];
+        float high = bands[i][1];
+        if (low >= high || speed <= low || speed >= high) continue;
+
+        if (goal > low && goal < high) {
+            speed = (goal - low < high - goal) ? low : high;
+        } else {
+            speed = goal >= high ? high : low;
+        }
+    }
+    return speed;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef MOTION_TASK_H
+#define MOTION_TASK_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "StepperController.h"
+#include "SpscQueue.h"
+#include "SeqLock.h"
+#include "History.h"
+#include "ResumeState.h"
+
+// Tarefa de movimento/E-S. É a única que acessa o StepperController e o relé
+// depois do setup(); roda em prioridade alta no núcleo MOTION_TASK_CORE, de
+// modo que o tempo dos ciclos não depende do desenho do display nem do encoder.
+//
+// A interface (loop()) envia comandos por uma fila SPSC sem bloqueio e lê o
+// estado por um instantâneo protegido por seqlock.
+//
+// A tarefa é vigiada pelo watchdog de tarefas (MOTION_WATCHDOG_TIMEOUT_S) e,
+// depois de uma parada de emergência, aborta tudo e recusa movimentos até o
+// rearme.
+
+enum MotionCommandType {
+    CMD_MOVE,               // value = passos relativos (com sinal)
+    CMD_MOVE_TO,            // value = posição absoluta multivoltas
+    CMD_SET_SPEED,          // value = passos/s com sinal (modo jog)
+    CMD_SET_RELAY_TIMING,   // value = relé ligado (ms), value2 = estabilização (ms)
+    CMD_CANCEL,             // Interrompe movimento, ciclo ou jog (jog desacelera)
+    CMD_START_CYCLE,        // value = ciclos no lote
+    CMD_START_INDEXING,     // value = ciclos no lote, value2 = estações (0 = INDEX_STATION_TABLE)
+    CMD_PAUSE,
+    CMD_RESUME,
+    CMD_START_JOG,          // value = aceleração (passos/s²)
+    CMD_SET_ENABLED,        // value = 0/1
+    CMD_SET_MICROSTEP,      // value = índice do micro-passo (zera a posição), value2 = automático
+    CMD_RESET_EMERGENCY,    // Rearma a parada de emergência (o motor continua desabilitado)
+    CMD_SET_SPEED_PROFILE,  // value = SpeedMode, value2 = RPM (vale a partir do próximo movimento)
+    CMD_RESTORE             // Ponto de retomada: value = 1 retoma o ciclo, 0 só restaura a posição
+};
+
+// Modos com velocidade própria, configurada em RPM durante a execução
+enum SpeedMode {
+    SPEED_POSITIONING,      // Posicionamento relativo e absoluto
+    SPEED_CYCLE,            // Movimentos do indexador e compensação de folga no ciclo
+    SPEED_JOG,              // Velocidade máxima do jog
+    SPEED_MODE_COUNT
+};
+
+struct MotionCommand {
+    uint8_t type;
+    int64_t value;          // 64 bits para alvos multivoltas
+    int32_t value2;
+};
+
+enum MotionPhase {
+    PHASE_IDLE,
+    PHASE_MOVING,           // Posicionamento em andamento
+    PHASE_RELAY_ON,         // Ciclo: relé ligado
+    PHASE_SETTLE,           // Ciclo: estabilização após o passo
+    PHASE_INDEX_MOVE,       // Indexador: movimento acelerado até a próxima estação
+    PHASE_PAUSED,           // Ciclo pausado
+    PHASE_JOG
+};
+
+struct MotionStatus {
+    int64_t absolutePosition;   // Passos desde a referência, multivoltas
+    int32_t revolution;         // Volta atual (pode ser negativa)
+    int32_t position;           // Passo atual dentro da volta
+    int32_t stepsPerRev;
+    uint8_t phase;              // MotionPhase
+    bool enabled;
+    int32_t cyclePosition;      // Passos (ou estações) concluídos no ciclo atual
+    int32_t cycleLength;        // Passos (ou estações) por ciclo
+    int32_t cyclesCompleted;    // Ciclos concluídos no lote
+    int32_t batchTotal;
+    int32_t speed;              // Passos/s no modo jog
+    bool autoMicrostep;
+    uint8_t microstepShift;     // Resolução atual = escolhida / 2^n (automático)
+    bool emergencyStop;         // Parada de emergência tratada e ainda não rearmada
+    uint8_t emergencyCause;     // EmergencyStopCause
+    uint32_t commandsProcessed;
+};
+
+class MotionTask {
+private:
+    StepperController& stepper;
+    SpscQueue<MotionCommand, MOTION_QUEUE_CAPACITY> commands;
+    SeqLock<MotionStatus> snapshot;
+    uint32_t commandsSent;          // Lado da interface
+
+    // --- Estado da tarefa de movimento (acessado só por ela) ---
+    MotionStatus status;
+    unsigned long relayOnTime;
+    unsigned long settleTime;
+    unsigned long phaseStartTime;
+    unsigned long cycleStartTime;       // Deslocado pelas pausas (tempo de ciclo ativo)
+    unsigned long cycleLogStartTime;    // Início real do ciclo, para o histórico
+    unsigned long pauseStartTime;
+    unsigned long cycleRelayOverrunMs;  // Maiores atrasos do ciclo atual (histórico)
+    unsigned long cycleSettleOverrunMs;
+    uint8_t pausedPhase;
+    int64_t moveTotal;
+    uint32_t moveStartUs;
+    int32_t speedRpm[SPEED_MODE_COUNT];
+    bool jogStopping;
+
+    // Modo indexador
+    bool indexing;
+    int stationCount;
+    int32_t stationOffsets[INDEX_MAX_STATIONS + 1];  // Passos desde a origem do ciclo
+    int64_t cycleOrigin;
+    uint32_t indexMoveStartUs;
+    bool pauseRequested;        // Pausa/cancelamento pedidos durante um movimento
+    bool cancelRequested;       // entre estações: aplicados na chegada
+    int stationSetting;         // Estações pedidas (0 = INDEX_STATION_TABLE)
+    uint8_t microstepIndex;
+
+    // Ponto de retomada na memória RTC (ResumeState)
+    ResumeSnapshot resumePoint; // Restaurado na partida, até o operador decidir
+    bool resumePending;         // Sem decisão ainda: nada é gravado por cima dele
+    bool resumeDirty;           // Configuração mudou desde a última gravação
+    uint8_t savedPhase;
+    int32_t savedCyclePosition;
+    int32_t savedCyclesCompleted;
+
+    // Manutenção do histórico (HISTORY_MAINTAIN_IDLE_MS / _INTERVAL_MS)
+    unsigned long idleSinceMs;          // Último tick fora de PHASE_IDLE
+    unsigned long lastEraseMs;
+
+    static void taskEntry(void* param);
+    void run();
+    void processCommand(const MotionCommand& command);
+    void startMove(int64_t steps);
+    float modeSpeed(int mode);
+    void refreshPosition();
+    void beginCycle(unsigned long now);
+    void completeCycle(unsigned long now);
+    void logCycle(HistoryOutcome outcome, unsigned long now);
+    void updateCycle(unsigned long now);
+    void buildStationTable(int stations);
+    void startIndexMove();
+    void updateIndexMove(unsigned long now);
+    void saveResumePoint();
+    void resumeCycle(unsigned long now);
+    void updateMove();
+    void updateJog();
+    void setRelay(bool on);
+    void abortForEmergency();
+    bool send(MotionCommandType type, int64_t value = 0, int32_t value2 = 0);
+
+public:
+    MotionTask(StepperController& stepperController);
+    // Ponto de retomada de antes do reinício; chamar antes de begin(). Fica
+    // pendente até restoreResumePoint().
+    void restore(const ResumeSnapshot& point);
+    void begin();
+
+    // Comandos (somente a partir da interface). Retornam false se a fila está cheia.
+    bool move(int64_t steps);
+    bool moveTo(int64_t absolutePosition);
+    bool setSpeed(int32_t stepsPerSec);
+    bool setRelayTiming(unsigned long onMs, unsigned long settleMs);
+    bool cancel();
+    bool startCycle(int32_t cycles);
+    bool startIndexing(int32_t cycles, int stations);
+    bool pause();
+    bool resume();
+    bool startJog(int32_t acceleration);
+    bool setEnabled(bool enable);
+    bool setMicrostep(int index, bool automatic = false);
+    bool resetEmergencyStop();
+    bool setSpeedProfile(SpeedMode mode, int32_t rpm);
+    // Depois do micro-passo: restaura a posição e, com continueCycle, retoma o ciclo
+    bool restoreResumePoint(bool continueCycle);
+
+    // Uma iteração da tarefa (comandos, fases, instantâneo). run() chama a
+    // cada MOTION_TASK_PERIOD_MS; os testes no host chamam direto, num relógio virtual.
+    void tick();
+
+    MotionStatus getStatus() const;
+    // true quando todos os comandos enviados já estão refletidos no instantâneo
+    bool isCaughtUp(const MotionStatus& s) const;
+};
+
+#endif
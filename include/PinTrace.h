@@ -0,0 +1,89 @@
+#ifndef PIN_TRACE_H
+#define PIN_TRACE_H
+
+#include <Arduino.h>
+#include <hal/gpio_ll.h>
+#include "config.h"
+
+// Registro das transições dos pinos de saída (STEP, DIR, ENABLE, relé e
+// MS1-MS3) com carimbo de tempo, exportado como VCD para abrir no GTKWave e
+// comparar formas de onda entre versões do firmware.
+//
+// As transições ficam num buffer circular de PIN_TRACE_CAPACITY eventos
+// (5 bytes cada): traços com milhões de bordas guardam as mais recentes, e o
+// nível de cada sinal no início da janela é mantido à parte para que o VCD
+// comece no estado correto. No dispositivo o relógio é esp_timer_get_time();
+// no host, setClock() recebe um relógio virtual.
+//
+// Todas as escritas nesses pinos passam por tracedWrite(); com
+// PIN_TRACE_CAPACITY 0 ela é apenas digitalWrite(). A ISR de passos usa
+// tracedWriteFromIsr(), que escreve direto no registrador do GPIO: a ISR fica
+// registrada na IRAM e roda com o cache da flash desligado (gravação do
+// histórico), quando digitalWrite() não pode ser chamada.
+
+enum TraceSignal {
+    SIG_STEP,
+    SIG_DIR,
+    SIG_ENABLE,
+    SIG_RELAY,
+    SIG_MS1,
+    SIG_MS2,
+    SIG_MS3,
+    SIGNAL_COUNT
+};
+
+#if PIN_TRACE_CAPACITY > 0
+
+class PinTrace {
+private:
+    static uint32_t times[PIN_TRACE_CAPACITY];   // us (32 bits; desdobrado na exportação)
+    static uint8_t codes[PIN_TRACE_CAPACITY];    // sinal << 1 | nível
+    static uint32_t head;                        // Próxima posição a escrever
+    static uint32_t count;                       // Eventos válidos no buffer
+    static uint32_t overwritten;                 // Eventos mais antigos descartados
+    static uint8_t baseLevels[SIGNAL_COUNT];     // Níveis no início da janela (2 = desconhecido)
+    static uint8_t currentLevels[SIGNAL_COUNT];
+    static uint32_t startUs;
+    static volatile bool active;
+    static portMUX_TYPE lock;                    // ISR de passos (núcleo 1) x tarefa (núcleo 0)
+    static unsigned long (*clock)();
+
+    static int IRAM_ATTR signalOf(uint8_t pin);
+
+public:
+    // Relógio em microssegundos (esp_timer_get_time() por padrão; um relógio virtual no host)
+    static void setClock(unsigned long (*clockUs)());
+
+    static void start();
+    static void stop();
+    static bool isActive() { return active; }
+    static void IRAM_ATTR record(uint8_t pin, uint8_t level);
+
+    static uint32_t size() { return count; }
+    static uint32_t dropped() { return overwritten; }
+    static void exportVcd(Print& out);
+};
+
+static inline void tracedWrite(uint8_t pin, uint8_t level) {
+    digitalWrite(pin, level);
+    PinTrace::record(pin, level);
+}
+
+static inline void IRAM_ATTR tracedWriteFromIsr(uint8_t pin, uint8_t level) {
+    gpio_ll_set_level(&GPIO, (gpio_num_t)pin, level);
+    PinTrace::record(pin, level);
+}
+
+#else
+
+static inline void tracedWrite(uint8_t pin, uint8_t level) {
+    digitalWrite(pin, level);
+}
+
+static inline void IRAM_ATTR tracedWriteFromIsr(uint8_t pin, uint8_t level) {
+    gpio_ll_set_level(&GPIO, (gpio_num_t)pin, level);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "MotionTask.h"
+#include "EncoderHandler.h"
+
+// Gerencia o consumo em repouso: libera o torque de retenção após um tempo
+// sem atividade e coloca o ESP32 em light sleep, acordando pelos pinos do encoder.
+class PowerManager {
+private:
+    MotionTask& motion;
+    EncoderHandler& encoder;
+    unsigned long lastActivityTime;
+    unsigned long lastEncoderActivity;
+    bool holdReleased;
+
+    void enterLightSleep(unsigned long timerWakeupMs);
+    void restoreHold();
+
+public:
+    PowerManager(MotionTask& motionTask, EncoderHandler& encoderHandler);
+    void begin();
+    // systemIdle: nenhum movimento/ciclo em andamento
+    // holdWanted: o motor deve permanecer energizado (não está em modo livre)
+    void update(bool systemIdle, bool holdWanted);
+    void notifyActivity();
+    bool isHoldReleased();
+};
+
+#endif
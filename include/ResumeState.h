@@ -0,0 +1,61 @@
+#ifndef RESUME_STATE_H
+#define RESUME_STATE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Ponto de retomada na memória RTC lenta, que sobrevive a reinícios por
+// queda de tensão (brownout), watchdog e pânico, mas não ao desligamento.
+//
+// A tarefa de movimento grava um instantâneo a cada transição de fase do
+// ciclo e a cada mudança de configuração: 64 bytes e um CRC-32 da
+// ROM, poucos µs (métrica resume_save_ns). Há dois slots usados
+// alternadamente, com número de sequência; um reinício no meio de uma
+// gravação deixa o slot anterior íntegro.
+//
+// Na partida, load() devolve o instantâneo mais recente com CRC válido. A
+// posição gravada é a do fim da última transição: o reinício durante um
+// movimento do indexador deixa a posição real incerta (inMotion).
+//
+// O gancho de brownout roda antes do tratador do ESP-IDF (que reinicia o
+// chip) e só corta ENABLE e relé; o instantâneo já está em dia.
+
+#define RESUME_SPEED_MODES 3    // SPEED_MODE_COUNT (conferido em MotionTask.cpp)
+
+struct ResumeSnapshot {
+    int64_t absolutePosition;   // Posição ao fim da última transição
+    int64_t cycleOrigin;        // Posição do início do ciclo em andamento
+    int32_t cyclePosition;
+    int32_t cycleLength;
+    int32_t cyclesCompleted;
+    int32_t batchTotal;
+    int32_t relayOnMs;
+    int32_t settleMs;
+    int32_t speedRpm[RESUME_SPEED_MODES];
+    int16_t stations;           // Estações do indexador (0 = INDEX_STATION_TABLE)
+    uint8_t phase;              // MotionPhase (PHASE_IDLE = nenhum ciclo a retomar)
+    uint8_t pausedPhase;        // Fase interrompida, com phase = PHASE_PAUSED
+    uint8_t microstepIndex;
+    uint8_t autoMicrostep;
+    uint8_t indexing;
+    uint8_t inMotion;           // Gravado com o motor em movimento
+};
+
+class ResumeState {
+private:
+    static uint8_t resetReason;     // esp_reset_reason_t da partida
+
+    static void IRAM_ATTR onBrownout(void* arg);
+
+public:
+    // Chamar no setup(), depois de EmergencyStop::begin()
+    static void begin();
+    // Instantâneo de antes do reinício; false após ligar a placa ou sem slot válido
+    static bool load(ResumeSnapshot& snapshot);
+    // Só da tarefa de movimento
+    static void save(const ResumeSnapshot& snapshot);
+    // Motivo do último reinício, para a tela de retomada
+    static const char* resetCauseName();
+};
+
+#endif
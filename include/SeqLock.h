@@ -0,0 +1,46 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+// Instantâneo protegido por seqlock: um único escritor publica sem nunca
+// esperar; os leitores copiam e repetem a leitura se o escritor estava no
+// meio de uma atualização (contador ímpar ou alterado durante a cópia).
+// T deve ser uma struct simples (copiável com memcpy).
+template <typename T>
+class SeqLock {
+private:
+    std::atomic<uint32_t> sequence;
+    T data;
+
+public:
+    SeqLock() : sequence(0) {
+        memset(&data, 0, sizeof(data));
+    }
+
+    // Escritor
+    void write(const T& value) {
+        uint32_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &value, sizeof(T));
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // Leitores
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(&copy, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+};
+
+#endif
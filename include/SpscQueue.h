@@ -0,0 +1,42 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Fila circular sem bloqueio para um único produtor e um único consumidor
+// (cada um em uma tarefa/núcleo). push() e pop() terminam em um número fixo
+// de instruções: nenhuma das pontas espera pela outra.
+// CAPACITY deve ser potência de 2.
+template <typename T, uint32_t CAPACITY>
+class SpscQueue {
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY deve ser potencia de 2");
+
+    T slots[CAPACITY];
+    std::atomic<uint32_t> head;   // Próximo a ler (escrito só pelo consumidor)
+    std::atomic<uint32_t> tail;   // Próximo a escrever (escrito só pelo produtor)
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Produtor. Retorna false se a fila está cheia.
+    bool push(const T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) >= CAPACITY) return false;
+        slots[t & (CAPACITY - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumidor. Retorna false se a fila está vazia.
+    bool pop(T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = slots[h & (CAPACITY - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef STEP_PULSE_ENCODER_H
+#define STEP_PULSE_ENCODER_H
+
+#include <Arduino.h>
+
+// Codifica um movimento até uma posição (rampa trapezoidal) em símbolos do
+// RMT do ESP32, no formato de rmt_item32_t:
+//   bits 0-14 duração 0, bit 15 nível 0, bits 16-30 duração 1, bit 31 nível 1
+// Cada passo começa num símbolo {pulso em nível alto, resto do intervalo em
+// nível baixo}; intervalos mais longos que um símbolo continuam em símbolos
+// só em nível baixo. Duração 0 é o marcador de fim do RMT e nunca é gerada.
+//
+// Perfil de David Austin ("Generate stepper-motor speed profiles in real
+// time"): c(n) = c(n-1) - 2·c(n-1) / (4n + 1) na aceleração e a mesma
+// sequência ao contrário na frenagem. begin() usa ponto flutuante (contexto
+// de tarefa); fill() só usa inteiros, em ponto fixo Q8, porque roda na ISR
+// do RMT, onde a FPU não pode ser usada.
+//
+// Não depende do hardware: no host os símbolos podem ser decodificados de
+// volta em intervalos e comparados com o perfil.
+
+#define STEP_SYMBOL_MAX_DURATION 32767
+
+struct StepProfile {
+    uint32_t steps;             // Passos do movimento (sem sinal)
+    float maxSpeed;             // Passos/s
+    float acceleration;         // Passos/s²
+    uint32_t ticksPerSecond;    // Relógio dos símbolos
+    uint16_t pulseTicks;        // Largura do pulso de STEP
+};
+
+class StepPulseEncoder {
+private:
+    uint32_t totalSteps;
+    uint32_t stepIndex;         // Próximo passo a codificar
+    uint32_t rampSteps;         // Passos da aceleração (iguais aos da frenagem)
+    uint32_t intervalQ8;        // c(n) do perfil, em ticks Q8
+    uint32_t cruiseQ8;          // Intervalo na velocidade máxima, em ticks Q8
+    uint32_t fractionQ8;        // Fração de tick acumulada entre os passos
+    uint32_t divisionRest;      // Resto da divisão da rampa, levado ao passo seguinte
+    uint32_t pendingLowTicks;   // Nível baixo do passo atual ainda não codificado
+    volatile uint32_t lastIntervalTicks;
+    uint16_t pulseTicks;
+
+    uint32_t nextIntervalTicks();
+
+public:
+    StepPulseEncoder();
+    void begin(const StepProfile& profile);
+    // Preenche até 'capacity' símbolos e retorna quantos; 'steps' recebe
+    // quantos passos começam neles. Retorna menos que 'capacity' só no fim.
+    size_t fill(uint32_t* symbols, size_t capacity, uint32_t& steps);
+    bool done() const { return stepIndex >= totalSteps && pendingLowTicks == 0; }
+    // Intervalo do último passo codificado, em ticks (velocidade atual)
+    uint32_t lastInterval() const { return lastIntervalTicks; }
+
+    static uint32_t symbol(uint32_t duration0, bool level0, uint32_t duration1, bool level1) {
+        return duration0 | ((uint32_t)level0 << 15) | (duration1 << 16) | ((uint32_t)level1 << 31);
+    }
+};
+
+#endif
@@ -3,11 +3,99 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "StepperDriver.h"
+#include "StepPulseEncoder.h"
+
+// Emissores de pulsos dos movimentos até uma posição (STEP_BACKEND, config.h).
+// O jog e o micro-passo automático usam sempre o timer.
+#define STEP_BACKEND_TIMER  1   // ISR do timer a cada passo
+#define STEP_BACKEND_RMT    2   // Trem de pulsos pré-codificado no periférico RMT
+
+// Taxa máxima de pulsos dos movimentos até uma posição
+#if STEP_BACKEND == STEP_BACKEND_RMT
+#define POSITION_MOVE_MAX_PULSE_RATE  RMT_MAX_STEP_RATE
+#else
+#define POSITION_MOVE_MAX_PULSE_RATE  MAX_STEP_PULSE_RATE
+#endif
 
 class StepperController {
 private:
     bool enabled;
-    int currentDirection; // 1 = horário, -1 = anti-horário
+    ActiveDriver driver;   // Backend escolhido em tempo de compilação
+    int currentDirection; // 1 = horário, -1 = anti-horário (nível atual do DIR_PIN)
+    int lastMotionDirection; // Sentido do último movimento (0 = nenhum ainda)
+    int backlashSteps;       // Passos extras para vencer a folga na inversão
+    uint32_t stepIntervalUs; // Intervalo mínimo entre pulsos de pulseStep() (0 = sem ritmo)
+    uint32_t lastPulseUs;
+
+    // Posição absoluta multivoltas, mantida por quem emite os pulsos (loop de
+    // passos e ISRs do timer e do RMT). Os passos de folga não entram na contagem.
+    static volatile int64_t absolutePosition;
+    static portMUX_TYPE positionLock;    // 64 bits não são atômicos no ESP32
+    // A ISR deixa de pulsar ao chegar aqui (movimentos até uma posição)
+    static volatile int64_t stopPosition;
+    static volatile bool stopArmed;
+
+    // --- Modo velocidade: pulsos gerados por timer de hardware ---
+    static hw_timer_t* stepTimer;
+    static volatile int8_t stepSign;     // +1 horário, -1 anti-horário
+    bool timerRunning;
+    float currentSpeed;                  // Passos/s com sinal
+    float targetSpeed;                   // Passos/s com sinal
+    float acceleration;                  // Passos/s²
+    unsigned long lastRampUpdate;
+
+    // --- Movimento até uma posição (rampa trapezoidal sobre o modo velocidade) ---
+    bool positionMoveActive;
+    int64_t positionMoveTarget;
+    float positionMoveMaxSpeed;
+
+    // --- Micro-passo automático (modo velocidade) ---
+    // A posição continua na resolução escolhida, a mais fina; com a resolução
+    // dividida por 2^stepShift cada pulso vale 1 << stepShift unidades. A ISR
+    // só aplica a troca numa posição múltipla da resolução mais grossa das
+    // duas, onde a fase do driver coincide nelas, e volta à fina perto do alvo.
+    bool autoMicrostep;
+    int microstepIndex;                  // Resolução escolhida (unidade da posição)
+    static volatile uint8_t stepShift;   // Resolução atual = escolhida / 2^stepShift
+    static volatile uint8_t pendingShift;
+    static volatile uint32_t timerIntervalUs;
+    static uint8_t shiftModeBits[ActiveDriver::MICROSTEP_COUNT];
+    // Fase do tradutor do driver, em unidades da maior resolução do driver,
+    // contada desde o estado inicial (Home) do tradutor. Todo pulso conta,
+    // inclusive os de folga, e setAbsolutePosition() não mexe nela: a posição
+    // é do operador, a fase é do driver. A troca de resolução se alinha por ela.
+    static volatile uint32_t driverPhase;
+    static volatile uint32_t phasePerStep;   // Unidades de fase por pulso da resolução escolhida
+
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    // --- Movimento até uma posição pelo RMT ---
+    // O perfil inteiro vira símbolos do RMT (StepPulseEncoder). A memória do
+    // canal, 64 símbolos, é usada como dois buffers: a ISR recodifica uma
+    // metade enquanto a outra é transmitida, uma interrupção a cada 32 passos.
+    static StepPulseEncoder rmtEncoder;
+    static volatile uint32_t rmtHalfSteps[2];   // Passos de cada metade ainda não contados
+    static volatile uint8_t rmtActiveHalf;      // Metade em transmissão
+    static volatile bool rmtEnding;             // Marcador de fim escrito: sem recarga
+    static volatile bool rmtTransmitting;
+    bool rmtMoveActive;
+
+    static void IRAM_ATTR onRmtInterrupt(void* arg);
+    static void IRAM_ATTR refillRmtHalf(uint8_t half);
+    static void IRAM_ATTR countRmtSteps(uint32_t steps);  // Com positionLock tomada
+    void beginRmt();
+    void startRmtMove(int64_t target, float maxSpeed, float stepsPerSec2);
+    void finishRmtMove();
+    uint32_t rmtStepsSent();
+#endif
+
+    static void IRAM_ATTR onStepTimer();
+    static void IRAM_ATTR applyShift(uint8_t shift, uint8_t previousShift);
+    void applySpeed();
+    void restoreFineMicrostep();
+    void pulseStep();
+    void advancePosition(int32_t steps);
+    void prepareMotion(bool clockwise);
     
 public:
     StepperController();
@@ -15,9 +103,37 @@ public:
     void enable();
     void disable();
     void moveOneStep(bool clockwise = true);
-    void moveSteps(int steps);
     void setDirection(bool clockwise);
     bool isEnabled();
+    void setBacklashSteps(int steps);
+    // Ritmo dos passos emitidos fora do timer (moveOneStep() e compensação de folga)
+    void setStepRate(float stepsPerSec);
+    void setMicrostep(int index);
+    // Troca automática da resolução pela velocidade (só nas rampas do modo
+    // velocidade; sem efeito em drivers sem AUTO_MICROSTEP_SUPPORTED). Ligar
+    // reinicia o tradutor pelo DRIVER_RESET_PIN, se houver, como referência de fase.
+    void setAutoMicrostep(bool on);
+    bool isAutoMicrostep();
+    int getStepShift();
+    uint32_t getDriverPhase();
+
+    // Posição absoluta em passos da resolução atual (volta/passo: MotionMath.h)
+    int64_t getAbsolutePosition();
+    void setAbsolutePosition(int64_t position);
+
+    // Modo velocidade (jog): a velocidade pode ser alterada durante o movimento
+    void setAcceleration(float stepsPerSec2);
+    void startVelocityMode();
+    void setTargetSpeed(float stepsPerSec);
+    void updateVelocity();      // Aplica a rampa; chamar periodicamente no loop()
+    void stopVelocityMode();    // Parada imediata (sem rampa)
+
+    // Movimento acelerado até uma posição absoluta, parando exatamente nela
+    void startPositionMove(int64_t target, float maxSpeed, float stepsPerSec2);
+    bool updatePositionMove();  // Chamar periodicamente; false quando chegou
+    void abortMotion();         // Para o timer ou o RMT e descarta o alvo (parada de emergência)
+    float getCurrentSpeed();
+    bool isStopped();
 };
 
 #endif
\ No newline at end of file
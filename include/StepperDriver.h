@@ -0,0 +1,90 @@
+#ifndef STEPPER_DRIVER_H
+#define STEPPER_DRIVER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Backends de driver de motor de passo. O backend ativo é escolhido em tempo
+// de compilação por STEPPER_DRIVER (config.h) e exposto como ActiveDriver,
+// sem chamadas virtuais. Todos oferecem a mesma interface:
+//   MICROSTEP_COUNT, multipliers[], labels[], begin(), applyMicrostep(index)
+// Os drivers configurados por pinos também expõem modeBits[] (bit 0 = MS1,
+// bit 1 = MS2, bit 2 = MS3), usado para trocar a resolução dentro da ISR, e
+// resetTranslator(), a referência de fase dessa troca.
+
+#define DRIVER_A4988    1
+#define DRIVER_DRV8825  2
+#define DRIVER_TMC2209  3
+
+// A4988: micro-passo pelos pinos MS1/MS2/MS3, até 1/16
+class A4988Driver {
+public:
+    static const int MICROSTEP_COUNT = 5;
+    static const uint16_t multipliers[MICROSTEP_COUNT];
+    static const char* const labels[MICROSTEP_COUNT];
+    static const uint8_t modeBits[MICROSTEP_COUNT];
+
+    void begin();
+    void applyMicrostep(int index);
+    // Tradutor de volta ao estado inicial (Home) pelo DRIVER_RESET_PIN
+    void resetTranslator();
+};
+
+// DRV8825: micro-passo pelos pinos M0/M1/M2 (ligados em MS1/MS2/MS3), até 1/32
+class DRV8825Driver {
+public:
+    static const int MICROSTEP_COUNT = 6;
+    static const uint16_t multipliers[MICROSTEP_COUNT];
+    static const char* const labels[MICROSTEP_COUNT];
+    static const uint8_t modeBits[MICROSTEP_COUNT];
+
+    void begin();
+    void applyMicrostep(int index);
+    // Tradutor de volta ao estado inicial (Home) pelo DRIVER_RESET_PIN
+    void resetTranslator();
+};
+
+// TMC2209: configurado pela UART de fio único, até 1/256 com interpolação
+// e correntes de operação/retenção ajustáveis. Qualquer Stream serve como
+// porta, o que permite testar o protocolo contra um mapa de registradores falso.
+class TMC2209Driver {
+private:
+    Stream& port;
+    uint8_t address;
+    uint32_t chopconf;      // Cópia do CHOPCONF (registrador somente escrita)
+
+public:
+    static const int MICROSTEP_COUNT = 9;
+    static const uint16_t multipliers[MICROSTEP_COUNT];
+    static const char* const labels[MICROSTEP_COUNT];
+
+    // Registradores usados
+    static const uint8_t REG_GCONF      = 0x00;
+    static const uint8_t REG_IHOLD_IRUN = 0x10;
+    static const uint8_t REG_CHOPCONF   = 0x6C;
+
+    TMC2209Driver(Stream& uartPort, uint8_t slaveAddress);
+    void begin();
+    void applyMicrostep(int index);
+    // Correntes em 1/32 da corrente de escala (0-31)
+    void setCurrents(uint8_t runCurrent, uint8_t holdCurrent);
+    void writeRegister(uint8_t reg, uint32_t value);
+
+    static uint8_t crc8(const uint8_t* data, size_t length);
+};
+
+// Micro-passo automático: só com a resolução nos pinos MS1-MS3 (a troca pela
+// UART do TMC2209 não cabe entre dois pulsos; ele já interpola para 1/256)
+#define AUTO_MICROSTEP_SUPPORTED (STEPPER_DRIVER != DRIVER_TMC2209)
+
+#if STEPPER_DRIVER == DRIVER_A4988
+typedef A4988Driver ActiveDriver;
+#elif STEPPER_DRIVER == DRIVER_DRV8825
+typedef DRV8825Driver ActiveDriver;
+#elif STEPPER_DRIVER == DRIVER_TMC2209
+typedef TMC2209Driver ActiveDriver;
+#else
+#error "STEPPER_DRIVER invalido (use DRIVER_A4988, DRIVER_DRV8825 ou DRIVER_TMC2209)"
+#endif
+
+#endif
@@ -1,17 +1,83 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-// --- Pinos de Controle de Micro-passo (A4988) ---
+// Versão do firmware (incluída nos resultados dos benchmarks)
+#define FIRMWARE_VERSION "1.1.0"
+
+// --- Driver do motor de passo ---
+// DRIVER_A4988 (até 1/16), DRIVER_DRV8825 (até 1/32) ou DRIVER_TMC2209 (UART, até 1/256)
+#define STEPPER_DRIVER  DRIVER_A4988
+
+// --- Pinos de Controle de Micro-passo (A4988/DRV8825; endereço UART no TMC2209) ---
 #define MS1_PIN         14
 #define MS2_PIN         12
 #define MS3_PIN         13
+// RESET do A4988/DRV8825 (ativo em LOW), referência de fase do micro-passo
+// automático: pulsado na partida e ao escolher "Auto". -1 = RESET fixo em
+// HIGH (ligado ao SLEEP); a referência passa a ser a energização do driver,
+// que então precisa ligar junto com o ESP32.
+#define DRIVER_RESET_PIN -1
+
+// --- TMC2209 (somente com STEPPER_DRIVER = DRIVER_TMC2209) ---
+#define TMC_UART        Serial2
+#define TMC_UART_BAUD   115200
+#define TMC_UART_RX_PIN 16
+#define TMC_UART_TX_PIN 17
+#define TMC_ADDRESS     0     // Definido por MS1/MS2
+#define TMC_RUN_CURRENT 20    // Corrente em movimento (0-31, em 1/32 da escala)
+#define TMC_HOLD_CURRENT 8    // Corrente de retenção (0-31)
+#define TMC_HOLD_DELAY  6     // Tempo de transição para a corrente de retenção (0-15)
 
 // Configurações do Motor de Passo
 #define STEP_PIN        26
 #define DIR_PIN         25
 #define ENABLE_PIN      27
 #define BASE_STEPS_PER_REV   200
-#define STEP_DELAY_US   1000  // Microsegundos entre pulsos
+#define STEP_PULSE_US   2     // Largura do pulso de STEP gerado pelo timer
+#define STEP_TIMER_ID   0     // Timer de hardware usado no modo velocidade
+#define MIN_STEP_SPEED  20    // Velocidade mínima (passos/s) antes de parar
+// Taxa de pulsos que o timer e a ISR de passos sustentam. As velocidades em
+// RPM são limitadas a ela na resolução que emite os passos.
+#define MAX_STEP_PULSE_RATE  20000 // Pulsos/s
+
+// Emissor dos movimentos até uma posição (posicionamento e indexador):
+// STEP_BACKEND_TIMER (ISR do timer a cada passo) ou STEP_BACKEND_RMT (rampa
+// inteira codificada em símbolos do RMT; a CPU só recodifica um buffer a cada
+// 32 passos). O jog e o micro-passo automático usam sempre o timer.
+#define STEP_BACKEND         STEP_BACKEND_TIMER
+#define RMT_STEP_CHANNEL     0
+#define RMT_CLOCK_DIV        8       // 80 MHz / 8 = 10 MHz, 0,1 µs por tick
+#define RMT_MAX_STEP_RATE    200000  // Pulsos/s dos movimentos pelo RMT
+
+// Velocidades por modo, em RPM do eixo, ajustáveis no menu "Velocidades"
+// (valem para qualquer micro-passo; o limite é revalidado a cada troca)
+#define POSITIONING_DEFAULT_RPM   60
+#define CYCLE_DEFAULT_RPM         180  // Movimentos do indexador e compensação de folga no ciclo
+#define JOG_DEFAULT_RPM           120  // Velocidade máxima do jog
+#define SPEED_MIN_RPM             5
+#define SPEED_MAX_RPM             600  // Limite mecânico, independente do micro-passo
+#define SPEED_RPM_INCREMENT       5    // Por passo do encoder
+#define POSITIONING_ACCELERATION  1500 // Passos/s² em full step (escala com o micro-passo)
+// Passos extras (em full step) emitidos em cada inversão de sentido para vencer
+// a folga mecânica. Não entram na contagem de posição. 0 = sem compensação.
+#define BACKLASH_STEPS  0
+
+// Micro-passo automático (opção "Auto" do menu Micro-passo; A4988/DRV8825).
+// Nas rampas do modo velocidade a resolução cai pela metade sempre que a taxa
+// de pulsos passaria de AUTO_MICROSTEP_MAX_PULSE_RATE, e volta a refinar
+// abaixo de AUTO_MICROSTEP_MAX_PULSE_RATE * AUTO_MICROSTEP_HYSTERESIS / 100.
+#define AUTO_MICROSTEP_MAX_PULSE_RATE  8000  // Pulsos/s
+#define AUTO_MICROSTEP_HYSTERESIS      75    // %
+// Faixas de velocidade ressonantes, em passos/s de full step: {início, fim}.
+// As rampas atravessam cada faixa num salto e não permanecem dentro dela.
+// Ex.: { {90, 130}, {240, 270} }. {0, 0} = nenhuma.
+#define RESONANCE_BANDS  { {0, 0} }
+
+// Configurações do modo Jog (valores em full step; escalam com o micro-passo)
+#define JOG_ACCELERATION          800   // Passos/s²
+#define JOG_SPEED_PER_DETENT_RATE 20    // Passos/s para cada passo do encoder/s
+#define JOG_RELEASE_MS            250   // Sem giro por este tempo = soltou o botão
+#define JOG_DISPLAY_INTERVAL_MS   100   // Intervalo de atualização da tela
 
 // Configurações do Display OLED
 #define SCREEN_WIDTH    128
@@ -19,9 +85,64 @@
 #define OLED_RESET      -1
 #define SCREEN_ADDRESS  0x3C
 
+// Backend do display: DISPLAY_BACKEND_I2C, DISPLAY_BACKEND_SPI ou
+// DISPLAY_BACKEND_HOST (quadros em arquivos PBM, para compilação no host).
+// O ambiente native do platformio.ini define DISPLAY_BACKEND_HOST.
+#ifndef DISPLAY_BACKEND
+#define DISPLAY_BACKEND       DISPLAY_BACKEND_I2C
+#endif
+// Controlador do painel: OLED_SSD1306 ou OLED_SH1106
+#define OLED_CONTROLLER       OLED_SSD1306
+
+// Transferência do framebuffer: 1 = assíncrona (tarefa em segundo plano),
+// 0 = bloqueante na chamada da tela
+#define OLED_ASYNC_FLUSH      1
+
+// Painel I2C (driver do ESP-IDF)
+#define OLED_I2C_PORT         I2C_NUM_0
+#define OLED_SDA_PIN          21
+#define OLED_SCL_PIN          22
+// O SSD1306 é especificado para 400 kHz; muitos painéis aceitam até 1 MHz
+#define OLED_I2C_CLOCK_HZ     400000
+#define OLED_I2C_TIMEOUT_MS   50    // Tempo máximo por bloco
+
+// Painel SPI (4 fios). Sem pinos de strapping (0, 2, 5, 12, 15) nem só de
+// entrada (34-39); SCK e CS usam os pinos da UART do TMC2209, livres com os
+// drivers de pinos MS (com o TMC2209, remapeie: a compilação acusa o conflito).
+#define OLED_SPI_HOST         VSPI
+#define OLED_SPI_CLOCK_HZ     10000000  // SSD1306/SH1106 aceitam até 10 MHz
+#define OLED_SPI_SCK_PIN      17
+#define OLED_SPI_MOSI_PIN     23        // MOSI nativo do VSPI
+#define OLED_SPI_DC_PIN       4
+#define OLED_SPI_CS_PIN       16
+#define OLED_SPI_RST_PIN      -1        // -1 = reset ligado ao EN da placa
+
+// Backend do host: prefixo dos arquivos (frame_00001.pbm, ...)
+#ifndef OLED_HOST_FRAME_PREFIX
+#define OLED_HOST_FRAME_PREFIX "frame_"
+#endif
+
+#define DISPLAY_TASK_CORE     1     // Mesmo núcleo da interface; o núcleo 0 fica com o movimento
+#define DISPLAY_TASK_PRIORITY 2     // Acima do loop(): começa a enviar assim que há um quadro
+#define DISPLAY_TASK_STACK    3072
+
 // Defina aqui quantos itens do menu principal devem ser visíveis na tela.
 // Para sua tela de 64px de altura, 3 ou 4 é um bom valor.
 #define MAX_VISIBLE_MENU_ITEMS 3
+// Níveis de submenu (a raiz conta 1); conferido contra a árvore ao compilar
+#define MENU_MAX_DEPTH 3
+
+// Intervalo de atualização da tela de diagnóstico
+#define DIAGNOSTICS_REFRESH_MS 500
+
+// Tamanho do buffer de gravação de entradas (2 bytes por evento)
+#define INPUT_TRACE_CAPACITY 4096
+// Importação pela serial ('i'): espera máxima entre dois caracteres
+#define INPUT_TRACE_IMPORT_TIMEOUT_MS 2000
+
+// Traço das bordas dos pinos de saída exportado em VCD (5 bytes por borda;
+// guarda as mais recentes). 0 = desativado, sem custo nas escritas.
+#define PIN_TRACE_CAPACITY 4096
 
 // Configurações do Encoder
 #define ENCODER_CLK     18
@@ -32,6 +153,56 @@
 // Configurações do Relé
 #define RELAY_PIN       32
 
+// Parada de emergência / fim de curso: contato NF para o GND com pull-up interno,
+// de modo que um fio rompido também para a máquina. A interrupção corta o
+// ENABLE, desliga o relé e trava o emissor de passos.
+#define ESTOP_PIN           33
+#define ESTOP_ACTIVE_LEVEL  HIGH  // Nível do pino com o contato aberto (acionado)
+// Teste de latência (comando serial 'e'): saída ligada ao ESTOP_PIN por um
+// resistor de 1k no lugar do contato. -1 = sem teste. O ambiente native do
+// platformio.ini define um pino, ligado ao ESTOP_PIN pelos testes.
+#ifndef ESTOP_TEST_PIN
+#define ESTOP_TEST_PIN      -1
+#endif
+#define ESTOP_MAX_LATENCY_US 100  // Limite aceito pelo teste de latência
+
+// Configurações de gerenciamento de energia (0 desativa o recurso)
+// Tempo sem atividade até desenergizar o motor parado (libera o torque de retenção)
+#define HOLD_RELEASE_TIMEOUT_MS 60000
+// Tempo sem atividade até colocar o ESP32 em light sleep
+#define LIGHT_SLEEP_TIMEOUT_MS  30000
+
+// Número máximo de ciclos em um lote de produção
+#define BATCH_MAX_CYCLES 999
+
+// Histórico de produção na flash (partição "history" do partitions.csv)
+#define HISTORY_PARTITION_LABEL "history"
+// Setores mantidos apagados à frente do log. 4 x 255 registros cobrem um
+// lote inteiro de BATCH_MAX_CYCLES sem apagar a flash durante o lote.
+#define HISTORY_SPARE_SECTORS   4
+// Cada apagamento trava as duas CPUs por dezenas de ms: a tarefa de movimento
+// só apaga depois desse tempo parada, e no máximo um setor por intervalo
+#define HISTORY_MAINTAIN_IDLE_MS      1000
+#define HISTORY_MAINTAIN_INTERVAL_MS  500
+
+// Modo indexador: o relé atua só nas estações, com um movimento rápido entre elas
+#define INDEX_MAX_STATIONS      24
+#define INDEX_DEFAULT_STATIONS  4
+// Estações da opção "Tabela", em décimos de grau: crescentes, começando em 0 e < 3600
+#define INDEX_STATION_TABLE     {0, 450, 1800, 2250}
+#define INDEX_ACCELERATION      3000  // Passos/s² em full step
+
+// Tarefa de movimento/E-S: roda no núcleo 0, separada da interface (loop() no núcleo 1)
+#define MOTION_TASK_CORE        0
+#define MOTION_TASK_PRIORITY    5     // Acima do loop() (prioridade 1)
+#define MOTION_TASK_STACK       4096
+#define MOTION_TASK_PERIOD_MS   1     // Período de atualização da tarefa
+#define MOTION_QUEUE_CAPACITY   16    // Comandos pendentes (potência de 2)
+// Watchdog da tarefa de movimento: sem atualização por este tempo o ESP32
+// reinicia e volta com a parada de emergência acionada
+#define MOTION_WATCHDOG_TIMEOUT_S 2
+#define POSITIONING_HOLD_MS     2000  // Tela de posicionamento após concluir o movimento
+
 // Configurações do sistema
 #define ANGLE_INCREMENT 18    // 1.8 graus em décimos (18 = 1.8°)
 
@@ -1,73 +0,0 @@
-// 'logo', 128x64px
-const unsigned char epd_bitmap_logo [] PROGMEM = {
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xfe, 0x70, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xfe, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xff, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xf0, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0xe0, 0x00, 
-	0x00, 0x1f, 0xc0, 0x7f, 0x26, 0x01, 0x7f, 0xed, 0x80, 0x20, 0x09, 0x80, 0x04, 0x03, 0x80, 0x00, 
-	0x00, 0x30, 0x60, 0xc0, 0x26, 0x01, 0x02, 0x0d, 0x80, 0x20, 0x09, 0x80, 0x04, 0x03, 0x80, 0x00, 
-	0x00, 0x20, 0x01, 0x00, 0x27, 0x01, 0x02, 0x0d, 0x80, 0x20, 0x09, 0xc0, 0x0e, 0x03, 0x00, 0x00, 
-	0x00, 0x20, 0x02, 0x00, 0x25, 0x01, 0x02, 0x0d, 0x80, 0x20, 0x09, 0xc0, 0x0e, 0x03, 0x00, 0x00, 
-	0x00, 0x20, 0x06, 0x00, 0x25, 0x81, 0x02, 0x09, 0x00, 0x20, 0x09, 0x40, 0x16, 0x03, 0x00, 0x00, 
-	0x00, 0x30, 0x04, 0x00, 0x24, 0xc1, 0x02, 0x09, 0x00, 0x20, 0x09, 0x20, 0x16, 0x02, 0x00, 0x00, 
-	0x00, 0x18, 0x04, 0x00, 0x24, 0x41, 0x02, 0x09, 0x00, 0x20, 0x09, 0x20, 0x36, 0x02, 0x00, 0x00, 
-	0x00, 0x0f, 0x04, 0x00, 0x24, 0x61, 0x02, 0x09, 0x00, 0x20, 0x09, 0x30, 0x26, 0x02, 0x00, 0x00, 
-	0x00, 0x01, 0xc4, 0x00, 0x24, 0x21, 0x02, 0x09, 0x00, 0x20, 0x09, 0x10, 0x66, 0x02, 0x00, 0x00, 
-	0x00, 0x00, 0x64, 0x00, 0x24, 0x11, 0x02, 0x0d, 0x80, 0x20, 0x09, 0x18, 0x46, 0x02, 0x00, 0x00, 
-	0x00, 0x00, 0x34, 0x00, 0x24, 0x11, 0x02, 0x0d, 0x80, 0x20, 0x09, 0x08, 0xc6, 0x02, 0x00, 0x00, 
-	0x00, 0x00, 0x12, 0x00, 0x24, 0x09, 0x02, 0x0d, 0x80, 0x20, 0x09, 0x0c, 0xc6, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x13, 0x00, 0x24, 0x0d, 0x02, 0x0d, 0x80, 0x30, 0x19, 0x04, 0x86, 0x00, 0x00, 0x00, 
-	0x00, 0x20, 0x21, 0x80, 0x24, 0x07, 0x02, 0x0d, 0x80, 0x10, 0x11, 0x05, 0x86, 0x00, 0x00, 0x00, 
-	0x00, 0x10, 0x60, 0xe1, 0x24, 0x03, 0x02, 0x0d, 0x80, 0x1c, 0x61, 0x07, 0x06, 0x00, 0x00, 0x00, 
-	0x00, 0x0f, 0x80, 0x3f, 0x24, 0x03, 0x02, 0x0d, 0xff, 0x07, 0xc1, 0x03, 0x06, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xc0, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x09, 0x2a, 0x52, 0x45, 0x2d, 0x69, 0x25, 0x25, 0x90, 0xb4, 0xb6, 0x82, 0xd8, 0x00, 
-	0x00, 0x00, 0x01, 0x09, 0x54, 0x84, 0x21, 0x41, 0x25, 0x20, 0x90, 0x84, 0xa2, 0x40, 0x50, 0x00, 
-	0x00, 0x00, 0x04, 0xc8, 0x09, 0x81, 0x01, 0x41, 0x25, 0x24, 0x90, 0x04, 0xa0, 0x40, 0x50, 0x00, 
-	0x00, 0x00, 0x06, 0xc4, 0x89, 0x80, 0xa1, 0x41, 0x25, 0x20, 0x90, 0x84, 0xa0, 0x42, 0x50, 0x00, 
-	0x00, 0x00, 0x00, 0x44, 0x89, 0x27, 0x19, 0x00, 0xa4, 0xe0, 0x94, 0x63, 0x20, 0x11, 0x90, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-};
-
-// Array of all bitmaps for convenience. (Total bytes used to store images in PROGMEM = 1040)
-const int epd_bitmap_allArray_LEN = 1;
-const unsigned char* epd_bitmap_allArray[1] = {
-	epd_bitmap_logo
-};
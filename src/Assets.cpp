@@ -0,0 +1,31 @@
+// Gerado por tools/asset_converter.py a partir de assets/assets.json. Não editar.
+#include "Assets.h"
+
+// logo.pbm: 128x64, 1024 -> 370 bytes (ASSET_RLE)
+static const uint8_t logoBitmapData[] PROGMEM = {
+    0xeb, 0x00, 0x00, 0x80, 0xf4, 0x00, 0x80, 0x80, 0x07, 0xc0, 0xe0, 0xfe, 0xe0, 0xf8, 0xff, 0x00,
+    0x00, 0x80, 0x80, 0x93, 0x00, 0x01, 0xc0, 0x60, 0x82, 0x20, 0x01, 0x60, 0x40, 0x81, 0x00, 0x02,
+    0x80, 0x40, 0x60, 0x83, 0x20, 0x07, 0x00, 0x00, 0xe0, 0x00, 0x00, 0xe0, 0xe0, 0x80, 0x84, 0x00,
+    0x01, 0xe0, 0x00, 0x82, 0x20, 0x00, 0xe0, 0x81, 0x20, 0x05, 0x00, 0xe0, 0xe0, 0x00, 0xe0, 0xe0,
+    0x86, 0x00, 0x00, 0xe0, 0x86, 0x00, 0x05, 0xe0, 0x00, 0x00, 0xe0, 0xe0, 0x80, 0x87, 0x00, 0x04,
+    0x82, 0xe2, 0x82, 0x02, 0x02, 0x80, 0x03, 0x07, 0x1f, 0x07, 0xff, 0xfd, 0x7c, 0x1c, 0x1c, 0x0c,
+    0x81, 0x04, 0x8f, 0x00, 0x0c, 0x07, 0x0c, 0x18, 0x10, 0x10, 0x30, 0x20, 0x60, 0xc0, 0x80, 0x00,
+    0xfe, 0x03, 0x88, 0x00, 0x09, 0xff, 0x00, 0x00, 0xff, 0x00, 0x03, 0x06, 0x1c, 0x30, 0xc0, 0x80,
+    0x00, 0x00, 0xff, 0x83, 0x00, 0x00, 0xff, 0x82, 0x00, 0x04, 0xff, 0xc1, 0x00, 0xff, 0xc1, 0x86,
+    0x00, 0x00, 0xff, 0x86, 0x00, 0x08, 0xff, 0x00, 0x00, 0xff, 0x01, 0x03, 0x1c, 0x70, 0xc0, 0x80,
+    0x00, 0x06, 0x80, 0xe0, 0x38, 0x0e, 0x01, 0xff, 0xff, 0x84, 0x00, 0x01, 0xff, 0x03, 0x97, 0x00,
+    0x01, 0x04, 0x08, 0x82, 0x10, 0x09, 0x08, 0x0c, 0x03, 0x00, 0x00, 0x03, 0x06, 0x0c, 0x08, 0x18,
+    0x81, 0x10, 0x06, 0x18, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x1f, 0x83, 0x00, 0x03, 0x03, 0x06, 0x1c,
+    0x1f, 0x83, 0x00, 0x00, 0x1f, 0x82, 0x00, 0x04, 0x1f, 0x1f, 0x00, 0x1f, 0x1f, 0x84, 0x10, 0x05,
+    0x00, 0x00, 0x03, 0x0e, 0x08, 0x18, 0x80, 0x10, 0x06, 0x18, 0x08, 0x06, 0x03, 0x00, 0x00, 0x1f,
+    0x81, 0x00, 0x05, 0x01, 0x0f, 0x18, 0x1c, 0x07, 0x01, 0x80, 0x00, 0x01, 0x1f, 0x1f, 0xc1, 0x00,
+    0x89, 0x02, 0x00, 0x42, 0x8a, 0x02, 0x00, 0x82, 0x91, 0x02, 0xb7, 0x00, 0x60, 0x02, 0x18, 0x10,
+    0x06, 0x18, 0x38, 0x02, 0x00, 0x0e, 0x30, 0x02, 0x04, 0x30, 0x06, 0x00, 0x06, 0x38, 0x04, 0x02,
+    0x38, 0x1c, 0x02, 0x20, 0x00, 0x00, 0x26, 0x21, 0x2a, 0x10, 0x00, 0x16, 0x20, 0x22, 0x02, 0x00,
+    0x3e, 0x00, 0x1e, 0x02, 0x00, 0x02, 0x00, 0x00, 0x1f, 0x20, 0x00, 0x3e, 0x00, 0x00, 0x3f, 0x00,
+    0x1e, 0x20, 0x20, 0x3e, 0x00, 0x00, 0x0a, 0x00, 0x02, 0x3e, 0x00, 0x00, 0x3e, 0x00, 0x20, 0x00,
+    0x00, 0x16, 0x20, 0x22, 0x02, 0x00, 0x1e, 0x20, 0x20, 0x1e, 0x00, 0x3e, 0x02, 0x00, 0x02, 0x06,
+    0x00, 0x02, 0x1c, 0x00, 0x20, 0x00, 0x00, 0x12, 0x20, 0x22, 0x1e, 0x00, 0x3e, 0x02, 0xff, 0x00,
+    0x86, 0x00,
+};
+const CompressedBitmap logoBitmap = {128, 64, ASSET_RLE, sizeof(logoBitmapData), logoBitmapData};
@@ -0,0 +1,367 @@
+#include "Benchmark.h"
+#include "Metrics.h"
+#include "MotionMath.h"
+#include "StepperDriver.h"
+#include "StepPulseEncoder.h"
+#include "Assets.h"
+
+#define BENCH_PATH_ITERATIONS    100000
+#define BENCH_ENCODER_ITERATIONS 10000
+#define BENCH_SCREEN_ITERATIONS  10
+#define BENCH_FLUSH_ITERATIONS   20
+#define BENCH_ENCODING_STEPS     20000
+#define BENCH_ASSET_ITERATIONS   100
+
+void Benchmark::report(Print& out, const char* name, uint32_t iterations, uint32_t totalUs, bool pass) {
+    uint32_t nsPerOp = iterations ? (uint32_t)((uint64_t)totalUs * 1000ULL / iterations) : 0;
+    out.printf("{\"fw\":\"%s\",\"bench\":\"%s\",\"iterations\":%u,\"total_us\":%u,\"ns_per_op\":%u,\"pass\":%s}\n",
+               FIRMWARE_VERSION, name, iterations, totalUs, nsPerOp, pass ? "true" : "false");
+}
+
+// Cálculo do menor caminho usado por startPositioning()
+bool Benchmark::benchShortestPath(Print& out) {
+    // Casos conhecidos: {atual, alvo, passos/volta, esperado}
+    static const int cases[][4] = {
+        {0,    0,    200,  0},
+        {0,    50,   200,  50},
+        {0,    150,  200,  -50},
+        {199,  0,    200,  1},
+        {0,    199,  200,  -1},
+        {0,    100,  200,  100},
+        {10,   3190, 3200, -20},
+        {3190, 10,   3200, 20},
+    };
+    bool pass = true;
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (shortestPathSteps(cases[i][0], cases[i][1], cases[i][2]) != cases[i][3]) {
+            pass = false;
+        }
+    }
+
+    // 'volatile' impede que o compilador elimine o laço
+    volatile int sink = 0;
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_PATH_ITERATIONS; i++) {
+        sink += shortestPathSteps(i % 3200, (i * 7) % 3200, 3200);
+    }
+    uint32_t elapsed = micros() - start;
+
+    report(out, "shortest_path", BENCH_PATH_ITERATIONS, elapsed, pass);
+    return pass;
+}
+
+// Visões volta/passo da posição absoluta (divisão de 64 bits a cada iteração
+// da tarefa de movimento)
+bool Benchmark::benchPositionViews(Print& out) {
+    // Casos conhecidos: {posição, passos/volta, volta, passo}
+    static const int64_t cases[][4] = {
+        {0,            200,   0,      0},
+        {199,          200,   0,      199},
+        {200,          200,   1,      0},
+        {-1,           200,   -1,     199},
+        {-200,         200,   -1,     0},
+        {-201,         200,   -2,     199},
+        {10000000000LL, 3200, 3125000, 0},
+        {-10000000001LL, 3200, -3125001, 3199},
+    };
+    bool pass = true;
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int32_t stepsPerRev = (int32_t)cases[i][1];
+        int32_t revolution = revolutionOf(cases[i][0], stepsPerRev);
+        int step = stepInRevolution(cases[i][0], stepsPerRev);
+        if (revolution != cases[i][2] || step != cases[i][3] ||
+            absoluteFrom(revolution, step, stepsPerRev) != cases[i][0]) {
+            pass = false;
+        }
+    }
+
+    volatile int32_t sink = 0;
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_PATH_ITERATIONS; i++) {
+        int64_t position = (int64_t)i * 7919 - 400000000LL;
+        sink += revolutionOf(position, 3200) + stepInRevolution(position, 3200);
+    }
+    uint32_t elapsed = micros() - start;
+
+    report(out, "position_views", BENCH_PATH_ITERATIONS, elapsed, pass);
+    return pass;
+}
+
+// Escolha da resolução automática e salto das faixas de ressonância, feitos
+// a cada atualização da rampa
+bool Benchmark::benchSpeedPlanning(Print& out) {
+    // Casos conhecidos: {velocidade, resolução atual, esperada} (máx. 8000/s, 4 níveis, 75%)
+    static const int shiftCases[][3] = {
+        {0,      0, 0},
+        {8000,   0, 0},
+        {8001,   0, 1},
+        {-20000, 0, 2},
+        {7000,   1, 1},   // Histerese: ainda acima de 6000/s
+        {5000,   1, 0},
+        {200000, 0, 4},   // Limitado ao full step
+    };
+    // Casos conhecidos: {velocidade, objetivo, esperada} com as faixas 100-150 e 300-320
+    static const uint16_t bands[][2] = {{100, 150}, {300, 320}, {0, 0}};
+    static const int bandCases[][3] = {
+        {90,  400, 90},
+        {110, 400, 150},  // Acelerando: salta para o fim
+        {140, 0,   100},  // Freando: salta para o início
+        {120, 130, 150},  // Objetivo dentro da faixa: borda mais próxima
+        {310, 305, 300},
+        {150, 400, 150},
+    };
+    bool pass = true;
+    for (unsigned i = 0; i < sizeof(shiftCases) / sizeof(shiftCases[0]); i++) {
+        if (autoMicrostepShift(shiftCases[i][0], shiftCases[i][1], 4, 8000, 0.75) != shiftCases[i][2]) {
+            pass = false;
+        }
+    }
+    for (unsigned i = 0; i < sizeof(bandCases) / sizeof(bandCases[0]); i++) {
+        if (skipResonanceBands(bandCases[i][0], bandCases[i][1], bands, 3) != bandCases[i][2]) {
+            pass = false;
+        }
+    }
+
+    volatile float sink = 0;
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_PATH_ITERATIONS; i++) {
+        float speed = (float)(i % 40000);
+        sink += autoMicrostepShift(speed, i & 3, 4, 8000, 0.75) +
+                skipResonanceBands(speed / 16, 400, bands, 3);
+    }
+    uint32_t elapsed = micros() - start;
+
+    report(out, "speed_planning", BENCH_PATH_ITERATIONS, elapsed, pass);
+    return pass;
+}
+
+// Codificação de movimentos em símbolos do RMT (StepPulseEncoder), feita na
+// ISR a cada 32 símbolos; ns_per_op é o custo por símbolo
+bool Benchmark::benchStepEncoding(Print& out) {
+    // Casos conhecidos: {passos, velocidade, aceleração}, relógio de 10 MHz e pulso de 2 µs
+    static const uint32_t cases[][3] = {
+        {1,     1000,   1000},
+        {33,    100000, 200000},
+        {5000,  2000,   3000},      // Intervalos longos: símbolos só em nível baixo
+        {20000, 200000, 400000},
+    };
+    uint32_t symbols[32];
+    bool pass = true;
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        StepProfile profile = {cases[i][0], (float)cases[i][1], (float)cases[i][2], 10000000, 20};
+        StepPulseEncoder encoder;
+        encoder.begin(profile);
+        uint32_t total = 0;
+        size_t count;
+        do {
+            uint32_t steps;
+            count = encoder.fill(symbols, 32, steps);
+            total += steps;
+            for (size_t s = 0; s < count; s++) {
+                // Nenhuma duração nula (marcador de fim) no meio do movimento
+                if ((symbols[s] & 0x7FFF) == 0 || (symbols[s] & 0x7FFF0000) == 0) pass = false;
+            }
+        } while (count == 32);
+        if (total != cases[i][0] || !encoder.done()) pass = false;
+    }
+
+    StepProfile profile = {BENCH_ENCODING_STEPS, 200000, 400000, 10000000, 20};
+    StepPulseEncoder encoder;
+    encoder.begin(profile);
+    uint32_t encoded = 0;
+    uint32_t start = micros();
+    size_t count;
+    do {
+        uint32_t steps;
+        count = encoder.fill(symbols, 32, steps);
+        encoded += count;
+    } while (count == 32);
+    uint32_t elapsed = micros() - start;
+
+    report(out, "step_encoding", encoded, elapsed, pass);
+    return pass;
+}
+
+// Desvio das fases relé/passo do ciclo completo, medido durante os ciclos reais
+void Benchmark::benchCyclePhases(Print& out) {
+    static const TimerId phases[] = {TMR_RELAY_OVERRUN, TMR_SETTLE_OVERRUN};
+    static const char* names[] = {"cycle_relay_phase", "cycle_settle_phase"};
+
+    for (int i = 0; i < 2; i++) {
+        TimerStats t = Metrics::getTimer(phases[i]);
+        out.printf("{\"fw\":\"%s\",\"bench\":\"%s\",\"samples\":%u,\"overrun_min_ms\":%u,\"overrun_max_ms\":%u,\"overrun_avg_ms\":%u}\n",
+                   FIRMWARE_VERSION, names[i], t.count, t.count ? t.min : 0, t.max,
+                   Metrics::getTimerAverage(phases[i]));
+    }
+}
+
+// Vazão da decodificação do encoder (leitura dos pinos + máquina de estados)
+void Benchmark::benchEncoderDecode(Print& out, EncoderHandler& encoder) {
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_ENCODER_ITERATIONS; i++) {
+        encoder.update();
+    }
+    uint32_t elapsed = micros() - start;
+
+    // Descarta qualquer evento gerado durante a medição
+    encoder.resetDirection();
+    encoder.isPressed();
+
+    report(out, "encoder_update", BENCH_ENCODER_ITERATIONS, elapsed, true);
+}
+
+// Custo de renderização + transferência de cada tela. caller_us_per_frame é o
+// tempo em que a chamada show*() bloqueia a interface; us_per_frame inclui a
+// espera até o quadro chegar ao painel (iguais com o flush bloqueante).
+// "backend" identifica o painel/barramento, para comparar execuções.
+void Benchmark::benchScreens(Print& out, DisplayManager& display) {
+    static constexpr MenuNode sampleItems[] = {
+        menuAction("Item", NULL), menuAction("Item", NULL), menuAction("Item", NULL), menuAction("Item", NULL)
+    };
+    static constexpr MenuNode sampleMenu = menuSubmenu("Menu", sampleItems);
+    static int sampleValue = 0;
+    static constexpr NumberEditor sampleEditor = {"TEMPO DO RELE", "s", &sampleValue, 50, 5000, 50, 1000, NULL};
+    const uint32_t frameBytes = FRAMEBUFFER_SIZE;
+
+    for (int screen = 0; screen < 8; screen++) {
+        const char* name = "";
+        uint32_t callerTime = 0;
+        // Desenho = tempo do chamador menos o bloqueio em flush()
+        uint64_t flushBefore = Metrics::getTimer(TMR_DISPLAY_FLUSH).total;
+        uint32_t start = micros();
+        for (int i = 0; i < BENCH_SCREEN_ITERATIONS; i++) {
+            uint32_t callStart = micros();
+            switch (screen) {
+                case 0: name = "screen_main_menu";      display.showMainMenu(sampleMenu, i % 4, 0, false); break;
+                case 1: name = "screen_cycle_progress"; display.showCycleProgress(i, 200, 1, 1, 0); break;
+                case 2: name = "screen_positioning_setup"; display.showPositioningSetup(i); break;
+                case 3: name = "screen_positioning";    display.showPositioning(i, -i); break;
+                case 4: name = "screen_microstep_setup"; display.showMicrostepSetup(ActiveDriver::labels, ActiveDriver::MICROSTEP_COUNT, i % ActiveDriver::MICROSTEP_COUNT); break;
+                case 5: name = "screen_relay_time";     display.showNumberEditor(sampleEditor, i * 50); break;
+                case 6: name = "screen_diagnostics";    display.showDiagnostics(); break;
+                case 7: name = "screen_motor_disabled"; display.showMotorDisabled(); break;
+            }
+            callerTime += micros() - callStart;
+
+            // Um quadro por vez: sem isso o flush assíncrono descartaria quadros
+            while (display.flushPending()) {
+                yield();
+            }
+        }
+        uint32_t elapsed = micros() - start;
+        uint32_t flushTime = (uint32_t)(Metrics::getTimer(TMR_DISPLAY_FLUSH).total - flushBefore);
+        uint32_t renderTime = callerTime > flushTime ? callerTime - flushTime : 0;
+
+        out.printf("{\"fw\":\"%s\",\"bench\":\"%s\",\"iterations\":%u,\"total_us\":%u,\"us_per_frame\":%u,\"caller_us_per_frame\":%u,\"render_us_per_frame\":%u,\"bytes_per_frame\":%u,\"backend\":\"%s\"}\n",
+                   FIRMWARE_VERSION, name, BENCH_SCREEN_ITERATIONS, elapsed,
+                   elapsed / BENCH_SCREEN_ITERATIONS, callerTime / BENCH_SCREEN_ITERATIONS,
+                   renderTime / BENCH_SCREEN_ITERATIONS, frameBytes, ActiveDisplayBackend::NAME);
+    }
+}
+
+// Média de um timer do Metrics entre duas leituras
+static uint32_t timerAverageSince(const TimerStats& before, TimerId id) {
+    TimerStats after = Metrics::getTimer(id);
+    uint32_t count = after.count - before.count;
+    return count ? (uint32_t)((after.total - before.total) / count) : 0;
+}
+
+// O mesmo quadro pelo flush bloqueante (o comportamento antes da tarefa de
+// flush) e pelo assíncrono, medido pelos timers do Metrics: flush_us é o
+// bloqueio de quem desenha (TMR_DISPLAY_FLUSH) e transfer_us a transferência,
+// feita pelo próprio chamador ou pela tarefa de flush (TMR_DISPLAY_TRANSFER).
+// Sem tarefa de flush (host, OLED_ASYNC_FLUSH 0) só o modo bloqueante existe.
+void Benchmark::benchFlush(Print& out, DisplayManager& display) {
+    static const bool modes[] = {false, true};
+    for (unsigned m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        display.setAsyncFlush(modes[m]);
+        if (display.isAsyncFlush() != modes[m]) continue;
+
+        TimerStats flushBefore = Metrics::getTimer(TMR_DISPLAY_FLUSH);
+        TimerStats transferBefore = Metrics::getTimer(TMR_DISPLAY_TRANSFER);
+        for (int i = 0; i < BENCH_FLUSH_ITERATIONS; i++) {
+            display.showPositioning(i, -i);
+            while (display.flushPending()) {
+                yield();
+            }
+        }
+        out.printf("{\"fw\":\"%s\",\"bench\":\"display_flush\",\"mode\":\"%s\",\"iterations\":%u,\"flush_us\":%u,\"transfer_us\":%u,\"backend\":\"%s\"}\n",
+                   FIRMWARE_VERSION, modes[m] ? "async" : "blocking", BENCH_FLUSH_ITERATIONS,
+                   timerAverageSince(flushBefore, TMR_DISPLAY_FLUSH),
+                   timerAverageSince(transferBefore, TMR_DISPLAY_TRANSFER), ActiveDisplayBackend::NAME);
+    }
+    display.setAsyncFlush(true);
+}
+
+// Logo comprimido (Assets.h) contra a mesma imagem crua desenhada pela
+// drawBitmap() da Adafruit GFX: bytes na flash e tempo para chegar ao
+// framebuffer. A imagem crua é reconstruída na RAM só para a comparação; pass
+// confere que os dois caminhos geram o mesmo quadro. Usa o framebuffer do
+// display sem enviá-lo ao painel.
+bool Benchmark::benchAssets(Print& out, DisplayManager& display) {
+    const CompressedBitmap& logo = logoBitmap;
+    const uint16_t rowBytes = (logo.width + 7) / 8;
+    const uint32_t rawBytes = rowBytes * logo.height;
+    FrameCanvas* canvas = display.getDisplay();
+    uint8_t* raw = (uint8_t*)calloc(rawBytes, 1);
+    uint8_t* expected = (uint8_t*)malloc(FRAMEBUFFER_SIZE);
+    if (raw == NULL || expected == NULL) {
+        free(raw);
+        free(expected);
+        out.printf("{\"fw\":\"%s\",\"bench\":\"asset_logo\",\"pass\":false}\n", FIRMWARE_VERSION);
+        return false;
+    }
+
+    // Linhas de pixels, bit mais significativo à esquerda (formato da drawBitmap)
+    canvas->clearDisplay();
+    canvas->drawCompressedBitmap(0, 0, logo);
+    const uint8_t* frame = canvas->getBuffer();
+    for (int y = 0; y < logo.height; y++) {
+        for (int x = 0; x < logo.width; x++) {
+            if (frame[(y / 8) * SCREEN_WIDTH + x] & (1 << (y & 7))) {
+                raw[y * rowBytes + x / 8] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+
+    // A drawBitmap só acende pixels: o quadro é limpo uma vez, fora da medição
+    canvas->clearDisplay();
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_ASSET_ITERATIONS; i++) {
+        canvas->drawBitmap(0, 0, raw, logo.width, logo.height, PIXEL_ON);
+    }
+    uint32_t rawTime = micros() - start;
+    memcpy(expected, canvas->getBuffer(), FRAMEBUFFER_SIZE);
+
+    canvas->clearDisplay();
+    start = micros();
+    for (int i = 0; i < BENCH_ASSET_ITERATIONS; i++) {
+        canvas->drawCompressedBitmap(0, 0, logo);
+    }
+    uint32_t packedTime = micros() - start;
+
+    bool pass = memcmp(expected, canvas->getBuffer(), FRAMEBUFFER_SIZE) == 0;
+    out.printf("{\"fw\":\"%s\",\"bench\":\"asset_logo\",\"iterations\":%u,\"raw_bytes\":%u,\"flash_bytes\":%u,"
+               "\"draw_bitmap_ns\":%u,\"decode_blit_ns\":%u,\"pass\":%s}\n",
+               FIRMWARE_VERSION, BENCH_ASSET_ITERATIONS, rawBytes, (uint32_t)(logo.size + sizeof(CompressedBitmap)),
+               (uint32_t)((uint64_t)rawTime * 1000ULL / BENCH_ASSET_ITERATIONS),
+               (uint32_t)((uint64_t)packedTime * 1000ULL / BENCH_ASSET_ITERATIONS), pass ? "true" : "false");
+
+    free(raw);
+    free(expected);
+    return pass;
+}
+
+void Benchmark::runAll(Print& out, DisplayManager& display, EncoderHandler& encoder) {
+    out.println("=== BENCHMARK ===");
+    bool pass = benchShortestPath(out);
+    pass = benchPositionViews(out) && pass;
+    pass = benchSpeedPlanning(out) && pass;
+    pass = benchStepEncoding(out) && pass;
+    benchCyclePhases(out);
+    benchEncoderDecode(out, encoder);
+    benchScreens(out, display);
+    benchFlush(out, display);
+    pass = benchAssets(out, display) && pass;
+    out.printf("{\"fw\":\"%s\",\"bench\":\"summary\",\"pass\":%s}\n", FIRMWARE_VERSION, pass ? "true" : "false");
+}
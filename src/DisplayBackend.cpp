@@ -0,0 +1,201 @@
+#include "DisplayBackend.h"
+
+// ================= Comandos do controlador =================
+
+#define PANEL_PAGES     (SCREEN_HEIGHT / 8)
+
+#if OLED_CONTROLLER == OLED_SH1106
+#define PANEL_COLUMN_OFFSET 2
+#else
+#define PANEL_COLUMN_OFFSET 0
+#endif
+
+const uint8_t* PanelCommands::initSequence(size_t& length) {
+    static const uint8_t sequence[] = {
+        0xAE,               // Display desligado
+        0xD5, 0x80,         // Clock/oscilador
+        0xA8, SCREEN_HEIGHT - 1, // Multiplex
+        0xD3, 0x00,         // Deslocamento vertical
+        0x40,               // Linha inicial 0
+#if OLED_CONTROLLER == OLED_SH1106
+        0xAD, 0x8B,         // Conversor DC-DC ligado
+#else
+        0x8D, 0x14,         // Charge pump ligada
+        0x20, 0x02,         // Endereçamento por página
+#endif
+        0xA1,               // Colunas espelhadas
+        0xC8,               // Varredura de COM invertida
+        0xDA, 0x12,         // Pinos de COM (128x64)
+        0x81, 0xCF,         // Contraste
+        0xD9, 0xF1,         // Pré-carga
+        0xDB, 0x40,         // VCOMH
+        0xA4,               // Exibe o conteúdo da RAM
+        0xA6,               // Normal (não invertido)
+        0xAF                // Display ligado
+    };
+    length = sizeof(sequence);
+    return sequence;
+}
+
+void PanelCommands::pageAddress(int page, uint8_t commands[3]) {
+    commands[0] = 0xB0 | page;
+    commands[1] = 0x00 | (PANEL_COLUMN_OFFSET & 0x0F);
+    commands[2] = 0x10 | (PANEL_COLUMN_OFFSET >> 4);
+}
+
+// ================= I2C =================
+
+#if DISPLAY_BACKEND == DISPLAY_BACKEND_I2C
+
+const char* const I2CDisplayBackend::NAME = OLED_CONTROLLER_NAME "_i2c";
+
+bool I2CDisplayBackend::begin() {
+    i2c_config_t conf;
+    memset(&conf, 0, sizeof(conf));
+    conf.mode = I2C_MODE_MASTER;
+    conf.sda_io_num = OLED_SDA_PIN;
+    conf.scl_io_num = OLED_SCL_PIN;
+    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.master.clk_speed = OLED_I2C_CLOCK_HZ;
+
+    if (i2c_param_config(OLED_I2C_PORT, &conf) != ESP_OK ||
+        i2c_driver_install(OLED_I2C_PORT, I2C_MODE_MASTER, 0, 0, 0) != ESP_OK) {
+        return false;
+    }
+
+    size_t length;
+    const uint8_t* sequence = PanelCommands::initSequence(length);
+    return writeChunk(0x00, sequence, length);
+}
+
+// Uma transação I2C: endereço, byte de controle (0x00 comando, 0x40 dados) e o bloco.
+// A tarefa dorme enquanto a interrupção do I2C alimenta a FIFO.
+bool I2CDisplayBackend::writeChunk(uint8_t control, const uint8_t* data, size_t length) {
+    uint8_t linkBuffer[I2C_LINK_RECOMMENDED_SIZE(2)];
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(linkBuffer, sizeof(linkBuffer));
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (SCREEN_ADDRESS << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(cmd, control, true);
+    i2c_master_write(cmd, data, length, true);
+    i2c_master_stop(cmd);
+    esp_err_t result = i2c_master_cmd_begin(OLED_I2C_PORT, cmd, pdMS_TO_TICKS(OLED_I2C_TIMEOUT_MS));
+    i2c_cmd_link_delete_static(cmd);
+    return result == ESP_OK;
+}
+
+// Uma transação por página (SCREEN_WIDTH bytes), em vez dos blocos de 32
+// bytes limitados pelo buffer do Wire
+bool I2CDisplayBackend::transferFrame(const uint8_t* frame) {
+    uint8_t address[3];
+    for (int page = 0; page < PANEL_PAGES; page++) {
+        PanelCommands::pageAddress(page, address);
+        if (!writeChunk(0x00, address, sizeof(address))) return false;
+        if (!writeChunk(0x40, frame + page * SCREEN_WIDTH, SCREEN_WIDTH)) return false;
+    }
+    return true;
+}
+
+#endif
+
+// ================= SPI =================
+
+#if DISPLAY_BACKEND == DISPLAY_BACKEND_SPI
+
+#include "StepperDriver.h"
+
+#if STEPPER_DRIVER == DRIVER_TMC2209 && \
+    (OLED_SPI_SCK_PIN == TMC_UART_RX_PIN || OLED_SPI_SCK_PIN == TMC_UART_TX_PIN || \
+     OLED_SPI_MOSI_PIN == TMC_UART_RX_PIN || OLED_SPI_MOSI_PIN == TMC_UART_TX_PIN || \
+     OLED_SPI_DC_PIN == TMC_UART_RX_PIN || OLED_SPI_DC_PIN == TMC_UART_TX_PIN || \
+     OLED_SPI_CS_PIN == TMC_UART_RX_PIN || OLED_SPI_CS_PIN == TMC_UART_TX_PIN)
+#error "Pinos OLED_SPI_* em conflito com a UART do TMC2209 (TMC_UART_RX_PIN/TMC_UART_TX_PIN)"
+#endif
+
+const char* const SPIDisplayBackend::NAME = OLED_CONTROLLER_NAME "_spi";
+
+SPIDisplayBackend::SPIDisplayBackend() : spi(OLED_SPI_HOST) {
+}
+
+bool SPIDisplayBackend::begin() {
+    pinMode(OLED_SPI_CS_PIN, OUTPUT);
+    pinMode(OLED_SPI_DC_PIN, OUTPUT);
+    digitalWrite(OLED_SPI_CS_PIN, HIGH);
+    spi.begin(OLED_SPI_SCK_PIN, -1, OLED_SPI_MOSI_PIN, -1);
+
+#if OLED_SPI_RST_PIN >= 0
+    pinMode(OLED_SPI_RST_PIN, OUTPUT);
+    digitalWrite(OLED_SPI_RST_PIN, LOW);
+    delay(1);
+    digitalWrite(OLED_SPI_RST_PIN, HIGH);
+    delay(1);
+#endif
+
+    size_t length;
+    const uint8_t* sequence = PanelCommands::initSequence(length);
+    write(false, sequence, length);
+    return true;
+}
+
+void SPIDisplayBackend::write(bool data, const uint8_t* bytes, size_t length) {
+    spi.beginTransaction(SPISettings(OLED_SPI_CLOCK_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(OLED_SPI_DC_PIN, data ? HIGH : LOW);
+    digitalWrite(OLED_SPI_CS_PIN, LOW);
+    spi.writeBytes(bytes, length);
+    digitalWrite(OLED_SPI_CS_PIN, HIGH);
+    spi.endTransaction();
+}
+
+// Sem confirmação do painel no SPI: a transferência sempre "funciona"
+bool SPIDisplayBackend::transferFrame(const uint8_t* frame) {
+    uint8_t address[3];
+    for (int page = 0; page < PANEL_PAGES; page++) {
+        PanelCommands::pageAddress(page, address);
+        write(false, address, sizeof(address));
+        write(true, frame + page * SCREEN_WIDTH, SCREEN_WIDTH);
+    }
+    return true;
+}
+
+#endif
+
+// ================= Host (arquivos PBM) =================
+
+#if DISPLAY_BACKEND == DISPLAY_BACKEND_HOST
+
+#include <stdio.h>
+
+const char* const HostDisplayBackend::NAME = "host_pbm";
+
+HostDisplayBackend::HostDisplayBackend() {
+    frameNumber = 0;
+}
+
+bool HostDisplayBackend::begin() {
+    return true;
+}
+
+// PBM binário: linhas de pixels, 8 por byte, bit mais significativo à
+// esquerda e 1 = preto. O framebuffer é transposto de colunas por página.
+bool HostDisplayBackend::transferFrame(const uint8_t* frame) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s%05u.pbm", OLED_HOST_FRAME_PREFIX, (unsigned)++frameNumber);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P4\n%d %d\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    uint8_t row[SCREEN_WIDTH / 8];
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        memset(row, 0, sizeof(row));
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            // Pixel aceso no OLED = branco na imagem (bit 0 no PBM)
+            bool lit = frame[(y / 8) * SCREEN_WIDTH + x] & (1 << (y & 7));
+            if (!lit) row[x / 8] |= 0x80 >> (x & 7);
+        }
+        fwrite(row, 1, sizeof(row), file);
+    }
+    fclose(file);
+    return true;
+}
+
+#endif
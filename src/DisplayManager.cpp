@@ -1,38 +1,240 @@
 #include "DisplayManager.h"
+#include "Metrics.h"
+#include "InputTrace.h"
 
-DisplayManager::DisplayManager() : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET) {
+DisplayManager::DisplayManager() {
+    for (int i = 0; i < TPL_COUNT; i++) {
+        templateReady[i] = false;
+    }
+#if DISPLAY_ASYNC_FLUSH
+    sendingFrame = frameBuffers[0];
+    queuedFrame = frameBuffers[1];
+    frameQueued = false;
+    transferActive = false;
+    frameLock = portMUX_INITIALIZER_UNLOCKED;
+    flushTask = NULL;
+    asyncEnabled = true;
+    queuedEvent = 0;
+    sendingEvent = 0;
+    flushDone = false;
+    doneEvent = 0;
+    doneUs = 0;
+#endif
 }
 
 void DisplayManager::begin() {
-    if(!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        Serial.println("Falha na inicialização do display SSD1306");
+    if (!backend.begin()) {
+        Serial.printf("Falha na inicialização do display (%s)\n", ActiveDisplayBackend::NAME);
         return;
     }
     
     display.clearDisplay();
     display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
+    display.setTextColor(PIXEL_ON);
     display.setCursor(0, 0);
-    display.display();    
-    Serial.println("Display inicializado");
+    backend.transferFrame(display.getBuffer());
+
+#if DISPLAY_ASYNC_FLUSH
+    xTaskCreatePinnedToCore(flushTaskEntry, "display", DISPLAY_TASK_STACK, this,
+                            DISPLAY_TASK_PRIORITY, &flushTask, DISPLAY_TASK_CORE);
+    if (flushTask == NULL) {
+        Serial.println("Flush assincrono indisponivel, usando transferencia bloqueante");
+    }
+#endif
+    Serial.printf("Display inicializado (%s)\n", ActiveDisplayBackend::NAME);
+}
+
+// Entrega o framebuffer para o backend. TMR_DISPLAY_FLUSH mede quanto tempo o
+// chamador fica bloqueado; TMR_DISPLAY_TRANSFER mede a transferência em si,
+// que é o custo próprio de cada backend.
+void DisplayManager::flush() {
+    uint32_t start = micros();
+#if DISPLAY_ASYNC_FLUSH
+    if (flushTask != NULL && asyncEnabled) {
+        portENTER_CRITICAL(&frameLock);
+        if (frameQueued) {
+            Metrics::count(CNT_DISPLAY_FRAMES_SKIPPED); // O quadro anterior não chegou a sair
+        }
+        memcpy(queuedFrame, display.getBuffer(), FRAMEBUFFER_SIZE);
+        queuedEvent = InputTrace::currentEvent();
+        frameQueued = true;
+        portEXIT_CRITICAL(&frameLock);
+        xTaskNotifyGive(flushTask);
+
+        Metrics::recordTime(TMR_DISPLAY_FLUSH, micros() - start);
+        Metrics::count(CNT_DISPLAY_FLUSHES);
+        return;
+    }
+#endif
+    backend.transferFrame(display.getBuffer());
+    uint32_t elapsed = micros() - start;
+    Metrics::recordTime(TMR_DISPLAY_TRANSFER, elapsed);
+    Metrics::recordTime(TMR_DISPLAY_FLUSH, elapsed);
+    Metrics::count(CNT_DISPLAY_FLUSHES);
+    InputTrace::markFlush(InputTrace::currentEvent(), InputTrace::now());
+}
+
+void DisplayManager::reportFlushes() {
+#if DISPLAY_ASYNC_FLUSH
+    portENTER_CRITICAL(&frameLock);
+    bool done = flushDone;
+    uint32_t event = doneEvent;
+    uint32_t at = doneUs;
+    flushDone = false;
+    portEXIT_CRITICAL(&frameLock);
+    if (done) InputTrace::markFlush(event, at);
+#endif
+}
+
+bool DisplayManager::flushPending() {
+#if DISPLAY_ASYNC_FLUSH
+    return frameQueued || transferActive;
+#else
+    return false;
+#endif
 }
 
+void DisplayManager::setAsyncFlush(bool enabled) {
+#if DISPLAY_ASYNC_FLUSH
+    while (flushPending()) {
+        vTaskDelay(1);
+    }
+    asyncEnabled = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+bool DisplayManager::isAsyncFlush() {
+#if DISPLAY_ASYNC_FLUSH
+    return flushTask != NULL && asyncEnabled;
+#else
+    return false;
+#endif
+}
+
+#if DISPLAY_ASYNC_FLUSH
+void DisplayManager::flushTaskEntry(void* param) {
+    static_cast<DisplayManager*>(param)->flushTaskLoop();
+}
+
+void DisplayManager::flushTaskLoop() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Envia até não sobrar quadro enfileirado
+        for (;;) {
+            portENTER_CRITICAL(&frameLock);
+            if (!frameQueued) {
+                transferActive = false;
+                portEXIT_CRITICAL(&frameLock);
+                break;
+            }
+            uint8_t* frame = queuedFrame;
+            queuedFrame = sendingFrame;
+            sendingFrame = frame;
+            sendingEvent = queuedEvent;
+            frameQueued = false;
+            transferActive = true;
+            portEXIT_CRITICAL(&frameLock);
+
+            uint32_t start = micros();
+            if (backend.transferFrame(sendingFrame)) {
+                Metrics::recordTime(TMR_DISPLAY_TRANSFER, micros() - start);
+                // Guarda só a primeira conclusão de cada evento até o loop() ler
+                uint32_t at = InputTrace::now();
+                portENTER_CRITICAL(&frameLock);
+                if (!flushDone || doneEvent != sendingEvent) {
+                    flushDone = true;
+                    doneEvent = sendingEvent;
+                    doneUs = at;
+                }
+                portEXIT_CRITICAL(&frameLock);
+            }
+        }
+    }
+}
+#endif
+
 void DisplayManager::clear() {
     display.clearDisplay();
 }
 
-void DisplayManager::showMainMenu(const char* items[], int totalItems, int selectedIndex, int startIndex) {
+// Desenha apenas os elementos fixos (títulos, textos de ajuda, molduras) de uma tela
+void DisplayManager::drawStaticLayer(ScreenTemplate tpl) {
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+
+    switch (tpl) {
+        case TPL_CYCLE_PROGRESS:
+            display.println("=== CICLO ATIVO ===");
+            // Moldura da barra de progresso
+            display.drawRect(14, 35, PROGRESS_BAR_WIDTH + 2, PROGRESS_BAR_HEIGHT + 2, PIXEL_ON);
+            display.setCursor(0, 50);
+            display.println("Clique: Pausar");
+            break;
+
+        case TPL_POSITIONING_SETUP:
+            display.println("=== POSICAO FINAL ===");
+            display.setCursor(0, 48);
+            display.println("Gire: Ajustar Pos.");
+            display.setCursor(0, 56);
+            display.println("Clique: Confirmar");
+            break;
+
+        case TPL_JOG:
+            display.println("=== JOG MANUAL ===");
+            display.setCursor(0, 48);
+            display.println("Gire: Velocidade");
+            display.setCursor(0, 56);
+            display.println("Clique: Parar");
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Carrega a camada estática da tela no framebuffer. Na primeira chamada ela é
+// rasterizada pela Adafruit GFX e guardada; nas seguintes é apenas copiada.
+void DisplayManager::loadTemplate(ScreenTemplate tpl) {
+    uint8_t* buffer = display.getBuffer();
+
+    if (templateReady[tpl]) {
+        memcpy(buffer, templateCache[tpl], FRAMEBUFFER_SIZE);
+        return;
+    }
+
+    clear();
+    drawStaticLayer(tpl);
+    memcpy(templateCache[tpl], buffer, FRAMEBUFFER_SIZE);
+    templateReady[tpl] = true;
+}
+
+void DisplayManager::showMainMenu(const MenuNode& menu, int selectedIndex, int startIndex, bool showBack) {
     clear();
     
     const int yOffset = 18;         // Posição Y inicial para o primeiro item
     const int lineHeight = 10;      // Altura de cada linha do menu
+    int totalItems = menu.childCount + (showBack ? 1 : 0);
 
-    // Desenha o título
+    // Texto de ajuda. As coordenadas Y (48 e 56) funcionam bem para uma tela
+    // de 64 pixels de altura.
     display.setTextSize(1);
+    display.setCursor(0, 48);
+    display.println("Gire: Navegar");
+    display.setCursor(0, 56);
+    display.println("Clique: Selecionar");
+
+    // Título: o nome do nível em maiúsculas
     display.setCursor(0, 0);
-    display.println("===MENU PRINCIPAL===");
+    display.print("===");
+    for (const char* c = menu.label; *c; c++) {
+        display.print((char)toupper(*c));
+    }
+    display.print("===");
     
-    // Desenha os itens do menu que estão na "janela"
+    // Desenha os itens do menu que estão na "janela", numerados pela posição
     for (int i = 0; i < MAX_VISIBLE_MENU_ITEMS; i++) {
         int itemIndex = startIndex + i;
         if (itemIndex >= totalItems) {
@@ -47,7 +249,13 @@ void DisplayManager::showMainMenu(const char* items[], int totalItems, int selec
         } else {
             display.print("  ");
         }
-        display.println(items[itemIndex]);
+        if (itemIndex == menu.childCount) {
+            display.println("< Voltar");
+        } else {
+            const MenuNode& item = menu.children[itemIndex];
+            // Submenus terminam com ">"
+            display.printf("%d. %s%s\n", itemIndex + 1, item.label, item.type == MENU_SUBMENU ? " >" : "");
+        }
     }
 
     // --- Adiciona indicadores de rolagem (setas) ---
@@ -61,64 +269,146 @@ void DisplayManager::showMainMenu(const char* items[], int totalItems, int selec
         display.setCursor(120, 54); // Canto inferior direito
         display.print((char)31); // Caractere ASCII para a seta para baixo (▼)
     }
+    
+    flush();
+}
 
-    // --- ADIÇÃO DO TEXTO DE AJUDA ---
-    // Posiciona o texto de ajuda na parte inferior da tela.
-    // As coordenadas Y (48 e 56) funcionam bem para uma tela de 64 pixels de altura.
-    display.setCursor(0, 48);
-    display.println("Gire: Navegar");
-    display.setCursor(0, 56);
-    display.println("Clique: Selecionar");
-    // --- FIM DA ADIÇÃO ---
+void DisplayManager::showCycleProgress(int currentStep, int totalSteps, int batchIndex, int batchTotal, int partsPerHour) {
+    // Título, moldura da barra e ajuda vêm do template
+    loadTemplate(TPL_CYCLE_PROGRESS);
+    
+    display.setTextSize(1);
+    display.setCursor(0, 8);
+    display.printf("Lote %d/%d  %d p/h\n", batchIndex, batchTotal, partsPerHour);
+    display.setCursor(0, 16);
+    display.printf("Passo: %d/%d\n", currentStep, totalSteps);
+    display.printf("Progresso: %.1f%%\n", (currentStep * 100.0) / totalSteps);
+    
+    // Preenchimento da barra de progresso
+    int progress = (currentStep * PROGRESS_BAR_WIDTH) / totalSteps;
+    display.fillRect(15, 36, progress, PROGRESS_BAR_HEIGHT, PIXEL_ON);
     
-    display.display();
+    flush();
 }
 
-void DisplayManager::showCycleProgress(int currentStep, int totalSteps) {
+void DisplayManager::showCyclePaused(int currentStep, int totalSteps, int batchIndex, int batchTotal, int selectedOption) {
     clear();
     
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("=== CICLO ATIVO ===");
+    display.println("=== CICLO PAUSADO ===");
     display.println();
     
+    display.printf("Lote: %d/%d\n", batchIndex, batchTotal);
     display.printf("Passo: %d/%d\n", currentStep, totalSteps);
-    display.printf("Progresso: %.1f%%\n", (currentStep * 100.0) / totalSteps);
-    
-    // Barra de progresso
-    int barWidth = 100;
-    int barHeight = 8;
-    int progress = (currentStep * barWidth) / totalSteps;
-    
-    display.drawRect(14, 35, barWidth + 2, barHeight + 2, SSD1306_WHITE);
-    display.fillRect(15, 36, progress, barHeight, SSD1306_WHITE);
     
-    display.setCursor(0, 50);
-    display.println("Clique: Cancelar");
+    display.setCursor(0, 40);
+    display.println(selectedOption == 0 ? "> Continuar" : "  Continuar");
+    display.println(selectedOption == 1 ? "> Cancelar" : "  Cancelar");
     
-    display.display();
+    flush();
+}
+
+void DisplayManager::showResumePrompt(const char* cause, int currentStep, int totalSteps, int batchIndex,
+                                      int batchTotal, bool positionUncertain, int selectedOption) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== RETOMAR LOTE ===");
+    display.println(cause);
+
+    display.printf("Lote: %d/%d\n", batchIndex, batchTotal);
+    display.printf("Passo: %d/%d\n", currentStep, totalSteps);
+    if (positionUncertain) {
+        display.println("Posicao incerta!");
+    }
+
+    display.setCursor(0, 48);
+    display.println(selectedOption == 0 ? "> Continuar" : "  Continuar");
+    display.println(selectedOption == 1 ? "> Descartar" : "  Descartar");
+
+    flush();
+}
+
+void DisplayManager::showIndexSetup(int stations) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== INDEXADOR ===");
+
+    display.setTextSize(2);
+    display.setCursor(5, 20);
+    if (stations == 0) {
+        display.print("Tabela");
+    } else {
+        display.printf("%d est.", stations);
+    }
+
+    display.setTextSize(1);
+    display.setCursor(0, 48);
+    display.println("Gire: Estacoes");
+    display.setCursor(0, 56);
+    display.println("Clique: Confirmar");
+
+    flush();
 }
 
-void DisplayManager::showMicrostepSetup(int selectedIndex) {
+void DisplayManager::showMicrostepSetup(const char* const options[], int totalOptions, int selectedIndex) {
     clear();
-    const char* options[] = {"Full Step", "1/2 Step", "1/4 Step", "1/8 Step", "1/16 Step"};
+    const int visibleOptions = 5;
 
     display.setTextSize(1);
     display.setCursor(0, 0);
     display.println("=== MICRO-PASSO ===");
     
-    // Mostra 5 opções na tela
-    for (int i = 0; i < 5; i++) {
+    // Mostra até 5 opções na tela, rolando a janela para manter a selecionada visível
+    int startIndex = 0;
+    if (selectedIndex >= visibleOptions) {
+      startIndex = selectedIndex - visibleOptions + 1;
+    }
+    for (int i = 0; i < visibleOptions && startIndex + i < totalOptions; i++) {
+      int optionIndex = startIndex + i;
       display.setCursor(0, 10 + (i * 10));
-      if (i == selectedIndex) {
+      if (optionIndex == selectedIndex) {
         display.print("> ");
       } else {
         display.print("  ");
       }
-      display.println(options[i]);
+      display.println(options[optionIndex]);
     }
 
-    display.display();
+    flush();
+}
+
+// Um modo por linha e a opção Voltar; o valor em ajuste fica entre colchetes
+void DisplayManager::showSpeedSetup(const char* const modes[], const int rpm[], int totalModes,
+                                    int selectedIndex, bool editing, int maxRpm) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== VELOCIDADES ===");
+
+    for (int i = 0; i <= totalModes; i++) {
+        display.setCursor(0, 12 + (i * 10));
+        display.print(i == selectedIndex ? "> " : "  ");
+        if (i == totalModes) {
+            display.print("Voltar");
+        } else if (editing && i == selectedIndex) {
+            display.printf("%-9s[%3d] RPM", modes[i], rpm[i]);
+        } else {
+            display.printf("%-9s %3d  RPM", modes[i], rpm[i]);
+        }
+    }
+
+    if (maxRpm > 0) {
+        display.setCursor(0, 56);
+        display.printf("Max: %d RPM", maxRpm);
+    }
+
+    flush();
 }
 
 void DisplayManager::showCycleComplete() {
@@ -130,7 +420,7 @@ void DisplayManager::showCycleComplete() {
     display.setCursor(0, 35);
     display.println("COMPLETO!");
     
-    display.display();
+    flush();
 }
 
 // void DisplayManager::showAngleSetup(int angle) {
@@ -169,7 +459,45 @@ void DisplayManager::showPositioning(int targetStep, int stepsToMove) {
     display.println();
     display.println("Posicionando...");
     
-    display.display();
+    flush();
+}
+
+void DisplayManager::showAbsolutePositioningSetup(int32_t revolution, int step, bool editingRevolution) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== POS. ABSOLUTA ===");
+
+    display.setTextSize(2);
+    display.setCursor(0, 14);
+    display.printf("%cV:%d\n", editingRevolution ? '>' : ' ', revolution);
+    display.printf("%cP:%d\n", editingRevolution ? ' ' : '>', step);
+
+    display.setTextSize(1);
+    display.setCursor(0, 56);
+    display.println(editingRevolution ? "Clique: Prox. campo" : "Clique: Mover");
+
+    flush();
+}
+
+void DisplayManager::showAbsolutePositioning(int32_t revolution, int step, int64_t stepsToMove) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== POSICIONANDO ===");
+    display.println();
+
+    display.printf("Alvo: Volta %d\n", revolution);
+    display.printf("      Passo %d\n", step);
+    display.printf("Steps: %lld\n", (long long)(stepsToMove >= 0 ? stepsToMove : -stepsToMove));
+    display.printf("Direcao: %s\n", stepsToMove >= 0 ? "Horario" : "Anti-hor.");
+
+    display.println();
+    display.println("Posicionando...");
+
+    flush();
 }
 
 void DisplayManager::showMotorDisabled() {
@@ -190,83 +518,158 @@ void DisplayManager::showMotorDisabled() {
     display.setCursor(0, 53);
     display.println("Clique: Habilitar");
     
-    display.display();
+    flush();
 }
 
-void DisplayManager::showError(const char* message) {
+void DisplayManager::showEmergencyStop(const char* cause, bool inputActive) {
     clear();
     
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("=== ERRO ===");
-    display.println();
+    display.println("=== EMERGENCIA ===");
     
-    display.println(message);
+    display.setTextSize(2);
+    display.setCursor(28, 15);
+    display.println("PARADA");
+    
+    display.setTextSize(1);
+    display.setCursor(0, 38);
+    display.printf("Causa: %s", cause);
+    display.setCursor(0, 53);
+    display.println(inputActive ? "Libere a entrada" : "Clique: Rearmar");
     
-    display.display();
+    flush();
 }
 
-void DisplayManager::showRelayTimeSetup(int timeMs) {
+void DisplayManager::showError(const char* message) {
     clear();
     
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("=== TEMPO DO RELE ===");
+    display.println("=== ERRO ===");
     display.println();
     
-    // Mostra o tempo formatado em segundos
-    display.setTextSize(2);
-    display.setCursor(15, 20);
-    display.printf("%.2f s", timeMs / 1000.0);
-    
-    // Instruções
-    display.setTextSize(1);
-    display.setCursor(0, 45);
-    display.println("Gire: Ajustar");
-    display.println("Clique: Confirmar");
+    display.println(message);
     
-    display.display();
+    flush();
 }
 
-void DisplayManager::showRelayOffTimeSetup(int timeMs) {
+// Tela dos editores numéricos da árvore de menus (tempos do relé, lote...)
+void DisplayManager::showNumberEditor(const NumberEditor& editor, int value) {
     clear();
-    
+
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("=== TEMPO RELE DESL. ==="); // Título da nova tela
-    display.println();
-    
-    display.setTextSize(2);
-    display.setCursor(15, 20);
-    display.printf("%.2f s", timeMs / 1000.0);
-    
-    display.setTextSize(1);
+    display.printf("=== %s ===", editor.title);
     display.setCursor(0, 45);
     display.println("Gire: Ajustar");
     display.println("Clique: Confirmar");
     
-    display.display();
+    display.setTextSize(2);
+    display.setCursor(15, 20);
+    if (editor.divisor > 1) {
+        display.printf("%.2f %s", (float)value / editor.divisor, editor.unit);
+    } else {
+        display.printf("%d %s", value, editor.unit);
+    }
+    
+    flush();
 }
 
 void DisplayManager::showPositioningSetup(int steps) {
+    loadTemplate(TPL_POSITIONING_SETUP);
+    
+    display.setTextSize(2);
+    display.setCursor(5, 20);
+    display.printf("Passo: %d", steps);
+    
+    flush();
+}
+
+void DisplayManager::showDiagnostics() {
     clear();
     
     display.setTextSize(1);
     display.setCursor(0, 0);
-    display.println("=== POSICAO FINAL ===");
+    display.println("=== DIAGNOSTICO ===");
+    display.setCursor(0, 56);
+    display.println("Clique: Voltar");
+    display.setCursor(0, 8);
+    display.printf("Loop: %u/%u us\n",
+                   Metrics::getTimerAverage(TMR_LOOP),
+                   Metrics::getTimer(TMR_LOOP).max);
+    display.printf("Flush: %u/%u us\n",
+                   Metrics::getTimerAverage(TMR_DISPLAY_FLUSH),
+                   Metrics::getTimerAverage(TMR_DISPLAY_TRANSFER));
+    display.printf("Passos/s: %d\n", Metrics::getGauge(GAUGE_STEP_RATE));
+    display.printf("Encoder: %u/%u perd.\n",
+                   Metrics::getCounter(CNT_ENCODER_DETENTS),
+                   Metrics::getCounter(CNT_ENCODER_DROPPED));
+    display.printf("Ciclos: %u ok/%u canc.\n",
+                   Metrics::getCounter(CNT_CYCLES_COMPLETED),
+                   Metrics::getCounter(CNT_CYCLES_CANCELLED));
+    
+    flush();
+}
+
+// Resumo do histórico gravado na flash (todos os boots presentes no log)
+void DisplayManager::showHistoryStats(const HistoryStats& stats) {
+    clear();
+
+    display.setTextSize(1);
+    display.setCursor(0, 0);
+    display.println("=== HISTORICO ===");
+
+    if (!stats.available) {
+        display.setCursor(0, 24);
+        display.println("Sem particao");
+    } else {
+        uint32_t completed = stats.outcomes[HIST_COMPLETED];
+        display.setCursor(0, 8);
+        display.printf("Reg: %u/%u\n", (unsigned)stats.records, (unsigned)stats.capacity);
+        display.printf("Ok %u Can %u Em %u\n", (unsigned)completed,
+                       (unsigned)stats.outcomes[HIST_CANCELLED],
+                       (unsigned)stats.outcomes[HIST_EMERGENCY]);
+        display.printf("Media: %.1f s\n",
+                       completed ? stats.completedDurationMs / 1000.0 / completed : 0.0);
+        // Média, por ciclo, do maior atraso de cada fase
+        uint32_t records = stats.records ? stats.records : 1;
+        display.printf("Atraso: %u/%u ms\n",
+                       (unsigned)(stats.relayOverrunMs / records),
+                       (unsigned)(stats.settleOverrunMs / records));
+        display.printf("Boot %u Perd. %u\n", (unsigned)stats.boot, (unsigned)stats.dropped);
+    }
+
+    display.setCursor(0, 56);
+    display.println("Clique: Voltar");
+
+    flush();
+}
+
+void DisplayManager::showJog(int position, int stepsPerSec, const char* resolution) {
+    loadTemplate(TPL_JOG);
     
     display.setTextSize(2);
-    display.setCursor(5, 20);
-    display.printf("Passo: %d", steps);
+    display.setCursor(5, 14);
+    display.printf("Pos: %d", position);
     
     display.setTextSize(1);
-    display.setCursor(0, 48);
-    display.println("Gire: Ajustar Pos.");
-    display.setCursor(0, 56);
-    display.println("Clique: Confirmar");
-    display.display();
+    display.setCursor(0, 36);
+    if (resolution) {
+        display.printf("Vel:%d %s", stepsPerSec, resolution); // Micro-passo automático
+    } else {
+        display.printf("Vel: %d passos/s", stepsPerSec);
+    }
+    
+    flush();
+}
+
+void DisplayManager::showBitmap(const CompressedBitmap& bitmap) {
+    display.clearDisplay();
+    display.drawCompressedBitmap((SCREEN_WIDTH - bitmap.width) / 2, (SCREEN_HEIGHT - bitmap.height) / 2, bitmap);
+    flush();
 }
 
-Adafruit_SSD1306* DisplayManager::getDisplay() {
+FrameCanvas* DisplayManager::getDisplay() {
     return &display;
 }
\ No newline at end of file
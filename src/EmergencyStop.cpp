@@ -0,0 +1,159 @@
+#include "EmergencyStop.h"
+#include "MotionTask.h"
+#include "PinTrace.h"
+#include <esp_system.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+
+#define ESTOP_TEST_TRIALS      20
+#define ESTOP_TEST_TIMEOUT_US  1000
+#define ESTOP_TEST_REARM_MS    100  // Espera pela tarefa de movimento a cada rearme
+
+volatile bool EmergencyStop::tripped = false;
+volatile uint8_t EmergencyStop::cause = ESTOP_NONE;
+volatile uint32_t EmergencyStop::handlerCycles = 0;
+volatile uint32_t EmergencyStop::cutCycles = 0;
+portMUX_TYPE EmergencyStop::outputLock = portMUX_INITIALIZER_UNLOCKED;
+
+void EmergencyStop::begin() {
+    pinMode(ESTOP_PIN, INPUT_PULLUP);
+    // Serviço de ISR em IRAM, atendido com o cache desligado. Instalado aqui
+    // primeiro (antes de qualquer attachInterrupt()), vale para todo o GPIO.
+    gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    gpio_set_intr_type((gpio_num_t)ESTOP_PIN, ESTOP_ACTIVE_LEVEL == HIGH ? GPIO_INTR_POSEDGE : GPIO_INTR_NEGEDGE);
+    gpio_isr_handler_add((gpio_num_t)ESTOP_PIN, onInterrupt, NULL);
+
+    // Um travamento da tarefa de movimento não pode virar um reinício que
+    // volta a energizar a máquina sozinho
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_TASK_WDT || reason == ESP_RST_INT_WDT || reason == ESP_RST_WDT) {
+        trip(ESTOP_WATCHDOG);
+        Serial.println("EMERGENCIA: reinicio pelo watchdog");
+    } else if (inputActive()) {
+        trip(ESTOP_INPUT);
+        Serial.println("EMERGENCIA: entrada acionada na partida");
+    }
+}
+
+const char* EmergencyStop::causeName(uint8_t reason) {
+    switch (reason) {
+        case ESTOP_INPUT:    return "Entrada";
+        case ESTOP_WATCHDOG: return "Watchdog";
+        case ESTOP_BROWNOUT: return "Tensao";
+        default:             return "-";
+    }
+}
+
+bool EmergencyStop::inputActive() {
+    return digitalRead(ESTOP_PIN) == ESTOP_ACTIVE_LEVEL;
+}
+
+void IRAM_ATTR EmergencyStop::onInterrupt(void* arg) {
+    (void)arg;
+    trip(ESTOP_INPUT);
+}
+
+// Saídas primeiro, contabilidade depois: nada aqui espera por outra tarefa.
+// Só código em IRAM: as bordas entram no traço (PinTrace) quando a tarefa de
+// movimento trata a parada e reescreve ENABLE e relé.
+void IRAM_ATTR EmergencyStop::trip(uint8_t reason) {
+    uint32_t start = ESP.getCycleCount();
+    portENTER_CRITICAL_ISR(&outputLock);
+    gpio_ll_set_level(&GPIO, (gpio_num_t)ENABLE_PIN, HIGH);  // HIGH = driver desabilitado
+    gpio_ll_set_level(&GPIO, (gpio_num_t)RELAY_PIN, HIGH);   // Relé ativo em LOW
+    cutCycles = ESP.getCycleCount();
+    if (!tripped) {
+        tripped = true;
+        cause = reason;
+        handlerCycles = cutCycles - start;
+    }
+    portEXIT_CRITICAL_ISR(&outputLock);
+}
+
+bool EmergencyStop::reset() {
+    if (inputActive()) return false;
+    portENTER_CRITICAL(&outputLock);
+    tripped = false;
+    cause = ESTOP_NONE;
+    portEXIT_CRITICAL(&outputLock);
+    Serial.println("Parada de emergencia rearmada");
+    return true;
+}
+
+bool EmergencyStop::guardedWrite(uint8_t pin, uint8_t level) {
+    portENTER_CRITICAL(&outputLock);
+    bool allowed = !tripped;
+    if (allowed) {
+        tracedWrite(pin, level);
+    }
+    portEXIT_CRITICAL(&outputLock);
+    return allowed;
+}
+
+uint32_t EmergencyStop::lastHandlerNs() {
+    return handlerCycles * 1000 / ESP.getCpuFreqMHz();
+}
+
+#if ESTOP_TEST_PIN >= 0
+// Espera o instantâneo da tarefa de movimento refletir o estado pedido
+static bool waitForMotion(MotionTask& motion, bool emergencyStop) {
+    uint32_t start = millis();
+    for (;;) {
+        MotionStatus s = motion.getStatus();
+        if (motion.isCaughtUp(s) && s.emergencyStop == emergencyStop) return true;
+        if (millis() - start >= ESTOP_TEST_REARM_MS) return false;
+        delay(1);
+    }
+}
+#endif
+
+// Aciona a entrada pelo ESTOP_TEST_PIN e mede, pelo contador de ciclos do
+// próprio núcleo, o tempo até a ISR cortar as saídas. Inclui a latência de
+// entrada da interrupção; não inclui a propagação elétrica até o driver.
+void EmergencyStop::runLatencyTest(Print& out, MotionTask& motion) {
+#if ESTOP_TEST_PIN >= 0
+    uint32_t cyclesPerUs = ESP.getCpuFreqMHz();
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+    int samples = 0;
+
+    pinMode(ESTOP_TEST_PIN, OUTPUT);
+    digitalWrite(ESTOP_TEST_PIN, !ESTOP_ACTIVE_LEVEL);
+    delay(10);
+
+    for (int i = 0; i < ESTOP_TEST_TRIALS; i++) {
+        // A tarefa trata o acionamento anterior (abortando o que estiver
+        // fazendo) e só então libera a trava, como no rearme pela tela
+        if (tripped && !(waitForMotion(motion, true) && motion.resetEmergencyStop() &&
+                         waitForMotion(motion, false))) {
+            break;
+        }
+        uint32_t start = ESP.getCycleCount();
+        digitalWrite(ESTOP_TEST_PIN, ESTOP_ACTIVE_LEVEL);
+        uint32_t waitStart = micros();
+        while (!tripped && micros() - waitStart < ESTOP_TEST_TIMEOUT_US) {
+        }
+        if (!tripped) break;
+
+        uint32_t cycles = cutCycles - start;
+        if (cycles > maxCycles) maxCycles = cycles;
+        totalCycles += cycles;
+        samples++;
+
+        digitalWrite(ESTOP_TEST_PIN, !ESTOP_ACTIVE_LEVEL);
+        delay(5);
+    }
+
+    uint32_t maxUs = (maxCycles + cyclesPerUs - 1) / cyclesPerUs;
+    bool pass = samples == ESTOP_TEST_TRIALS && maxUs <= ESTOP_MAX_LATENCY_US;
+    out.printf("{\"fw\":\"%s\",\"bench\":\"estop_latency\",\"samples\":%d,\"max_us\":%u,\"avg_ns\":%u,\"handler_ns\":%u,\"limit_us\":%d,\"pass\":%s}\n",
+               FIRMWARE_VERSION, samples, maxUs,
+               samples ? (uint32_t)(totalCycles * 1000 / cyclesPerUs / samples) : 0,
+               lastHandlerNs(), ESTOP_MAX_LATENCY_US, pass ? "true" : "false");
+    // A trava do último acionamento fica ativa: quem chamou rearma pelo
+    // caminho normal, depois que a tarefa de movimento tratou a parada
+#else
+    (void)motion;
+    out.println("Teste de latencia indisponivel: defina ESTOP_TEST_PIN em config.h");
+#endif
+}
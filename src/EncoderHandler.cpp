@@ -1,10 +1,14 @@
 #include "EncoderHandler.h"
+#include "Metrics.h"
+#include "InputTrace.h"
 
 EncoderHandler::EncoderHandler() {
     direction = 0;
     buttonPressed = false;
     lastButtonState = HIGH;
     lastDebounceTime = 0;
+    pulseCounter = 0;
+    lastActivityTime = 0;
 }
 
 void EncoderHandler::begin() {
@@ -18,10 +22,18 @@ void EncoderHandler::begin() {
 }
 
 void EncoderHandler::update() {
+    // Durante a reprodução, os eventos vêm da gravação em vez dos pinos
+    if (InputTrace::isReplaying()) {
+        updateFromReplay();
+        return;
+    }
+
     // --- Lógica de Rotação (Inalterada) ---
     int currentClkState = digitalRead(ENCODER_CLK);
     
     if (currentClkState != lastClkState) {
+        lastActivityTime = millis();
+
         // Incrementa ou decrementa o contador de pulsos a cada pulso detectado
         if (digitalRead(ENCODER_DT) != currentClkState) {
             pulseCounter++; // Sentido horário
@@ -31,12 +43,18 @@ void EncoderHandler::update() {
 
         // Verifica se o contador atingiu o limiar definido em config.h
         if (abs(pulseCounter) >= ENCODER_PULSES_PER_STEP) {
-            // Se atingiu, define a direção do passo e zera o contador
+            // Se atingiu, define a direção do passo e zera o contador.
+            // Um passo anterior ainda não lido é perdido (sobrescrito).
+            if (direction != 0) {
+                Metrics::count(CNT_ENCODER_DROPPED);
+            }
             if (pulseCounter > 0) {
                 direction = 1;
+                InputTrace::record(INPUT_CW);
                 Serial.println("Encoder: PASSO HORÁRIO");
             } else {
                 direction = -1;
+                InputTrace::record(INPUT_CCW);
                 Serial.println("Encoder: PASSO ANTI-HORÁRIO");
             }
             pulseCounter = 0; // Zera o contador para o próximo passo
@@ -52,6 +70,7 @@ void EncoderHandler::update() {
     // Se a leitura atual for diferente da anterior (ruído ou ação real), reinicie o timer.
     if (buttonReading != lastButtonState) {
         lastDebounceTime = millis();
+        lastActivityTime = lastDebounceTime;
     }
 
     // Se o tempo desde a última mudança for maior que o debounce...
@@ -64,6 +83,8 @@ void EncoderHandler::update() {
             if (debouncedButtonState == LOW) {
                 Serial.println("Botão PRESSIONADO");
                 buttonPressed = true;
+                Metrics::count(CNT_BUTTON_PRESSES);
+                InputTrace::record(INPUT_PRESS);
             }
         }
     }
@@ -72,9 +93,31 @@ void EncoderHandler::update() {
     lastButtonState = buttonReading;
 }
 
+// Entrega os eventos gravados cujo instante já chegou
+void EncoderHandler::updateFromReplay() {
+    int event;
+    while ((event = InputTrace::nextDueEvent()) >= 0) {
+        lastActivityTime = millis();
+        switch (event) {
+            case INPUT_CW:
+                direction = 1;
+                break;
+            case INPUT_CCW:
+                direction = -1;
+                break;
+            case INPUT_PRESS:
+                buttonPressed = true;
+                break;
+        }
+    }
+}
+
 int EncoderHandler::getDirection() {
     int currentDirection = direction;
     direction = 0; // Reset após leitura
+    if (currentDirection != 0) {
+        Metrics::count(CNT_ENCODER_DETENTS);
+    }
     return currentDirection;
 }
 
@@ -88,4 +131,8 @@ bool EncoderHandler::isPressed() {
 
 void EncoderHandler::resetDirection() {
     direction = 0;
+}
+
+unsigned long EncoderHandler::getLastActivityTime() {
+    return lastActivityTime;
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "FrameCanvas.h"
+
+FrameCanvas::FrameCanvas() : Adafruit_GFX(SCREEN_WIDTH, SCREEN_HEIGHT) {
+    memset(buffer, 0, sizeof(buffer));
+}
+
+void FrameCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+
+    uint8_t& column = buffer[(y / 8) * SCREEN_WIDTH + x];
+    uint8_t bit = 1 << (y & 7);
+    if (color == PIXEL_ON) {
+        column |= bit;
+    } else {
+        column &= ~bit;
+    }
+}
+
+void FrameCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (y < 0 || y >= SCREEN_HEIGHT) return;
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+    if (w <= 0) return;
+
+    uint8_t* column = &buffer[(y / 8) * SCREEN_WIDTH + x];
+    uint8_t bit = 1 << (y & 7);
+    while (w--) {
+        if (color == PIXEL_ON) {
+            *column++ |= bit;
+        } else {
+            *column++ &= ~bit;
+        }
+    }
+}
+
+// Uma linha vertical ocupa no máximo um byte por página
+void FrameCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (x < 0 || x >= SCREEN_WIDTH) return;
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+    if (h <= 0) return;
+
+    int16_t end = y + h;
+    while (y < end) {
+        int16_t pageEnd = min((int16_t)((y | 7) + 1), end);
+        uint8_t mask = (uint8_t)((0xFF << (y & 7)) & (0xFF >> (8 - (pageEnd - (y & ~7)))));
+        uint8_t& column = buffer[(y / 8) * SCREEN_WIDTH + x];
+        if (color == PIXEL_ON) {
+            column |= mask;
+        } else {
+            column &= ~mask;
+        }
+        y = pageEnd;
+    }
+}
+
+void FrameCanvas::fillScreen(uint16_t color) {
+    memset(buffer, color == PIXEL_ON ? 0xFF : 0x00, sizeof(buffer));
+}
+
+// ================= Imagens comprimidas =================
+
+// Uma coluna de 8 linhas da imagem: cai inteira numa página quando y é
+// múltiplo de 8, ou dividida entre duas páginas vizinhas
+inline void FrameCanvas::writeColumn(int16_t x, int16_t page, uint8_t shift, uint8_t bits, uint8_t mask) {
+    if (x < 0 || x >= SCREEN_WIDTH) return;
+    if (page >= 0 && page < SCREEN_HEIGHT / 8) {
+        uint8_t& column = buffer[page * SCREEN_WIDTH + x];
+        column = (column & ~(uint8_t)(mask << shift)) | (uint8_t)(bits << shift);
+    }
+    if (shift && page + 1 >= 0 && page + 1 < SCREEN_HEIGHT / 8) {
+        uint8_t& column = buffer[(page + 1) * SCREEN_WIDTH + x];
+        column = (column & ~(uint8_t)(mask >> (8 - shift))) | (uint8_t)(bits >> (8 - shift));
+    }
+}
+
+// Decodifica o fluxo de CompressedAsset.h direto no framebuffer, sem buffer
+// intermediário: o estado é só a posição e, com delta, o último byte
+void FrameCanvas::drawPacked(int16_t x, int16_t y, uint8_t width, uint8_t height, uint8_t encoding,
+                             const uint8_t* data) {
+    if (width == 0 || height == 0) return;
+    uint8_t shift = y & 7;
+    int16_t firstPage = (y - shift) / 8;    // Arredonda para baixo com y negativo
+    int16_t pages = (height + 7) / 8;
+    bool delta = encoding == ASSET_RLE_DELTA;
+
+    int16_t column = 0;
+    int16_t page = 0;
+    uint8_t previous = 0;
+    uint8_t mask = height >= 8 ? 0xFF : (1 << height) - 1;
+    while (page < pages) {
+        uint8_t control = pgm_read_byte(data++);
+        bool repeat = control & 0x80;
+        uint8_t count = repeat ? (control & 0x7F) + 3 : control + 1;
+        uint8_t value = repeat ? pgm_read_byte(data++) : 0;
+
+        while (count-- && page < pages) {
+            uint8_t bits = repeat ? value : pgm_read_byte(data++);
+            if (delta) {
+                bits ^= previous;
+                previous = bits;
+            }
+            writeColumn(x + column, firstPage + page, shift, bits, mask);
+
+            if (++column == width) {
+                column = 0;
+                previous = 0;
+                page++;
+                int16_t rows = height - page * 8;
+                mask = rows >= 8 ? 0xFF : (1 << rows) - 1;
+            }
+        }
+    }
+}
+
+void FrameCanvas::drawCompressedBitmap(int16_t x, int16_t y, const CompressedBitmap& bitmap) {
+    drawPacked(x, y, bitmap.width, bitmap.height, bitmap.encoding, bitmap.data);
+}
+
+// Códigos fora da fonte só avançam
+int16_t FrameCanvas::drawGlyph(int16_t x, int16_t y, const CompressedFont& font, char c) {
+    uint8_t index = (uint8_t)c - font.first;
+    if ((uint8_t)c >= font.first && index < font.count) {
+        uint16_t offset = pgm_read_word(&font.offsets[index]);
+        drawPacked(x, y, font.width, font.height, font.encoding, font.data + offset);
+    }
+    return font.width;
+}
+
+void FrameCanvas::drawCompressedText(int16_t x, int16_t y, const CompressedFont& font, const char* text) {
+    while (*text && x < SCREEN_WIDTH) {
+        x += drawGlyph(x, y, font, *text++);
+    }
+}
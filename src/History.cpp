@@ -0,0 +1,297 @@
+#include "History.h"
+
+#define HISTORY_MAGIC       0x31545348UL   // "HST1"
+#define HISTORY_CHUNK       16             // Registros lidos por vez nas varreduras
+
+#if HISTORY_SPARE_SECTORS * HISTORY_RECORDS_PER_SECTOR < BATCH_MAX_CYCLES
+#error "HISTORY_SPARE_SECTORS nao cobre um lote de BATCH_MAX_CYCLES ciclos"
+#endif
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t inverted;      // ~sequence: cabeçalho inteiro gravado
+    uint32_t reserved;
+};
+
+const esp_partition_t* History::partition = NULL;
+uint32_t History::sectorCount = 0;
+uint32_t History::headSector = 0;
+uint32_t History::headSlot = 0;
+uint32_t History::headSequence = 0;
+uint32_t History::sparesReady = 0;
+volatile bool History::exporting = false;
+HistoryStats History::stats;
+portMUX_TYPE History::statsLock = portMUX_INITIALIZER_UNLOCKED;
+
+uint8_t History::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+HistoryRecord History::makeRecord(uint32_t startS, uint32_t durationMs, uint16_t length,
+                                  HistoryMode mode, HistoryOutcome outcome,
+                                  uint32_t relayOverrunMs, uint32_t settleOverrunMs) {
+    HistoryRecord record;
+    record.startS = startS;
+    record.durationMs = durationMs;
+    record.boot = stats.boot;
+    record.length = length;
+    record.flags = (uint8_t)(mode | (outcome << 2));
+    record.relayOverrunMs = (uint8_t)min(relayOverrunMs, (uint32_t)255);
+    record.settleOverrunMs = (uint8_t)min(settleOverrunMs, (uint32_t)255);
+    record.crc = crc8((const uint8_t*)&record, HISTORY_RECORD_SIZE - 1);
+    return record;
+}
+
+// 1 = válido, 0 = livre (apagado), -1 = corrompido (gravação interrompida)
+int History::classify(const HistoryRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    bool blank = true;
+    for (int i = 0; i < HISTORY_RECORD_SIZE; i++) {
+        if (bytes[i] != 0xFF) {
+            blank = false;
+            break;
+        }
+    }
+    if (blank) return 0;
+    return crc8(bytes, HISTORY_RECORD_SIZE - 1) == record.crc ? 1 : -1;
+}
+
+// O slot 0 do setor é o cabeçalho; os registros começam no slot seguinte
+size_t History::slotOffset(uint32_t sector, uint32_t slot) {
+    return (size_t)sector * HISTORY_SECTOR_SIZE + (slot + 1) * HISTORY_RECORD_SIZE;
+}
+
+bool History::readChunk(uint32_t sector, uint32_t firstSlot, HistoryRecord* records, uint32_t count) {
+    return esp_partition_read(partition, slotOffset(sector, firstSlot), records,
+                              count * HISTORY_RECORD_SIZE) == ESP_OK;
+}
+
+bool History::readHeader(uint32_t sector, uint32_t& sequence) {
+    SectorHeader header;
+    if (esp_partition_read(partition, (size_t)sector * HISTORY_SECTOR_SIZE, &header, sizeof(header)) != ESP_OK) {
+        return false;
+    }
+    if (header.magic != HISTORY_MAGIC || header.inverted != ~header.sequence) return false;
+    sequence = header.sequence;
+    return true;
+}
+
+bool History::writeHeader(uint32_t sector, uint32_t sequence) {
+    SectorHeader header;
+    header.magic = HISTORY_MAGIC;
+    header.sequence = sequence;
+    header.inverted = ~sequence;
+    header.reserved = 0xFFFFFFFF;
+    return esp_partition_write(partition, (size_t)sector * HISTORY_SECTOR_SIZE, &header, sizeof(header)) == ESP_OK;
+}
+
+// Ler é barato; só apaga (e gasta um ciclo de escrita) o que não está em branco
+bool History::sectorBlank(uint32_t sector) {
+    uint32_t words[64];
+    for (size_t offset = 0; offset < HISTORY_SECTOR_SIZE; offset += sizeof(words)) {
+        if (esp_partition_read(partition, (size_t)sector * HISTORY_SECTOR_SIZE + offset, words, sizeof(words)) != ESP_OK) {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+            if (words[i] != 0xFFFFFFFF) return false;
+        }
+    }
+    return true;
+}
+
+void History::accumulate(const HistoryRecord& record, int sign) {
+    portENTER_CRITICAL(&statsLock);
+    uint8_t outcome = outcomeOf(record);
+    stats.records += sign;
+    if (outcome <= HIST_EMERGENCY) stats.outcomes[outcome] += sign;
+    if (outcome == HIST_COMPLETED) stats.completedDurationMs += (int64_t)sign * record.durationMs;
+    stats.relayOverrunMs += sign * record.relayOverrunMs;
+    stats.settleOverrunMs += sign * record.settleOverrunMs;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void History::countDropped() {
+    portENTER_CRITICAL(&statsLock);
+    stats.dropped++;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+// Soma (sign = 1) ou retira (sign = -1) do resumo os registros de um setor.
+// Retorna o maior número de boot encontrado.
+uint16_t History::scanSector(uint32_t sector, int sign) {
+    HistoryRecord chunk[HISTORY_CHUNK];
+    uint16_t lastBoot = 0;
+    for (uint32_t slot = 0; slot < HISTORY_RECORDS_PER_SECTOR; slot += HISTORY_CHUNK) {
+        uint32_t count = min((uint32_t)HISTORY_CHUNK, (uint32_t)HISTORY_RECORDS_PER_SECTOR - slot);
+        if (!readChunk(sector, slot, chunk, count)) return lastBoot;
+        for (uint32_t i = 0; i < count; i++) {
+            int state = classify(chunk[i]);
+            if (state == 0) return lastBoot;    // Acréscimos param no primeiro livre
+            if (state < 0) continue;
+            accumulate(chunk[i], sign);
+            if (chunk[i].boot > lastBoot) lastBoot = chunk[i].boot;
+        }
+    }
+    return lastBoot;
+}
+
+bool History::begin() {
+    memset(&stats, 0, sizeof(stats));
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         HISTORY_PARTITION_LABEL);
+    if (partition == NULL) {
+        Serial.println("Particao de historico nao encontrada");
+        return false;
+    }
+    sectorCount = partition->size / HISTORY_SECTOR_SIZE;
+    if (sectorCount < HISTORY_SPARE_SECTORS + 2) {
+        Serial.println("Particao de historico pequena demais");
+        partition = NULL;
+        return false;
+    }
+
+    // O setor com a maior sequência é o que está em gravação
+    bool found = false;
+    for (uint32_t sector = 0; sector < sectorCount; sector++) {
+        uint32_t sequence;
+        if (readHeader(sector, sequence) && (!found || sequence > headSequence)) {
+            found = true;
+            headSector = sector;
+            headSequence = sequence;
+        }
+    }
+    if (!found) {
+        // Log novo (ou ilegível): começa no setor 0
+        headSector = 0;
+        headSequence = 1;
+        if (!sectorBlank(0)) esp_partition_erase_range(partition, 0, HISTORY_SECTOR_SIZE);
+        writeHeader(0, headSequence);
+    }
+
+    // Primeiro livre depois do último registro gravado no setor atual
+    HistoryRecord record;
+    headSlot = 0;
+    for (int32_t slot = HISTORY_RECORDS_PER_SECTOR - 1; slot >= 0; slot--) {
+        if (readChunk(headSector, slot, &record, 1) && classify(record) != 0) {
+            headSlot = slot + 1;
+            break;
+        }
+    }
+
+    // Os setores à frente são preparados agora, antes do resumo, para que os
+    // registros antigos que eles continham não entrem na contagem
+    sparesReady = 0;
+    for (int i = 0; i < HISTORY_SPARE_SECTORS; i++) {
+        maintain();
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    stats.available = true;
+    stats.capacity = (sectorCount - HISTORY_SPARE_SECTORS) * HISTORY_RECORDS_PER_SECTOR;
+    uint16_t lastBoot = 0;
+    for (uint32_t sector = 0; sector < sectorCount; sector++) {
+        uint32_t sequence;
+        if (!readHeader(sector, sequence)) continue;
+        uint16_t boot = scanSector(sector, 1);
+        if (boot > lastBoot) lastBoot = boot;
+    }
+    stats.boot = lastBoot + 1;
+
+    Serial.printf("Historico: %u registros de %u, boot %u\n",
+                  (unsigned)stats.records, (unsigned)stats.capacity, (unsigned)stats.boot);
+    return true;
+}
+
+bool History::maintain() {
+    if (partition == NULL || exporting || sparesReady >= HISTORY_SPARE_SECTORS) return false;
+
+    uint32_t sector = (headSector + 1 + sparesReady) % sectorCount;
+    uint32_t sequence;
+    if (readHeader(sector, sequence)) {
+        scanSector(sector, -1);     // Os registros mais antigos saem do log
+    }
+    if (!sectorBlank(sector)) {
+        esp_partition_erase_range(partition, (size_t)sector * HISTORY_SECTOR_SIZE, HISTORY_SECTOR_SIZE);
+    }
+    sparesReady++;
+    return true;
+}
+
+// Uma escrita de 16 bytes (mais o cabeçalho ao entrar num setor novo)
+bool History::append(const HistoryRecord& record) {
+    if (partition == NULL) return false;
+
+    if (headSlot >= HISTORY_RECORDS_PER_SECTOR) {
+        if (sparesReady == 0) {
+            countDropped();
+            return false;
+        }
+        headSector = nextSector(headSector);
+        headSequence++;
+        sparesReady--;
+        headSlot = 0;
+        writeHeader(headSector, headSequence);
+    }
+
+    if (esp_partition_write(partition, slotOffset(headSector, headSlot), &record, HISTORY_RECORD_SIZE) != ESP_OK) {
+        countDropped();
+        return false;
+    }
+    headSlot++;
+    accumulate(record, 1);
+    return true;
+}
+
+HistoryStats History::getStats() {
+    portENTER_CRITICAL(&statsLock);
+    HistoryStats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return copy;
+}
+
+// Percorre o anel a partir do setor seguinte ao atual, que é a ordem das
+// sequências: do mais antigo ao mais recente. Um registro por linha.
+void History::exportDump(Print& out) {
+    HistoryStats summary = getStats();
+    out.printf("=== HISTORY %u registros, boot %u ===\n",
+               (unsigned)summary.records, (unsigned)summary.boot);
+    if (partition == NULL) return;
+
+    exporting = true;
+    uint32_t lastSector = headSector;
+    HistoryRecord chunk[HISTORY_CHUNK];
+    for (uint32_t i = 1; i <= sectorCount; i++) {
+        uint32_t sector = (lastSector + i) % sectorCount;
+        uint32_t sequence;
+        if (!readHeader(sector, sequence)) continue;
+
+        bool sectorEnd = false;
+        for (uint32_t slot = 0; slot < HISTORY_RECORDS_PER_SECTOR && !sectorEnd; slot += HISTORY_CHUNK) {
+            uint32_t count = min((uint32_t)HISTORY_CHUNK, (uint32_t)HISTORY_RECORDS_PER_SECTOR - slot);
+            if (!readChunk(sector, slot, chunk, count)) break;
+            for (uint32_t r = 0; r < count; r++) {
+                int state = classify(chunk[r]);
+                if (state == 0) {
+                    sectorEnd = true;
+                    break;
+                }
+                if (state < 0) continue;
+                const uint8_t* bytes = (const uint8_t*)&chunk[r];
+                for (int b = 0; b < HISTORY_RECORD_SIZE; b++) {
+                    out.printf("%02x", bytes[b]);
+                }
+                out.println();
+            }
+        }
+    }
+    exporting = false;
+    out.println("=== FIM ===");
+}
@@ -0,0 +1,256 @@
+#include "InputTrace.h"
+#include "Metrics.h"
+
+#define TRACE_TYPE_SHIFT    14
+#define TRACE_DELTA_MASK    0x3FFF
+#define TRACE_TYPE_EXTEND   3
+#define TRACE_HEX_PER_LINE  32      // Bytes por linha na exportação
+#define TRACE_LINE_MAX      80      // Linha mais longa aceita na importação
+
+static const char* eventNames[] = {"cw", "ccw", "press"};
+
+uint8_t InputTrace::buffer[INPUT_TRACE_CAPACITY];
+size_t InputTrace::length = 0;
+size_t InputTrace::readIndex = 0;
+bool InputTrace::recording = false;
+bool InputTrace::replaying = false;
+uint32_t InputTrace::lastEventUs = 0;
+uint32_t InputTrace::nextDueUs = 0;
+int InputTrace::nextType = -1;
+unsigned long (*InputTrace::clock)() = micros;
+int InputTrace::eventIndex = -1;
+int InputTrace::eventType = 0;
+uint32_t InputTrace::eventUs = 0;
+int32_t InputTrace::flushLatencyUs = -1;
+int32_t InputTrace::motionLatencyUs = -1;
+bool InputTrace::motionActive = false;
+uint32_t InputTrace::eventSerial = 0;
+
+void InputTrace::setClock(unsigned long (*clockUs)()) {
+    clock = clockUs;
+}
+
+// ================= Gravação =================
+
+void InputTrace::startRecording() {
+    stopReplay();
+    length = 0;
+    lastEventUs = clock();
+    recording = true;
+    Serial.println("Gravacao de entrada iniciada");
+}
+
+void InputTrace::stopRecording() {
+    if (!recording) return;
+    recording = false;
+    Serial.printf("Gravacao finalizada: %u bytes\n", (unsigned)length);
+}
+
+bool InputTrace::appendWord(uint16_t word) {
+    if (length + 2 > INPUT_TRACE_CAPACITY) {
+        stopRecording(); // Buffer cheio
+        return false;
+    }
+    buffer[length++] = word & 0xFF;
+    buffer[length++] = word >> 8;
+    return true;
+}
+
+void InputTrace::record(InputEventType type) {
+    if (!recording) return;
+
+    uint32_t now = clock();
+    uint32_t deltaMs = (now - lastEventUs) / 1000;
+    lastEventUs = now;
+
+    while (deltaMs > TRACE_DELTA_MASK) {
+        if (!appendWord((TRACE_TYPE_EXTEND << TRACE_TYPE_SHIFT) | TRACE_DELTA_MASK)) return;
+        deltaMs -= TRACE_DELTA_MASK;
+    }
+    appendWord(((uint16_t)type << TRACE_TYPE_SHIFT) | deltaMs);
+}
+
+// ================= Reprodução =================
+
+// Lê a próxima palavra de evento (somando as extensões) e calcula quando entregá-lo
+void InputTrace::loadNextEvent() {
+    uint32_t deltaMs = 0;
+    nextType = -1;
+
+    while (readIndex + 2 <= length) {
+        uint16_t word = buffer[readIndex] | (buffer[readIndex + 1] << 8);
+        readIndex += 2;
+
+        deltaMs += word & TRACE_DELTA_MASK;
+        int type = word >> TRACE_TYPE_SHIFT;
+        if (type != TRACE_TYPE_EXTEND) {
+            nextType = type;
+            break;
+        }
+    }
+    nextDueUs += deltaMs * 1000;
+}
+
+void InputTrace::startReplay() {
+    stopRecording();
+    if (length == 0) {
+        Serial.println("Nenhuma gravacao para reproduzir");
+        return;
+    }
+    readIndex = 0;
+    eventIndex = -1;
+    nextDueUs = clock();
+    loadNextEvent();
+    replaying = true;
+    Serial.println("Reproducao iniciada");
+}
+
+void InputTrace::stopReplay() {
+    if (!replaying) return;
+    reportEvent();
+    replaying = false;
+    eventIndex = -1;
+    Serial.println("Reproducao finalizada");
+}
+
+int InputTrace::nextDueEvent() {
+    if (!replaying) return -1;
+
+    if (nextType < 0) {
+        stopReplay();
+        return -1;
+    }
+    if ((int32_t)(clock() - nextDueUs) < 0) return -1;
+
+    // Fecha a medição do evento anterior e começa a do novo
+    reportEvent();
+    int type = nextType;
+    eventIndex++;
+    eventSerial++;
+    eventType = type;
+    eventUs = clock();
+    flushLatencyUs = -1;
+    motionLatencyUs = -1;
+
+    loadNextEvent();
+    return type;
+}
+
+// ================= Latência =================
+
+// Um quadro desenhado antes do evento (ainda na fila quando ele chegou) não
+// mostra a reação a ele
+void InputTrace::markFlush(uint32_t frameEvent, uint32_t flushedUs) {
+    if (eventIndex < 0 || flushLatencyUs >= 0 || frameEvent != eventSerial) return;
+    flushLatencyUs = flushedUs - eventUs;
+    Metrics::recordTime(TMR_INPUT_TO_FLUSH, flushLatencyUs);
+}
+
+// Só a passagem de parado para em movimento conta: um jog que já estava
+// rodando quando o evento chegou não é um movimento gerado por ele
+void InputTrace::observeMotion(bool moving) {
+    bool started = moving && !motionActive;
+    motionActive = moving;
+    if (!started || eventIndex < 0 || motionLatencyUs >= 0) return;
+    motionLatencyUs = clock() - eventUs;
+    Metrics::recordTime(TMR_INPUT_TO_MOTION, motionLatencyUs);
+}
+
+// Uma linha JSON por evento reproduzido (-1 = o evento não gerou flush/movimento)
+void InputTrace::reportEvent() {
+    if (eventIndex < 0) return;
+    Serial.printf("{\"replay_event\":%d,\"type\":\"%s\",\"flush_us\":%d,\"motion_us\":%d}\n",
+                  eventIndex, eventNames[eventType], flushLatencyUs, motionLatencyUs);
+}
+
+void InputTrace::exportHex(Print& out) {
+    out.printf("=== TRACE %u bytes ===\n", (unsigned)length);
+    for (size_t i = 0; i < length; i++) {
+        out.printf("%02x", buffer[i]);
+        if ((i % TRACE_HEX_PER_LINE) == TRACE_HEX_PER_LINE - 1 || i == length - 1) out.println();
+    }
+    out.println("=== END ===");
+}
+
+// ================= Importação =================
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Mesmo com erro, o texto é lido até a linha END: o resto colado no
+// terminal não pode chegar a handleSerialCommands() como comandos
+bool InputTrace::importHex(Stream& in) {
+    stopRecording();
+    stopReplay();
+    length = 0;
+
+    char line[TRACE_LINE_MAX];
+    size_t lineLength = 0;
+    long declared = -1;
+    const char* error = NULL;
+    unsigned long lastCharMs = millis();
+    for (;;) {
+        if (!in.available()) {
+            if (millis() - lastCharMs > INPUT_TRACE_IMPORT_TIMEOUT_MS) {
+                if (error == NULL) error = "tempo esgotado";
+                break;
+            }
+            delay(1);
+            continue;
+        }
+        int c = in.read();
+        lastCharMs = millis();
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (lineLength + 1 < sizeof(line)) {
+                line[lineLength++] = (char)c;
+            } else if (error == NULL) {
+                error = "linha longa";
+            }
+            continue;
+        }
+        line[lineLength] = '\0';
+        lineLength = 0;
+
+        if (strcmp(line, "=== END ===") == 0) break;
+        if (error != NULL) continue;
+
+        unsigned count;
+        if (sscanf(line, "=== TRACE %u bytes ===", &count) == 1) {
+            declared = count;
+            length = 0;
+            continue;
+        }
+        if (line[0] == '=') {
+            error = "linha desconhecida";
+            continue;
+        }
+        for (size_t i = 0; line[i] != '\0' && error == NULL; i += 2) {
+            int high = hexValue(line[i]);
+            int low = high < 0 ? -1 : hexValue(line[i + 1]);
+            if (low < 0) {
+                error = "hexadecimal invalido";
+            } else if (length >= INPUT_TRACE_CAPACITY) {
+                error = "gravacao maior que o buffer";
+            } else {
+                buffer[length++] = (uint8_t)((high << 4) | low);
+            }
+        }
+    }
+
+    // Um evento ocupa 2 bytes; o tamanho do cabeçalho confere a cópia
+    if (error == NULL && ((length % 2) != 0 || (declared >= 0 && (size_t)declared != length))) {
+        error = "tamanho incorreto";
+    }
+    if (error != NULL) {
+        length = 0;
+        Serial.printf("Importacao falhou: %s\n", error);
+        return false;
+    }
+    Serial.printf("Gravacao importada: %u bytes\n", (unsigned)length);
+    return true;
+}
@@ -0,0 +1,50 @@
+#include "MenuTree.h"
+
+MenuNavigator::MenuNavigator(const MenuNode& root) {
+    levels[0].menu = &root;
+    reset();
+}
+
+void MenuNavigator::reset() {
+    depth = 0;
+    levels[0].selected = 0;
+    levels[0].top = 0;
+}
+
+void MenuNavigator::move(int direction) {
+    Level& level = levels[depth];
+    int count = itemCount();
+
+    // A seleção "dá a volta" na lista
+    int index = level.selected + direction;
+    if (index < 0) index = count - 1;
+    if (index >= count) index = 0;
+    level.selected = index;
+
+    // A janela visível acompanha o cursor
+    if (index < level.top) {
+        level.top = index;
+    }
+    if (index >= level.top + MAX_VISIBLE_MENU_ITEMS) {
+        level.top = index - MAX_VISIBLE_MENU_ITEMS + 1;
+    }
+}
+
+const MenuNode* MenuNavigator::select() {
+    const Level& level = levels[depth];
+
+    if (level.selected >= level.menu->childCount) {
+        depth--;    // "Voltar": o nível anterior mantém o cursor onde estava
+        return NULL;
+    }
+
+    const MenuNode* item = &level.menu->children[level.selected];
+    if (item->type != MENU_SUBMENU) return item;
+
+    // A profundidade da árvore é conferida em tempo de compilação
+    depth++;
+    levels[depth].menu = item;
+    levels[depth].selected = 0;
+    levels[depth].top = 0;
+    return NULL;
+}
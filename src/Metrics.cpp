@@ -0,0 +1,95 @@
+#include "Metrics.h"
+
+uint32_t Metrics::counters[COUNTER_COUNT];
+int32_t Metrics::gauges[GAUGE_COUNT];
+TimerStats Metrics::timers[TIMER_COUNT];
+portMUX_TYPE Metrics::timerLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Nomes usados no dump serial (mesma ordem dos enums em Metrics.h)
+static const char* counterNames[COUNTER_COUNT] = {
+    "loop_iterations",
+    "steps_emitted",
+    "direction_reversals",
+    "encoder_detents",
+    "encoder_dropped",
+    "button_presses",
+    "display_flushes",
+    "display_frames_skipped",
+    "cycles_completed",
+    "cycles_cancelled",
+    "hold_releases",
+    "sleep_entries",
+    "commands_dropped",
+    "emergency_stops",
+    "watchdog_errors"
+};
+
+static const char* gaugeNames[GAUGE_COUNT] = {
+    "step_rate_sps",
+    "cycle_rate_spm"
+};
+
+static const char* timerNames[TIMER_COUNT] = {
+    "loop_us",
+    "display_flush_us",
+    "display_transfer_us",
+    "move_us",
+    "cycle_ms",
+    "relay_overrun_ms",
+    "settle_overrun_ms",
+    "input_to_flush_us",
+    "input_to_motion_us",
+    "motion_tick_us",
+    "estop_handler_ns",
+    "resume_save_ns"
+};
+
+TimerStats Metrics::getTimer(TimerId id) {
+    portENTER_CRITICAL(&timerLock);
+    TimerStats t = timers[id];
+    portEXIT_CRITICAL(&timerLock);
+    return t;
+}
+
+uint32_t Metrics::getTimerAverage(TimerId id) {
+    TimerStats t = getTimer(id);
+    if (t.count == 0) return 0;
+    return (uint32_t)(t.total / t.count);
+}
+
+void Metrics::reset() {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        __atomic_store_n(&gauges[i], 0, __ATOMIC_RELAXED);
+    }
+    portENTER_CRITICAL(&timerLock);
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        timers[i].count = 0;
+        timers[i].min = UINT32_MAX;
+        timers[i].max = 0;
+        timers[i].total = 0;
+    }
+    portEXIT_CRITICAL(&timerLock);
+}
+
+void Metrics::dump(Print& out) {
+    out.println("=== METRICAS ===");
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        out.printf("%s=%u\n", counterNames[i], getCounter((CounterId)i));
+    }
+    for (int i = 0; i < GAUGE_COUNT; i++) {
+        out.printf("%s=%d\n", gaugeNames[i], getGauge((GaugeId)i));
+    }
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        // A serial é lenta: copia sob o spinlock e imprime fora dele
+        TimerStats t = getTimer((TimerId)i);
+        out.printf("%s count=%u min=%u max=%u avg=%u\n",
+                   timerNames[i],
+                   t.count,
+                   t.count ? t.min : 0,
+                   t.max,
+                   t.count ? (uint32_t)(t.total / t.count) : 0);
+    }
+}
@@ -0,0 +1,676 @@
+#include "MotionTask.h"
+#include "Metrics.h"
+#include "MotionMath.h"
+#include "EmergencyStop.h"
+#include "PinTrace.h"
+#include <esp_task_wdt.h>
+
+static_assert(SPEED_MODE_COUNT == RESUME_SPEED_MODES, "Ajuste RESUME_SPEED_MODES em ResumeState.h");
+
+MotionTask::MotionTask(StepperController& stepperController)
+    : stepper(stepperController) {
+    commandsSent = 0;
+    memset(&status, 0, sizeof(status));
+    status.phase = PHASE_IDLE;
+    status.stepsPerRev = BASE_STEPS_PER_REV;
+    status.batchTotal = 1;
+    relayOnTime = 1000;
+    settleTime = 1000;
+    phaseStartTime = 0;
+    cycleStartTime = 0;
+    cycleLogStartTime = 0;
+    pauseStartTime = 0;
+    cycleRelayOverrunMs = 0;
+    cycleSettleOverrunMs = 0;
+    pausedPhase = PHASE_IDLE;
+    moveTotal = 0;
+    moveStartUs = 0;
+    speedRpm[SPEED_POSITIONING] = POSITIONING_DEFAULT_RPM;
+    speedRpm[SPEED_CYCLE] = CYCLE_DEFAULT_RPM;
+    speedRpm[SPEED_JOG] = JOG_DEFAULT_RPM;
+    jogStopping = false;
+    indexing = false;
+    stationCount = 0;
+    cycleOrigin = 0;
+    indexMoveStartUs = 0;
+    pauseRequested = false;
+    cancelRequested = false;
+    stationSetting = INDEX_DEFAULT_STATIONS;
+    microstepIndex = 0;
+    memset(&resumePoint, 0, sizeof(resumePoint));
+    resumePending = false;
+    resumeDirty = true;
+    savedPhase = PHASE_IDLE;
+    savedCyclePosition = 0;
+    savedCyclesCompleted = 0;
+    idleSinceMs = 0;
+    lastEraseMs = 0;
+}
+
+void MotionTask::restore(const ResumeSnapshot& point) {
+    resumePoint = point;
+    resumePending = true;
+}
+
+// Sem o watchdog a tarefa continua rodando, mas um travamento não reinicia o ESP32
+static void reportWatchdogError(const char* call, esp_err_t result) {
+    Metrics::count(CNT_WATCHDOG_ERRORS);
+    Serial.printf("Watchdog: %s falhou (%s)\n", call, esp_err_to_name(result));
+}
+
+// Chamar depois de stepper.begin(): a partir daqui só a tarefa usa o stepper e o relé
+void MotionTask::begin() {
+    pinMode(RELAY_PIN, OUTPUT);
+    setRelay(false);
+
+    status.enabled = stepper.isEnabled();
+    snapshot.write(status);
+
+    // Um travamento da tarefa reinicia o ESP32 (que volta com a emergência acionada)
+    esp_err_t result = esp_task_wdt_init(MOTION_WATCHDOG_TIMEOUT_S, true);
+    if (result != ESP_OK) reportWatchdogError("esp_task_wdt_init", result);
+
+    xTaskCreatePinnedToCore(taskEntry, "motion", MOTION_TASK_STACK, this,
+                            MOTION_TASK_PRIORITY, NULL, MOTION_TASK_CORE);
+    Serial.printf("Tarefa de movimento iniciada no nucleo %d\n", MOTION_TASK_CORE);
+}
+
+// ================= Interface (produtor) =================
+
+bool MotionTask::send(MotionCommandType type, int64_t value, int32_t value2) {
+    MotionCommand command;
+    command.type = type;
+    command.value = value;
+    command.value2 = value2;
+    if (!commands.push(command)) {
+        Metrics::count(CNT_COMMANDS_DROPPED);
+        return false;
+    }
+    commandsSent++;
+    return true;
+}
+
+bool MotionTask::move(int64_t steps) { return send(CMD_MOVE, steps); }
+bool MotionTask::moveTo(int64_t absolutePosition) { return send(CMD_MOVE_TO, absolutePosition); }
+bool MotionTask::setSpeed(int32_t stepsPerSec) { return send(CMD_SET_SPEED, stepsPerSec); }
+bool MotionTask::cancel() { return send(CMD_CANCEL); }
+bool MotionTask::startCycle(int32_t cycles) { return send(CMD_START_CYCLE, cycles); }
+bool MotionTask::startIndexing(int32_t cycles, int stations) { return send(CMD_START_INDEXING, cycles, stations); }
+bool MotionTask::pause() { return send(CMD_PAUSE); }
+bool MotionTask::resume() { return send(CMD_RESUME); }
+bool MotionTask::startJog(int32_t acceleration) { return send(CMD_START_JOG, acceleration); }
+bool MotionTask::setEnabled(bool enable) { return send(CMD_SET_ENABLED, enable ? 1 : 0); }
+bool MotionTask::setMicrostep(int index, bool automatic) { return send(CMD_SET_MICROSTEP, index, automatic); }
+bool MotionTask::resetEmergencyStop() { return send(CMD_RESET_EMERGENCY); }
+bool MotionTask::setSpeedProfile(SpeedMode mode, int32_t rpm) { return send(CMD_SET_SPEED_PROFILE, mode, rpm); }
+bool MotionTask::restoreResumePoint(bool continueCycle) { return send(CMD_RESTORE, continueCycle ? 1 : 0); }
+
+bool MotionTask::setRelayTiming(unsigned long onMs, unsigned long settleMs) {
+    return send(CMD_SET_RELAY_TIMING, (int32_t)onMs, (int32_t)settleMs);
+}
+
+MotionStatus MotionTask::getStatus() const {
+    return snapshot.read();
+}
+
+bool MotionTask::isCaughtUp(const MotionStatus& s) const {
+    return s.commandsProcessed == commandsSent;
+}
+
+// ================= Tarefa de movimento (consumidor) =================
+
+void MotionTask::taskEntry(void* param) {
+    static_cast<MotionTask*>(param)->run();
+}
+
+void MotionTask::run() {
+    TickType_t lastWake = xTaskGetTickCount();
+    esp_err_t result = esp_task_wdt_add(NULL);
+    if (result != ESP_OK) reportWatchdogError("esp_task_wdt_add", result);
+
+    for (;;) {
+        esp_task_wdt_reset();
+        tick();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(MOTION_TASK_PERIOD_MS));
+    }
+}
+
+void MotionTask::tick() {
+    uint32_t tickStart = micros();
+
+    // A ISR já cortou as saídas; aqui o resto do estado é abortado. A
+    // leitura do nível cobre uma borda perdida (p.ex. durante light sleep).
+    if (!EmergencyStop::isTripped() && EmergencyStop::inputActive()) {
+        EmergencyStop::trip(ESTOP_INPUT);
+    }
+    if (EmergencyStop::isTripped() && !status.emergencyStop) {
+        abortForEmergency();
+    }
+
+    MotionCommand command;
+    while (commands.pop(command)) {
+        processCommand(command);
+        status.commandsProcessed++;
+    }
+
+    switch (status.phase) {
+        case PHASE_MOVING:
+            updateMove();
+            break;
+        case PHASE_RELAY_ON:
+        case PHASE_SETTLE:
+            updateCycle(millis());
+            break;
+        case PHASE_INDEX_MOVE:
+            updateIndexMove(millis());
+            break;
+        case PHASE_JOG:
+            updateJog();
+            break;
+    }
+
+    refreshPosition();
+    saveResumePoint();
+    snapshot.write(status);
+    Metrics::recordTime(TMR_MOTION_TICK, micros() - tickStart);
+
+    // Apagar setores do histórico trava a flash: só com tudo parado há
+    // HISTORY_MAINTAIN_IDLE_MS, um setor por HISTORY_MAINTAIN_INTERVAL_MS, e
+    // depois da medição para não aparecer como atraso da tarefa
+    unsigned long now = millis();
+    if (status.phase != PHASE_IDLE) {
+        idleSinceMs = now;
+    } else if (now - idleSinceMs >= HISTORY_MAINTAIN_IDLE_MS &&
+               now - lastEraseMs >= HISTORY_MAINTAIN_INTERVAL_MS && History::maintain()) {
+        lastEraseMs = millis();
+    }
+}
+
+void MotionTask::setRelay(bool on) {
+    // Relé ativo em LOW; ligar é recusado com a parada de emergência acionada
+    if (on) {
+        EmergencyStop::guardedWrite(RELAY_PIN, LOW);
+    } else {
+        tracedWrite(RELAY_PIN, HIGH);
+    }
+}
+
+// Saídas já cortadas pela ISR: para o timer de passos e descarta ciclo,
+// movimento e jog em andamento
+void MotionTask::abortForEmergency() {
+    stepper.abortMotion();
+    stepper.disable();
+    setRelay(false);
+
+    if (status.phase != PHASE_IDLE && status.phase != PHASE_MOVING && status.phase != PHASE_JOG) {
+        Metrics::count(CNT_CYCLES_CANCELLED);
+        logCycle(HIST_EMERGENCY, millis());
+    }
+    status.phase = PHASE_IDLE;
+    jogStopping = false;
+    pauseRequested = false;
+    cancelRequested = false;
+    status.speed = 0;
+    status.enabled = false;
+    status.emergencyStop = true;
+    status.emergencyCause = EmergencyStop::getCause();
+
+    Metrics::count(CNT_EMERGENCY_STOPS);
+    Metrics::recordTime(TMR_ESTOP_HANDLER, EmergencyStop::lastHandlerNs());
+}
+
+// A posição vem do emissor de passos; volta e passo na volta são derivados aqui
+void MotionTask::refreshPosition() {
+    int64_t position = stepper.getAbsolutePosition();
+    status.absolutePosition = position;
+    status.revolution = revolutionOf(position, status.stepsPerRev);
+    status.position = stepInRevolution(position, status.stepsPerRev);
+    status.microstepShift = stepper.getStepShift();
+}
+
+// Velocidade do modo em passos/s da resolução atual. A interface já valida o
+// RPM; o limite aqui cobre uma troca de micro-passo feita depois. Com "Auto"
+// os pulsos rápidos saem em full step, pelo timer; sem ele os movimentos até
+// uma posição saem pelo emissor de STEP_BACKEND.
+float MotionTask::modeSpeed(int mode) {
+    int32_t pulseStepsPerRev = status.autoMicrostep ? BASE_STEPS_PER_REV : status.stepsPerRev;
+    int32_t pulseRate = (mode == SPEED_JOG || status.autoMicrostep) ? MAX_STEP_PULSE_RATE
+                                                                     : POSITION_MOVE_MAX_PULSE_RATE;
+    int32_t rpm = min(speedRpm[mode], maxSpeedRpm(pulseStepsPerRev, pulseRate, SPEED_MAX_RPM));
+    return rpmToStepsPerSec(rpm, status.stepsPerRev);
+}
+
+// Movimento acelerado pelo timer de passos, na velocidade de posicionamento
+void MotionTask::startMove(int64_t steps) {
+    if (status.phase != PHASE_IDLE || steps == 0 || !stepper.isEnabled()) return;
+    int multiplier = status.stepsPerRev / BASE_STEPS_PER_REV;
+    float speed = modeSpeed(SPEED_POSITIONING);
+    moveTotal = steps > 0 ? steps : -steps;
+    moveStartUs = micros();
+    stepper.setStepRate(speed);
+    stepper.startPositionMove(stepper.getAbsolutePosition() + steps, speed,
+                              (float)POSITIONING_ACCELERATION * multiplier);
+    status.phase = PHASE_MOVING;
+}
+
+void MotionTask::processCommand(const MotionCommand& command) {
+    unsigned long now = millis();
+
+    // Em emergência só a configuração e o rearme são aceitos
+    if (status.emergencyStop && command.type != CMD_RESET_EMERGENCY &&
+        command.type != CMD_SET_RELAY_TIMING && command.type != CMD_SET_MICROSTEP &&
+        command.type != CMD_SET_SPEED_PROFILE && command.type != CMD_RESTORE) {
+        return;
+    }
+
+    switch (command.type) {
+        case CMD_MOVE:
+            startMove(command.value);
+            break;
+
+        case CMD_MOVE_TO:
+            startMove(command.value - stepper.getAbsolutePosition());
+            break;
+
+        case CMD_SET_SPEED:
+            if (status.phase == PHASE_JOG && !jogStopping) {
+                float limit = modeSpeed(SPEED_JOG);
+                stepper.setTargetSpeed(constrain((float)command.value, -limit, limit));
+            }
+            break;
+
+        case CMD_SET_RELAY_TIMING:
+            relayOnTime = command.value;
+            settleTime = command.value2;
+            resumeDirty = true;
+            break;
+
+        case CMD_CANCEL:
+            if (status.phase == PHASE_JOG) {
+                // O jog termina em updateJog(), depois da rampa de parada
+                jogStopping = true;
+                stepper.setTargetSpeed(0);
+            } else if (status.phase == PHASE_INDEX_MOVE) {
+                cancelRequested = true; // Não para no meio do caminho entre estações
+            } else if (status.phase == PHASE_MOVING) {
+                stepper.abortMotion();
+                status.phase = PHASE_IDLE;
+            } else if (status.phase != PHASE_IDLE) {
+                Metrics::count(CNT_CYCLES_CANCELLED);
+                setRelay(false);
+                logCycle(HIST_CANCELLED, now);
+                status.phase = PHASE_IDLE;
+            }
+            break;
+
+        case CMD_START_CYCLE:
+            if (status.phase != PHASE_IDLE) break;
+            indexing = false;
+            status.batchTotal = command.value;
+            status.cyclesCompleted = 0;
+            beginCycle(now);
+            break;
+
+        case CMD_START_INDEXING:
+            if (status.phase != PHASE_IDLE) break;
+            indexing = true;
+            stationSetting = command.value2;
+            buildStationTable(command.value2);
+            status.batchTotal = command.value;
+            status.cyclesCompleted = 0;
+            beginCycle(now);
+            break;
+
+        case CMD_PAUSE:
+            if (status.phase == PHASE_INDEX_MOVE) {
+                pauseRequested = true;
+                break;
+            }
+            if (status.phase != PHASE_RELAY_ON && status.phase != PHASE_SETTLE) break;
+            pausedPhase = status.phase;
+            pauseStartTime = now;
+            setRelay(false); // O relé fica desligado durante a pausa
+            status.phase = PHASE_PAUSED;
+            break;
+
+        case CMD_RESUME:
+            pauseRequested = false;
+            if (status.phase != PHASE_PAUSED) break;
+            {
+                // Desloca os tempos da fase pela duração da pausa, para que
+                // ela retome com o tempo que ainda faltava
+                unsigned long pausedFor = now - pauseStartTime;
+                phaseStartTime += pausedFor;
+                cycleStartTime += pausedFor;
+            }
+            if (pausedPhase == PHASE_RELAY_ON) {
+                setRelay(true);
+            }
+            status.phase = pausedPhase;
+            break;
+
+        case CMD_START_JOG:
+            if (status.phase != PHASE_IDLE) break;
+            stepper.setAcceleration(command.value);
+            stepper.setStepRate(modeSpeed(SPEED_JOG));
+            stepper.startVelocityMode();
+            jogStopping = false;
+            status.speed = 0;
+            status.phase = PHASE_JOG;
+            break;
+
+        case CMD_SET_ENABLED:
+            if (command.value) {
+                stepper.enable();
+            } else {
+                stepper.disable();
+            }
+            status.enabled = stepper.isEnabled();
+            break;
+
+        case CMD_SET_MICROSTEP: {
+            if (status.phase != PHASE_IDLE) break;
+            uint16_t multiplier = ActiveDriver::multipliers[command.value];
+            stepper.setMicrostep(command.value);
+            stepper.setAutoMicrostep(command.value2 != 0);
+            microstepIndex = command.value;
+            status.autoMicrostep = stepper.isAutoMicrostep();
+            // A compensação de folga é definida em full step e escala com a resolução
+            stepper.setBacklashSteps(BACKLASH_STEPS * multiplier);
+            status.stepsPerRev = BASE_STEPS_PER_REV * multiplier;
+            stepper.setAbsolutePosition(0); // A referência de passos mudou
+            refreshPosition();
+            resumeDirty = true;
+            break;
+        }
+
+        case CMD_RESET_EMERGENCY:
+            if (status.emergencyStop && EmergencyStop::reset()) {
+                status.emergencyStop = false;
+                status.emergencyCause = ESTOP_NONE;
+            }
+            break;
+
+        case CMD_SET_SPEED_PROFILE:
+            if (command.value >= 0 && command.value < SPEED_MODE_COUNT && command.value2 > 0) {
+                speedRpm[command.value] = command.value2;
+                resumeDirty = true;
+            }
+            break;
+
+        case CMD_RESTORE:
+            if (!resumePending || status.phase != PHASE_IDLE) break;
+            if (command.value && status.emergencyStop) break;
+            resumePending = false;
+            resumeDirty = true;
+            // Sem ciclo, um reinício no meio de um movimento deixa a posição
+            // sem referência, como antes de existir o ponto de retomada
+            if (resumePoint.phase != PHASE_IDLE || !resumePoint.inMotion) {
+                stepper.setAbsolutePosition(resumePoint.absolutePosition);
+            }
+            if (command.value && resumePoint.phase != PHASE_IDLE) {
+                resumeCycle(now);
+            }
+            refreshPosition();
+            break;
+    }
+}
+
+// ================= Ciclo completo =================
+
+void MotionTask::beginCycle(unsigned long now) {
+    status.cyclePosition = 0;
+    status.cycleLength = indexing ? stationCount : status.stepsPerRev;
+    cycleOrigin = stepper.getAbsolutePosition();
+    stepper.setStepRate(modeSpeed(SPEED_CYCLE));
+    pauseRequested = false;
+    cancelRequested = false;
+    cycleStartTime = now;
+    cycleLogStartTime = now;
+    cycleRelayOverrunMs = 0;
+    cycleSettleOverrunMs = 0;
+    setRelay(true);
+    phaseStartTime = now;
+    status.phase = PHASE_RELAY_ON;
+}
+
+void MotionTask::completeCycle(unsigned long now) {
+    unsigned long cycleDuration = now - cycleStartTime;
+    Metrics::recordTime(TMR_CYCLE, cycleDuration);
+    Metrics::count(CNT_CYCLES_COMPLETED);
+    if (cycleDuration > 0) {
+        Metrics::setGauge(GAUGE_CYCLE_RATE, (int32_t)((uint64_t)status.cyclePosition * 60000UL / cycleDuration));
+    }
+
+    status.cyclesCompleted++;
+    logCycle(HIST_COMPLETED, now);
+
+    // Ainda há ciclos no lote: emenda o próximo sem pausa
+    if (status.cyclesCompleted < status.batchTotal) {
+        beginCycle(now);
+    } else {
+        status.phase = PHASE_IDLE;
+    }
+}
+
+// Retoma o ciclo do ponto restaurado no início da fase interrompida: o relé
+// volta a ligar pelo tempo inteiro, a estabilização recomeça e o movimento
+// até a próxima estação é refeito a partir da estação gravada
+void MotionTask::resumeCycle(unsigned long now) {
+    indexing = resumePoint.indexing;
+    stationSetting = resumePoint.stations;
+    if (indexing) buildStationTable(stationSetting);
+    status.cyclePosition = resumePoint.cyclePosition;
+    status.cycleLength = indexing ? stationCount : status.stepsPerRev;
+    status.cyclesCompleted = resumePoint.cyclesCompleted;
+    status.batchTotal = resumePoint.batchTotal;
+    cycleOrigin = resumePoint.cycleOrigin;
+    stepper.setStepRate(modeSpeed(SPEED_CYCLE));
+    pauseRequested = false;
+    cancelRequested = false;
+    cycleStartTime = now;
+    cycleLogStartTime = now;
+    cycleRelayOverrunMs = 0;
+    cycleSettleOverrunMs = 0;
+    phaseStartTime = now;
+
+    uint8_t phase = resumePoint.phase == PHASE_PAUSED ? resumePoint.pausedPhase : resumePoint.phase;
+    if (phase == PHASE_INDEX_MOVE) {
+        startIndexMove();
+    } else if (phase == PHASE_SETTLE) {
+        status.phase = PHASE_SETTLE;
+    } else {
+        setRelay(true);
+        status.phase = PHASE_RELAY_ON;
+    }
+}
+
+// Grava o ponto de retomada a cada transição de fase, avanço do ciclo ou
+// mudança de configuração. Com um ponto restaurado ainda sem decisão nada é
+// gravado, e um novo reinício continua oferecendo a retomada.
+void MotionTask::saveResumePoint() {
+    if (resumePending) return;
+    if (!resumeDirty && status.phase == savedPhase && status.cyclePosition == savedCyclePosition &&
+        status.cyclesCompleted == savedCyclesCompleted) {
+        return;
+    }
+
+    bool inCycle = status.phase == PHASE_RELAY_ON || status.phase == PHASE_SETTLE ||
+                   status.phase == PHASE_INDEX_MOVE || status.phase == PHASE_PAUSED;
+    ResumeSnapshot point;
+    memset(&point, 0, sizeof(point));
+    // Durante o movimento do indexador grava a estação de partida, de onde
+    // a retomada refaz o movimento
+    point.absolutePosition = status.phase == PHASE_INDEX_MOVE
+                                 ? cycleOrigin + stationOffsets[status.cyclePosition]
+                                 : status.absolutePosition;
+    point.cycleOrigin = cycleOrigin;
+    point.cyclePosition = status.cyclePosition;
+    point.cycleLength = status.cycleLength;
+    point.cyclesCompleted = status.cyclesCompleted;
+    point.batchTotal = status.batchTotal;
+    point.relayOnMs = relayOnTime;
+    point.settleMs = settleTime;
+    for (int mode = 0; mode < SPEED_MODE_COUNT; mode++) {
+        point.speedRpm[mode] = speedRpm[mode];
+    }
+    point.stations = stationSetting;
+    point.phase = inCycle ? (uint8_t)status.phase : (uint8_t)PHASE_IDLE;
+    point.pausedPhase = pausedPhase;
+    point.microstepIndex = microstepIndex;
+    point.autoMicrostep = status.autoMicrostep;
+    point.indexing = indexing;
+    point.inMotion = status.phase == PHASE_MOVING || status.phase == PHASE_INDEX_MOVE ||
+                     status.phase == PHASE_JOG;
+    ResumeState::save(point);
+
+    resumeDirty = false;
+    savedPhase = status.phase;
+    savedCyclePosition = status.cyclePosition;
+    savedCyclesCompleted = status.cyclesCompleted;
+}
+
+// Um registro no histórico por ciclo encerrado. Sempre com o motor parado
+// (entre passos ou estações), então a escrita na flash não atrasa pulsos.
+void MotionTask::logCycle(HistoryOutcome outcome, unsigned long now) {
+    // O início é o instante real; a duração desconta as pausas (cycleStartTime
+    // é deslocado a cada retomada) e, em pausa, vai até o início dela
+    unsigned long end = status.phase == PHASE_PAUSED ? pauseStartTime : now;
+    HistoryRecord record = History::makeRecord(cycleLogStartTime / 1000, end - cycleStartTime,
+                                               status.cycleLength,
+                                               indexing ? HIST_MODE_INDEXER : HIST_MODE_CYCLE,
+                                               outcome, cycleRelayOverrunMs, cycleSettleOverrunMs);
+    History::append(record);
+}
+
+void MotionTask::updateCycle(unsigned long now) {
+    if (status.phase == PHASE_RELAY_ON) {
+        // O relé está ligado, esperando o tempo definido
+        if (now - phaseStartTime < relayOnTime) return;
+        Metrics::recordTime(TMR_RELAY_OVERRUN, now - phaseStartTime - relayOnTime);
+        cycleRelayOverrunMs = max(cycleRelayOverrunMs, now - phaseStartTime - relayOnTime);
+
+        setRelay(false);
+
+        if (indexing) {
+            startIndexMove();
+            return;
+        }
+
+        // Dá o passo imediatamente
+        stepper.moveOneStep();
+        status.cyclePosition++;
+
+        phaseStartTime = now;
+        status.phase = PHASE_SETTLE;
+    } else {
+        // Pausa de estabilização após o passo
+        if (now - phaseStartTime < settleTime) return;
+        Metrics::recordTime(TMR_SETTLE_OVERRUN, now - phaseStartTime - settleTime);
+        cycleSettleOverrunMs = max(cycleSettleOverrunMs, now - phaseStartTime - settleTime);
+
+        if (status.cyclePosition >= status.cycleLength) {
+            completeCycle(now);
+        } else {
+            setRelay(true);
+            phaseStartTime = now;
+            status.phase = PHASE_RELAY_ON;
+        }
+    }
+}
+
+// ================= Indexador =================
+
+// Estações igualmente espaçadas, ou a tabela de ângulos de config.h (stations == 0).
+// stationOffsets[stationCount] é sempre uma volta completa: o último movimento
+// leva de volta à estação 0 do próximo ciclo.
+void MotionTask::buildStationTable(int stations) {
+    if (stations == 0) {
+        static const int16_t table[] = INDEX_STATION_TABLE;
+        stationCount = min((int)(sizeof(table) / sizeof(table[0])), INDEX_MAX_STATIONS);
+        for (int i = 0; i < stationCount; i++) {
+            stationOffsets[i] = angleToSteps(table[i], status.stepsPerRev);
+        }
+    } else {
+        stationCount = constrain(stations, 1, INDEX_MAX_STATIONS);
+        for (int i = 0; i < stationCount; i++) {
+            stationOffsets[i] = equalStationOffset(i, stationCount, status.stepsPerRev);
+        }
+    }
+    stationOffsets[stationCount] = status.stepsPerRev;
+}
+
+// Um único movimento acelerado até a próxima estação
+void MotionTask::startIndexMove() {
+    int multiplier = status.stepsPerRev / BASE_STEPS_PER_REV;
+    indexMoveStartUs = micros();
+    stepper.startPositionMove(cycleOrigin + stationOffsets[status.cyclePosition + 1],
+                              modeSpeed(SPEED_CYCLE),
+                              (float)INDEX_ACCELERATION * multiplier);
+    status.phase = PHASE_INDEX_MOVE;
+}
+
+void MotionTask::updateIndexMove(unsigned long now) {
+    // Motor desabilitado entre estações: o movimento nunca terminaria, e o
+    // ciclo é encerrado como cancelado
+    if (!stepper.isEnabled()) {
+        stepper.abortMotion();
+        Metrics::count(CNT_CYCLES_CANCELLED);
+        logCycle(HIST_CANCELLED, now);
+        status.phase = PHASE_IDLE;
+        return;
+    }
+    if (stepper.updatePositionMove()) return;
+
+    Metrics::recordTime(TMR_MOVE, micros() - indexMoveStartUs);
+    status.cyclePosition++;
+
+    if (cancelRequested) {
+        Metrics::count(CNT_CYCLES_CANCELLED);
+        logCycle(HIST_CANCELLED, now);
+        status.phase = PHASE_IDLE;
+        return;
+    }
+
+    phaseStartTime = now;
+    status.phase = PHASE_SETTLE;
+
+    if (pauseRequested) {
+        pauseRequested = false;
+        pausedPhase = PHASE_SETTLE;
+        pauseStartTime = now;
+        status.phase = PHASE_PAUSED;
+    }
+}
+
+// ================= Posicionamento =================
+
+void MotionTask::updateMove() {
+    // Motor desabilitado no meio do caminho: o timer não anda mais, encerra aqui
+    if (!stepper.isEnabled()) {
+        stepper.abortMotion();
+        status.phase = PHASE_IDLE;
+        return;
+    }
+    if (stepper.updatePositionMove()) return;
+
+    uint32_t elapsed = micros() - moveStartUs;
+    Metrics::recordTime(TMR_MOVE, elapsed);
+    if (elapsed > 0) {
+        Metrics::setGauge(GAUGE_STEP_RATE, (int32_t)((uint64_t)moveTotal * 1000000UL / elapsed));
+    }
+    status.phase = PHASE_IDLE;
+}
+
+// ================= Jog =================
+
+void MotionTask::updateJog() {
+    stepper.updateVelocity();
+    status.speed = (int32_t)stepper.getCurrentSpeed();
+
+    // Sai somente depois que o motor parou
+    if (jogStopping && stepper.isStopped()) {
+        status.speed = 0;
+        status.phase = PHASE_IDLE;
+    }
+}
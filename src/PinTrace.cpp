@@ -0,0 +1,135 @@
+#include "PinTrace.h"
+#include <esp_timer.h>
+
+#if PIN_TRACE_CAPACITY > 0
+
+#define LEVEL_UNKNOWN 2
+
+// Identificadores VCD (um caractere imprimível por sinal) e nomes, na ordem de TraceSignal
+static const char signalIds[SIGNAL_COUNT] = {'!', '"', '#', '$', '%', '&', '\''};
+static const char* signalNames[SIGNAL_COUNT] = {"step", "dir", "enable_n", "relay_n", "ms1", "ms2", "ms3"};
+
+uint32_t PinTrace::times[PIN_TRACE_CAPACITY];
+uint8_t PinTrace::codes[PIN_TRACE_CAPACITY];
+uint32_t PinTrace::head = 0;
+uint32_t PinTrace::count = 0;
+uint32_t PinTrace::overwritten = 0;
+uint8_t PinTrace::baseLevels[SIGNAL_COUNT];
+uint8_t PinTrace::currentLevels[SIGNAL_COUNT] = {
+    LEVEL_UNKNOWN, LEVEL_UNKNOWN, LEVEL_UNKNOWN, LEVEL_UNKNOWN,
+    LEVEL_UNKNOWN, LEVEL_UNKNOWN, LEVEL_UNKNOWN
+};
+uint32_t PinTrace::startUs = 0;
+volatile bool PinTrace::active = false;
+portMUX_TYPE PinTrace::lock = portMUX_INITIALIZER_UNLOCKED;
+// Relógio padrão: esp_timer_get_time() fica na IRAM e pode ser lido pela ISR
+// de passos com o cache da flash desligado (micros() não). Mesma base de tempo.
+static unsigned long IRAM_ATTR timerClock() {
+    return (unsigned long)esp_timer_get_time();
+}
+
+unsigned long (*PinTrace::clock)() = timerClock;
+
+void PinTrace::setClock(unsigned long (*clockUs)()) {
+    clock = clockUs;
+}
+
+int IRAM_ATTR PinTrace::signalOf(uint8_t pin) {
+    if (pin == STEP_PIN) return SIG_STEP;
+    if (pin == DIR_PIN) return SIG_DIR;
+    if (pin == ENABLE_PIN) return SIG_ENABLE;
+    if (pin == RELAY_PIN) return SIG_RELAY;
+    if (pin == MS1_PIN) return SIG_MS1;
+    if (pin == MS2_PIN) return SIG_MS2;
+    if (pin == MS3_PIN) return SIG_MS3;
+    return -1;
+}
+
+// O traço começa com os níveis atuais de todos os sinais
+void PinTrace::start() {
+    portENTER_CRITICAL(&lock);
+    head = 0;
+    count = 0;
+    overwritten = 0;
+    memcpy(baseLevels, currentLevels, sizeof(baseLevels));
+    startUs = clock();
+    active = true;
+    portEXIT_CRITICAL(&lock);
+    Serial.println("Traco de pinos iniciado");
+}
+
+void PinTrace::stop() {
+    if (!active) return;
+    active = false;
+    Serial.printf("Traco de pinos finalizado: %u bordas (%u descartadas)\n",
+                  (unsigned)count, (unsigned)overwritten);
+}
+
+void IRAM_ATTR PinTrace::record(uint8_t pin, uint8_t level) {
+    int signal = signalOf(pin);
+    if (signal < 0) return;
+    level = level ? 1 : 0;
+
+    portENTER_CRITICAL_ISR(&lock);
+    currentLevels[signal] = level;  // Mantido mesmo parado, para o início do próximo traço
+    if (active) {
+        if (count == PIN_TRACE_CAPACITY) {
+            // Buffer cheio: o evento mais antigo passa a fazer parte do estado inicial
+            uint8_t oldest = codes[head];
+            baseLevels[oldest >> 1] = oldest & 1;
+            startUs = times[head];
+            overwritten++;
+        } else {
+            count++;
+        }
+        times[head] = clock();
+        codes[head] = (signal << 1) | level;
+        head = (head + 1) % PIN_TRACE_CAPACITY;
+    }
+    portEXIT_CRITICAL_ISR(&lock);
+}
+
+// Escreve o traço em VCD (escala de 1 us). O tempo 0 é o início do traço ou,
+// se houve descarte, o último evento descartado. Os tempos de 32 bits são
+// desdobrados em sequência, então intervalos de até ~71 min entre bordas
+// consecutivas são representados corretamente.
+void PinTrace::exportVcd(Print& out) {
+    stop();
+
+    out.printf("$version %s $end\n", FIRMWARE_VERSION);
+    out.println("$timescale 1us $end");
+    if (overwritten > 0) {
+        out.printf("$comment %u bordas mais antigas descartadas $end\n", (unsigned)overwritten);
+    }
+    out.println("$scope module controlador $end");
+    for (int i = 0; i < SIGNAL_COUNT; i++) {
+        out.printf("$var wire 1 %c %s $end\n", signalIds[i], signalNames[i]);
+    }
+    out.println("$upscope $end");
+    out.println("$enddefinitions $end");
+
+    out.println("#0");
+    out.println("$dumpvars");
+    for (int i = 0; i < SIGNAL_COUNT; i++) {
+        char value = baseLevels[i] == LEVEL_UNKNOWN ? 'x' : (char)('0' + baseLevels[i]);
+        out.printf("%c%c\n", value, signalIds[i]);
+    }
+    out.println("$end");
+
+    uint32_t index = (head + PIN_TRACE_CAPACITY - count) % PIN_TRACE_CAPACITY;
+    uint32_t previousUs = startUs;
+    uint64_t timeUs = 0;
+    uint64_t lastPrinted = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        timeUs += (uint32_t)(times[index] - previousUs);
+        previousUs = times[index];
+        if (timeUs != lastPrinted) {
+            out.printf("#%llu\n", (unsigned long long)timeUs);
+            lastPrinted = timeUs;
+        }
+        out.printf("%c%c\n", (char)('0' + (codes[index] & 1)), signalIds[codes[index] >> 1]);
+        index = (index + 1) % PIN_TRACE_CAPACITY;
+    }
+}
+
+#endif
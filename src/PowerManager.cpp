@@ -0,0 +1,122 @@
+#include "PowerManager.h"
+#include "Metrics.h"
+#include "EmergencyStop.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
+
+PowerManager::PowerManager(MotionTask& motionTask, EncoderHandler& encoderHandler)
+    : motion(motionTask), encoder(encoderHandler) {
+    lastActivityTime = 0;
+    lastEncoderActivity = 0;
+    holdReleased = false;
+}
+
+void PowerManager::begin() {
+    lastActivityTime = millis();
+    lastEncoderActivity = encoder.getLastActivityTime();
+
+    // Permite que comandos pela serial também acordem o ESP32
+    uart_set_wakeup_threshold(UART_NUM_0, 3);
+    esp_sleep_enable_uart_wakeup(0);
+
+    Serial.println("PowerManager inicializado");
+}
+
+void PowerManager::notifyActivity() {
+    lastActivityTime = millis();
+}
+
+bool PowerManager::isHoldReleased() {
+    return holdReleased;
+}
+
+void PowerManager::update(bool systemIdle, bool holdWanted) {
+    // Qualquer movimento do encoder ou ciclo em andamento conta como atividade
+    unsigned long encoderActivity = encoder.getLastActivityTime();
+    if (encoderActivity != lastEncoderActivity || !systemIdle) {
+        lastEncoderActivity = encoderActivity;
+        notifyActivity();
+        if (holdReleased && holdWanted) {
+            restoreHold();
+        }
+        return;
+    }
+
+    unsigned long idleTime = millis() - lastActivityTime;
+    bool motorEnabled = motion.getStatus().enabled;
+
+    // Desenergiza o motor parado após o tempo configurado
+    if (HOLD_RELEASE_TIMEOUT_MS > 0 && !holdReleased && holdWanted && motorEnabled
+        && idleTime >= HOLD_RELEASE_TIMEOUT_MS) {
+        if (motion.setEnabled(false)) {
+            holdReleased = true;
+            Metrics::count(CNT_HOLD_RELEASES);
+            Serial.println("Inatividade: torque de retencao liberado");
+        }
+        // Dorme só na próxima chamada, depois que a tarefa de movimento
+        // executou o comando
+        return;
+    }
+
+    if (LIGHT_SLEEP_TIMEOUT_MS > 0 && idleTime >= LIGHT_SLEEP_TIMEOUT_MS) {
+        // Se a liberação do torque ainda está pendente, agenda um despertar
+        // por timer para executá-la no momento certo
+        unsigned long holdReleaseIn = 0;
+        if (HOLD_RELEASE_TIMEOUT_MS > 0 && !holdReleased && holdWanted && motorEnabled) {
+            holdReleaseIn = HOLD_RELEASE_TIMEOUT_MS - idleTime;
+        }
+        enterLightSleep(holdReleaseIn);
+    }
+}
+
+// Reenergiza o motor na mesma fase: o driver mantém o estado do tradutor
+// enquanto o ENABLE está desativado, então a posição é preservada.
+void PowerManager::restoreHold() {
+    if (!motion.setEnabled(true)) return; // Fila cheia: tenta de novo na próxima chamada
+    holdReleased = false;
+}
+
+void PowerManager::enterLightSleep(unsigned long timerWakeupMs) {
+    // Acorda quando qualquer pino do encoder mudar de nível.
+    // CLK e DT: nível oposto ao atual. SW: pressionado (LOW).
+    gpio_wakeup_enable((gpio_num_t)ENCODER_CLK,
+                       digitalRead(ENCODER_CLK) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_wakeup_enable((gpio_num_t)ENCODER_DT,
+                       digitalRead(ENCODER_DT) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_wakeup_enable((gpio_num_t)ENCODER_SW, GPIO_INTR_LOW_LEVEL);
+    // A borda do E-stop pode se perder em light sleep: acorda e a tarefa
+    // de movimento aciona a parada pela leitura do nível
+    bool estopWakeup = !EmergencyStop::inputActive();
+    if (estopWakeup) {
+        gpio_wakeup_enable((gpio_num_t)ESTOP_PIN,
+                           ESTOP_ACTIVE_LEVEL == HIGH ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    }
+    esp_sleep_enable_gpio_wakeup();
+    if (timerWakeupMs > 0) {
+        esp_sleep_enable_timer_wakeup((uint64_t)timerWakeupMs * 1000ULL);
+    } else {
+        esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    }
+
+    Metrics::count(CNT_SLEEP_ENTRIES);
+    Serial.println("Entrando em light sleep");
+    Serial.flush();
+
+    // RAM, registradores e níveis dos pinos de saída (ENABLE, relé, MS1-3)
+    // são preservados durante o light sleep; a execução continua daqui.
+    esp_light_sleep_start();
+
+    gpio_wakeup_disable((gpio_num_t)ENCODER_CLK);
+    gpio_wakeup_disable((gpio_num_t)ENCODER_DT);
+    gpio_wakeup_disable((gpio_num_t)ENCODER_SW);
+    if (estopWakeup) {
+        gpio_wakeup_disable((gpio_num_t)ESTOP_PIN);
+    }
+
+    // Despertar por timer não é atividade do operador
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) {
+        notifyActivity();
+        Serial.println("Acordou do light sleep");
+    }
+}
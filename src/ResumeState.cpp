@@ -0,0 +1,98 @@
+#include "ResumeState.h"
+#include "EmergencyStop.h"
+#include "Metrics.h"
+#include <esp_system.h>
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <driver/rtc_cntl.h>
+#include <soc/rtc_cntl_reg.h>
+
+#define RESUME_MAGIC 0x31534D52UL   // "RMS1"
+
+struct ResumeSlot {
+    uint32_t magic;
+    uint32_t sequence;
+    ResumeSnapshot snapshot;
+    uint32_t crc;                   // CRC-32 de sequence e snapshot
+};
+
+// Fora da inicialização do C: o conteúdo atravessa os reinícios
+RTC_NOINIT_ATTR static ResumeSlot slots[2];
+static uint32_t nextSequence = 0;
+
+uint8_t ResumeState::resetReason = ESP_RST_UNKNOWN;
+
+static uint32_t slotCrc(const ResumeSlot& slot) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&slot.sequence,
+                            sizeof(slot.sequence) + sizeof(slot.snapshot));
+}
+
+static bool slotValid(const ResumeSlot& slot) {
+    return slot.magic == RESUME_MAGIC && slot.crc == slotCrc(slot);
+}
+
+void ResumeState::begin() {
+    resetReason = esp_reset_reason();
+
+    // Ao ligar a memória RTC tem lixo; um CRC válido por acaso não é aceito
+    if (resetReason == ESP_RST_POWERON) {
+        slots[0].magic = 0;
+        slots[1].magic = 0;
+    }
+
+    // Continua a sequência dos slots válidos: depois de uma gravação
+    // interrompida, a próxima volta ao slot dela
+    nextSequence = 0;
+    for (int i = 0; i < 2; i++) {
+        if (slotValid(slots[i]) && slots[i].sequence >= nextSequence) {
+            nextSequence = slots[i].sequence + 1;
+        }
+    }
+
+    // Registrado depois do tratador do ESP-IDF, roda antes dele
+    rtc_isr_register(onBrownout, NULL, RTC_CNTL_BROWN_OUT_INT_ENA_M);
+}
+
+// A tensão está caindo: saídas no nível seguro antes do reinício
+void IRAM_ATTR ResumeState::onBrownout(void* arg) {
+    (void)arg;
+    EmergencyStop::trip(ESTOP_BROWNOUT);
+}
+
+bool ResumeState::load(ResumeSnapshot& snapshot) {
+    const ResumeSlot* newest = NULL;
+    for (int i = 0; i < 2; i++) {
+        if (slotValid(slots[i]) && (newest == NULL || slots[i].sequence > newest->sequence)) {
+            newest = &slots[i];
+        }
+    }
+    if (newest == NULL) return false;
+    snapshot = newest->snapshot;
+    return true;
+}
+
+// Grava no slot mais antigo; o CRC por último fecha a gravação
+void ResumeState::save(const ResumeSnapshot& snapshot) {
+    uint32_t start = ESP.getCycleCount();
+    ResumeSlot& slot = slots[nextSequence & 1];
+    slot.magic = 0;
+    slot.sequence = nextSequence;
+    slot.snapshot = snapshot;
+    slot.crc = slotCrc(slot);
+    slot.magic = RESUME_MAGIC;
+    nextSequence++;
+    uint32_t cycles = ESP.getCycleCount() - start;
+    Metrics::recordTime(TMR_RESUME_SAVE, cycles * 1000UL / ESP.getCpuFreqMHz());
+}
+
+const char* ResumeState::resetCauseName() {
+    switch (resetReason) {
+        case ESP_RST_BROWNOUT:  return "Queda de tensao";
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_INT_WDT:
+        case ESP_RST_WDT:       return "Watchdog";
+        case ESP_RST_PANIC:     return "Falha (panic)";
+        case ESP_RST_SW:        return "Reinicio";
+        default:                return "Reset";
+    }
+}
@@ -0,0 +1,101 @@
+#include "StepPulseEncoder.h"
+
+// Limite de c(n) em Q8 com folga para 2·c(n) na frenagem (~0,8 s a 10 MHz)
+#define STEP_INTERVAL_MAX_Q8    0x3FFFFFFFUL
+
+StepPulseEncoder::StepPulseEncoder()
+    : totalSteps(0), stepIndex(0), rampSteps(0), intervalQ8(0), cruiseQ8(0),
+      fractionQ8(0), divisionRest(0), pendingLowTicks(0), lastIntervalTicks(0), pulseTicks(1) {}
+
+void StepPulseEncoder::begin(const StepProfile& profile) {
+    totalSteps = profile.steps;
+    stepIndex = 0;
+    fractionQ8 = 0;
+    divisionRest = 0;
+    pendingLowTicks = 0;
+    lastIntervalTicks = 0;
+    pulseTicks = max(profile.pulseTicks, (uint16_t)1);
+
+    // O passo mais curto ainda tem pelo menos 2 ticks em nível baixo
+    float minInterval = pulseTicks + 2;
+    float ticks = profile.ticksPerSecond;
+    float cruise = max(ticks / profile.maxSpeed, minInterval);
+    // Aceleração mínima para que o primeiro intervalo caiba no ponto fixo
+    float maxFirst = STEP_INTERVAL_MAX_Q8 / 256.0f;
+    float minAcceleration = 2.0f * (0.676f * ticks / maxFirst) * (0.676f * ticks / maxFirst);
+    float acceleration = max(profile.acceleration, minAcceleration);
+    // 0,676 corrige o erro da aproximação no primeiro intervalo (Austin, eq. 15)
+    float first = max(0.676f * ticks * sqrtf(2.0f / acceleration), cruise);
+
+    cruiseQ8 = (uint32_t)min(cruise * 256.0f, (float)STEP_INTERVAL_MAX_Q8);
+    intervalQ8 = (uint32_t)min(first * 256.0f, (float)STEP_INTERVAL_MAX_Q8);
+
+    // Aceleração e frenagem simétricas; sem espaço para a velocidade máxima
+    // o perfil vira triângulo
+    float ramp = profile.maxSpeed * profile.maxSpeed / (2.0f * acceleration);
+    rampSteps = (uint32_t)min(ramp, (float)(totalSteps / 2));
+}
+
+// Intervalo do passo stepIndex, em ticks. O último passo não espera um
+// intervalo inteiro: a transmissão termina logo depois do pulso.
+uint32_t IRAM_ATTR StepPulseEncoder::nextIntervalTicks() {
+    uint32_t n = stepIndex++;
+    if (stepIndex == totalSteps) return pulseTicks + 2;
+
+    uint32_t q = max(intervalQ8, cruiseQ8) + fractionQ8;
+    fractionQ8 = q & 0xFF;
+
+    uint32_t decelStart = totalSteps - rampSteps;
+    if (n + 1 < rampSteps) {
+        // Aceleração: c(n+1) = c(n) - 2·c(n) / (4(n+1) + 1). O resto da divisão
+        // passa para o passo seguinte (como na nota AVR446), senão o
+        // truncamento se acumula e a rampa fica lenta nos passos altos.
+        uint32_t numerator = 2 * intervalQ8 + divisionRest;
+        uint32_t divisor = 4 * (n + 1) + 1;
+        intervalQ8 -= numerator / divisor;
+        divisionRest = numerator % divisor;
+    } else if (n >= decelStart) {
+        // Frenagem: a rampa ao contrário, c(k-1) = c(k) + 2·c(k) / (4k - 1)
+        uint32_t k = rampSteps - 1 - (n - decelStart);
+        if (n == decelStart) divisionRest = 0;
+        if (k > 0) {
+            uint32_t numerator = 2 * intervalQ8 + divisionRest;
+            uint32_t divisor = 4 * k - 1;
+            intervalQ8 = min(intervalQ8 + numerator / divisor, (uint32_t)STEP_INTERVAL_MAX_Q8);
+            divisionRest = numerator % divisor;
+        }
+    }
+    lastIntervalTicks = q >> 8;
+    return q >> 8;
+}
+
+size_t IRAM_ATTR StepPulseEncoder::fill(uint32_t* symbols, size_t capacity, uint32_t& steps) {
+    size_t count = 0;
+    steps = 0;
+
+    while (count < capacity) {
+        if (pendingLowTicks > 0) {
+            // Continuação só em nível baixo; nunca sobra 1 tick, que não
+            // caberia num símbolo de duas metades não nulas
+            uint32_t chunk = min(pendingLowTicks, (uint32_t)(2 * STEP_SYMBOL_MAX_DURATION));
+            if (pendingLowTicks - chunk == 1) chunk--;
+            uint32_t half = chunk / 2;
+            symbols[count++] = symbol(half, false, chunk - half, false);
+            pendingLowTicks -= chunk;
+            continue;
+        }
+        if (stepIndex >= totalSteps) break;
+
+        uint32_t interval = nextIntervalTicks();
+        uint32_t low = interval - pulseTicks;
+        uint32_t first = low;
+        if (low > STEP_SYMBOL_MAX_DURATION) {
+            first = (low - STEP_SYMBOL_MAX_DURATION == 1) ? STEP_SYMBOL_MAX_DURATION - 1
+                                                          : STEP_SYMBOL_MAX_DURATION;
+        }
+        symbols[count++] = symbol(pulseTicks, true, first, false);
+        pendingLowTicks = low - first;
+        steps++;
+    }
+    return count;
+}
@@ -1,8 +1,75 @@
 #include "StepperController.h"
+#include "Metrics.h"
+#include "MotionMath.h"
+#include "EmergencyStop.h"
+#include "PinTrace.h"
+#include <esp_rom_sys.h>
+#include <hal/timer_ll.h>
 
-StepperController::StepperController() {
+// Grupo e índice do timer de passos no HAL (o Arduino numera os timers como
+// grupo * 2 + índice). A ISR reprograma o alarme direto no registrador.
+#define STEP_TIMER_GROUP  (STEP_TIMER_ID < 2 ? &TIMERG0 : &TIMERG1)
+#define STEP_TIMER_INDEX  ((timer_idx_t)(STEP_TIMER_ID % 2))
+
+#if STEP_BACKEND == STEP_BACKEND_RMT
+#include <driver/rmt.h>
+#include <soc/rmt_struct.h>
+
+#define RMT_BLOCK_SYMBOLS     64                      // Memória de um canal
+#define RMT_HALF_SYMBOLS      (RMT_BLOCK_SYMBOLS / 2)
+#define RMT_TICKS_PER_SECOND  (80000000UL / RMT_CLOCK_DIV)
+#define RMT_TX_END_BIT        (1UL << (RMT_STEP_CHANNEL * 3))
+#define RMT_TX_THR_BIT        (1UL << (24 + RMT_STEP_CHANNEL))
+#endif
+
+// Faixas de ressonância em passos/s de full step (config.h)
+static const uint16_t resonanceBands[][2] = RESONANCE_BANDS;
+static const int RESONANCE_BAND_COUNT = sizeof(resonanceBands) / sizeof(resonanceBands[0]);
+
+volatile int64_t StepperController::absolutePosition = 0;
+portMUX_TYPE StepperController::positionLock = portMUX_INITIALIZER_UNLOCKED;
+volatile int64_t StepperController::stopPosition = 0;
+volatile bool StepperController::stopArmed = false;
+hw_timer_t* StepperController::stepTimer = NULL;
+volatile int8_t StepperController::stepSign = 1;
+volatile uint8_t StepperController::stepShift = 0;
+volatile uint8_t StepperController::pendingShift = 0;
+volatile uint32_t StepperController::timerIntervalUs = 0;
+uint8_t StepperController::shiftModeBits[ActiveDriver::MICROSTEP_COUNT];
+volatile uint32_t StepperController::driverPhase = 0;
+volatile uint32_t StepperController::phasePerStep = 1;
+#if STEP_BACKEND == STEP_BACKEND_RMT
+StepPulseEncoder StepperController::rmtEncoder;
+volatile uint32_t StepperController::rmtHalfSteps[2] = {0, 0};
+volatile uint8_t StepperController::rmtActiveHalf = 0;
+volatile bool StepperController::rmtEnding = false;
+volatile bool StepperController::rmtTransmitting = false;
+#endif
+
+StepperController::StepperController()
+#if STEPPER_DRIVER == DRIVER_TMC2209
+    : driver(TMC_UART, TMC_ADDRESS)
+#endif
+{
     enabled = false;
     currentDirection = 1;
+    lastMotionDirection = 0;
+    backlashSteps = 0;
+    stepIntervalUs = 0;
+    lastPulseUs = 0;
+    timerRunning = false;
+    currentSpeed = 0;
+    targetSpeed = 0;
+    acceleration = 1000;
+    lastRampUpdate = 0;
+    positionMoveActive = false;
+    positionMoveTarget = 0;
+    positionMoveMaxSpeed = 0;
+    autoMicrostep = false;
+    microstepIndex = 0;
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    rmtMoveActive = false;
+#endif
 }
 
 void StepperController::begin() {
@@ -10,71 +77,566 @@ void StepperController::begin() {
     pinMode(DIR_PIN, OUTPUT);
     pinMode(ENABLE_PIN, OUTPUT);
     
-    digitalWrite(STEP_PIN, LOW);
-    digitalWrite(DIR_PIN, LOW);
-    digitalWrite(ENABLE_PIN, HIGH); // HIGH = desabilitado na maioria dos drivers
+    tracedWrite(STEP_PIN, LOW);
+    tracedWrite(DIR_PIN, LOW);     // LOW = horário
+    tracedWrite(ENABLE_PIN, HIGH); // HIGH = desabilitado na maioria dos drivers
+    currentDirection = 1;
     
     enabled = false;
+
+#if STEPPER_DRIVER == DRIVER_TMC2209
+    TMC_UART.begin(TMC_UART_BAUD, SERIAL_8N1, TMC_UART_RX_PIN, TMC_UART_TX_PIN);
+#endif
+    driver.begin();    // Com DRIVER_RESET_PIN, o tradutor parte do Home
+    driverPhase = 0;
+    phasePerStep = ActiveDriver::multipliers[ActiveDriver::MICROSTEP_COUNT - 1] /
+                   ActiveDriver::multipliers[microstepIndex];
+
+    // Timer de 1 MHz (80 MHz / 80) para o modo velocidade
+    stepTimer = timerBegin(STEP_TIMER_ID, 80, true);
+    timerAttachInterrupt(stepTimer, &onStepTimer, true);
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    beginRmt();
+#endif
     
     Serial.println("StepperController inicializado");
 }
 
 void StepperController::enable() {
-    digitalWrite(ENABLE_PIN, LOW); // LOW = habilitado
+    // LOW = habilitado; recusado com a parada de emergência acionada
+    if (!EmergencyStop::guardedWrite(ENABLE_PIN, LOW)) {
+        Serial.println("Motor nao habilitado: parada de emergencia acionada");
+        return;
+    }
     enabled = true;
     Serial.println("Motor de passo habilitado");
 }
 
 void StepperController::disable() {
-    digitalWrite(ENABLE_PIN, HIGH); // HIGH = desabilitado
+    tracedWrite(ENABLE_PIN, HIGH); // HIGH = desabilitado
     enabled = false;
     Serial.println("Motor de passo desabilitado");
 }
 
+// Só escreve no DIR_PIN (e paga o tempo de setup) quando o sentido realmente muda
 void StepperController::setDirection(bool clockwise) {
-    currentDirection = clockwise ? 1 : -1;
-    digitalWrite(DIR_PIN, clockwise ? LOW : HIGH);
+    int newDirection = clockwise ? 1 : -1;
+    if (newDirection == currentDirection) return;
+
+    currentDirection = newDirection;
+    tracedWrite(DIR_PIN, clockwise ? LOW : HIGH);
     delayMicroseconds(10); // Pequeno delay para estabilizar sinal de direção
 }
 
-void StepperController::moveOneStep(bool clockwise) {
-    if (!enabled) return;
-    
-    setDirection(clockwise);
-    
-    // Gera pulso de step
-    digitalWrite(STEP_PIN, HIGH);
-    delayMicroseconds(STEP_DELAY_US / 2);
-    digitalWrite(STEP_PIN, LOW);
-    delayMicroseconds(STEP_DELAY_US / 2);
-    
-    Serial.printf("Step executado - direção: %s\n", clockwise ? "horário" : "anti-horário");
+void StepperController::setBacklashSteps(int steps) {
+    backlashSteps = steps;
 }
 
-void StepperController::moveSteps(int steps) {
-    if (!enabled || steps == 0) return;
-    
-    bool clockwise = steps > 0;
-    int absSteps = abs(steps);
-    
+void StepperController::setStepRate(float stepsPerSec) {
+    stepIntervalUs = stepsPerSec > 0 ? (uint32_t)(1000000.0 / stepsPerSec) : 0;
+}
+
+void StepperController::setMicrostep(int index) {
+    driver.applyMicrostep(index);
+    microstepIndex = index;
+    stepShift = 0;
+    pendingShift = 0;
+    phasePerStep = ActiveDriver::multipliers[ActiveDriver::MICROSTEP_COUNT - 1] /
+                   ActiveDriver::multipliers[index];
+
+#if AUTO_MICROSTEP_SUPPORTED
+    // Pinos de cada resolução mais grossa, prontos para a ISR
+    for (int shift = 0; shift <= index; shift++) {
+        shiftModeBits[shift] = ActiveDriver::modeBits[index - shift];
+    }
+#endif
+}
+
+// Sem DRIVER_RESET_PIN a referência é o Home da energização do driver, que
+// precisa ligar junto com o ESP32. O reinício do tradutor pode puxar o rotor
+// até meio ciclo elétrico (2 passos inteiros) para o Home.
+void StepperController::setAutoMicrostep(bool on) {
+    autoMicrostep = on && AUTO_MICROSTEP_SUPPORTED;
+    pendingShift = 0;
+#if AUTO_MICROSTEP_SUPPORTED && DRIVER_RESET_PIN >= 0
+    if (autoMicrostep) {
+        driver.resetTranslator();
+        portENTER_CRITICAL(&positionLock);
+        driverPhase = 0;
+        portEXIT_CRITICAL(&positionLock);
+    }
+#endif
+}
+
+bool StepperController::isAutoMicrostep() {
+    return autoMicrostep;
+}
+
+int StepperController::getStepShift() {
+    return stepShift;
+}
+
+uint32_t StepperController::getDriverPhase() {
+    return driverPhase;
+}
+
+// Gera um pulso de step respeitando o intervalo de setStepRate() desde o
+// pulso anterior; um passo isolado sai sem espera
+void StepperController::pulseStep() {
+    if (EmergencyStop::isTripped()) return;
+    uint32_t sinceLast = micros() - lastPulseUs;
+    if (sinceLast < stepIntervalUs) {
+        delayMicroseconds(stepIntervalUs - sinceLast);
+    }
+    lastPulseUs = micros();
+    tracedWrite(STEP_PIN, HIGH);
+    delayMicroseconds(STEP_PULSE_US);
+    tracedWrite(STEP_PIN, LOW);
+    portENTER_CRITICAL(&positionLock);
+    driverPhase += currentDirection * phasePerStep;
+    portEXIT_CRITICAL(&positionLock);
+    Metrics::count(CNT_STEPS_EMITTED);
+}
+
+// Ajusta o sentido e, se for uma inversão, injeta os passos de compensação
+// de folga. Esses passos não contam na posição do chamador.
+void StepperController::prepareMotion(bool clockwise) {
     setDirection(clockwise);
-    
-    Serial.printf("Movendo %d steps - direção: %s\n", absSteps, clockwise ? "horário" : "anti-horário");
-    
-    for (int i = 0; i < absSteps; i++) {
-        // Gera pulso de step
-        digitalWrite(STEP_PIN, HIGH);
-        delayMicroseconds(STEP_DELAY_US / 2);
-        digitalWrite(STEP_PIN, LOW);
-        delayMicroseconds(STEP_DELAY_US / 2);
-        
-        // Pequeno delay entre steps para suavidade
-        delay(5);
+
+    int direction = clockwise ? 1 : -1;
+    if (lastMotionDirection != 0 && direction != lastMotionDirection) {
+        Metrics::count(CNT_DIRECTION_REVERSALS);
+        for (int i = 0; i < backlashSteps; i++) {
+            pulseStep();
+        }
     }
+    lastMotionDirection = direction;
+}
+
+void StepperController::moveOneStep(bool clockwise) {
+    if (!enabled || EmergencyStop::isTripped()) return;
     
-    Serial.printf("Movimento de %d steps concluído\n", absSteps);
+    // Sem log por passo: chamado pela tarefa de movimento, onde a serial
+    // bloquearia o ritmo do ciclo
+    prepareMotion(clockwise);
+    pulseStep();
+    advancePosition(currentDirection);
 }
 
 bool StepperController::isEnabled() {
     return enabled;
-}
\ No newline at end of file
+}
+
+void StepperController::advancePosition(int32_t steps) {
+    portENTER_CRITICAL(&positionLock);
+    absolutePosition += steps;
+    portEXIT_CRITICAL(&positionLock);
+}
+
+int64_t StepperController::getAbsolutePosition() {
+    portENTER_CRITICAL(&positionLock);
+    int64_t position = absolutePosition;
+    portEXIT_CRITICAL(&positionLock);
+    return position;
+}
+
+void StepperController::setAbsolutePosition(int64_t position) {
+    portENTER_CRITICAL(&positionLock);
+    absolutePosition = position;
+    portEXIT_CRITICAL(&positionLock);
+}
+
+// Gera um pulso de STEP a cada alarme do timer. O Arduino registra a ISR com
+// ESP_INTR_FLAG_IRAM, então ela continua rodando com o cache da flash
+// desligado (apagamento de setor do histórico): tudo que ela chama fica na
+// IRAM ou é inline (pinos pelo registrador do GPIO, espera pela ROM, alarme
+// pelo HAL do timer).
+void IRAM_ATTR StepperController::onStepTimer() {
+    if (EmergencyStop::isTripped()) return; // A tarefa de movimento desliga o timer
+    portENTER_CRITICAL_ISR(&positionLock);
+    int64_t position = absolutePosition;
+    // Distância até o alvo no sentido do movimento (sem alvo: ilimitada)
+    int64_t remaining = stopArmed ? (stopPosition - position) * stepSign : INT64_MAX;
+    bool atStop = remaining <= 0;
+    uint8_t previousShift = stepShift;
+    if (!atStop) {
+        // Um pulso grosso passaria do alvo: volta à resolução fina. A troca
+        // só acontece com o tradutor numa fase comum às duas resoluções.
+        uint8_t shift = ((int64_t)1 << previousShift) > remaining ? 0 : pendingShift;
+        uint8_t coarsest = shift > previousShift ? shift : previousShift;
+        if (shift != previousShift && (driverPhase & ((phasePerStep << coarsest) - 1)) == 0 &&
+            ((int64_t)1 << shift) <= remaining) {
+            stepShift = shift;
+        }
+        absolutePosition = position + stepSign * (1 << stepShift);
+        driverPhase += stepSign * (phasePerStep << stepShift);
+    }
+    uint8_t shift = stepShift;
+    portEXIT_CRITICAL_ISR(&positionLock);
+    if (atStop) return; // Alvo alcançado: a tarefa desliga o timer em seguida
+
+    if (shift != previousShift) {
+        applyShift(shift, previousShift);
+    }
+
+    tracedWriteFromIsr(STEP_PIN, HIGH);
+    esp_rom_delay_us(STEP_PULSE_US);
+    tracedWriteFromIsr(STEP_PIN, LOW);
+    Metrics::count(CNT_STEPS_EMITTED);
+}
+
+// Muda os pinos MS para a resolução 'shift' e reescala o intervalo do timer
+// para manter a velocidade física
+void IRAM_ATTR StepperController::applyShift(uint8_t shift, uint8_t previousShift) {
+#if AUTO_MICROSTEP_SUPPORTED
+    uint8_t bits = shiftModeBits[shift];
+    tracedWriteFromIsr(MS1_PIN, (bits & 0b001) ? HIGH : LOW);
+    tracedWriteFromIsr(MS2_PIN, (bits & 0b010) ? HIGH : LOW);
+    tracedWriteFromIsr(MS3_PIN, (bits & 0b100) ? HIGH : LOW);
+#endif
+    uint32_t interval = timerIntervalUs;
+    interval = shift > previousShift ? interval << (shift - previousShift)
+                                     : interval >> (previousShift - shift);
+    timerIntervalUs = interval;
+    // Mesmo efeito de timerAlarmWrite() com recarga automática, sem sair da IRAM
+    timer_ll_set_alarm_value(STEP_TIMER_GROUP, STEP_TIMER_INDEX, interval);
+}
+
+void StepperController::setAcceleration(float stepsPerSec2) {
+    acceleration = stepsPerSec2;
+}
+
+void StepperController::startVelocityMode() {
+    currentSpeed = 0;
+    targetSpeed = 0;
+    lastRampUpdate = millis();
+}
+
+void StepperController::setTargetSpeed(float stepsPerSec) {
+    targetSpeed = stepsPerSec;
+}
+
+void StepperController::updateVelocity() {
+    unsigned long now = millis();
+    float dt = (now - lastRampUpdate) / 1000.0;
+    lastRampUpdate = now;
+
+    // Inversão de sentido: primeiro desacelera até parar
+    float goal = targetSpeed;
+    if (currentSpeed * goal < 0) {
+        goal = 0;
+    }
+
+    // Rampa de aceleração/desaceleração
+    float maxDelta = acceleration * dt;
+    if (goal > currentSpeed) {
+        currentSpeed = min(goal, currentSpeed + maxDelta);
+    } else {
+        currentSpeed = max(goal, currentSpeed - maxDelta);
+    }
+
+    // Abaixo da velocidade mínima: para (se o objetivo é parar) ou parte nela
+    if (fabs(currentSpeed) < MIN_STEP_SPEED) {
+        if (goal == 0) {
+            currentSpeed = 0;
+        } else {
+            currentSpeed = goal > 0 ? MIN_STEP_SPEED : -MIN_STEP_SPEED;
+        }
+    }
+
+    // Atravessa as faixas de ressonância (definidas em full step) num salto
+    float scale = ActiveDriver::multipliers[microstepIndex];
+    float speed = skipResonanceBands(fabs(currentSpeed) / scale, fabs(goal) / scale,
+                                     resonanceBands, RESONANCE_BAND_COUNT) * scale;
+    currentSpeed = currentSpeed < 0 ? -speed : speed;
+
+    applySpeed();
+}
+
+// Reprograma o timer para a velocidade atual
+void StepperController::applySpeed() {
+    if (currentSpeed == 0 || !enabled) {
+        if (timerRunning) {
+            timerAlarmDisable(stepTimer);
+            timerRunning = false;
+        }
+        currentSpeed = 0;
+        restoreFineMicrostep();
+        return;
+    }
+
+    if (autoMicrostep) {
+        pendingShift = autoMicrostepShift(currentSpeed, stepShift, microstepIndex,
+                                          AUTO_MICROSTEP_MAX_PULSE_RATE,
+                                          AUTO_MICROSTEP_HYSTERESIS / 100.0);
+    }
+    // Intervalo na resolução fina; a ISR pode mudar a atual a qualquer pulso
+    uint32_t fineIntervalUs = (uint32_t)(1000000.0 / fabs(currentSpeed));
+    Metrics::setGauge(GAUGE_STEP_RATE, (int32_t)fabs(currentSpeed));
+
+    if (!timerRunning) {
+        // O sentido só muda com o motor parado
+        bool clockwise = currentSpeed > 0;
+        prepareMotion(clockwise);
+        stepSign = clockwise ? 1 : -1;
+
+        timerWrite(stepTimer, 0);
+        timerIntervalUs = fineIntervalUs;
+        timerAlarmWrite(stepTimer, fineIntervalUs, true);
+        timerAlarmEnable(stepTimer);
+        timerRunning = true;
+    } else {
+        // Sob a trava: a ISR não troca a resolução entre a leitura e a escrita
+        portENTER_CRITICAL(&positionLock);
+        uint32_t intervalUs = fineIntervalUs << stepShift;
+        timerIntervalUs = intervalUs;
+        timerAlarmWrite(stepTimer, intervalUs, true);
+        portEXIT_CRITICAL(&positionLock);
+    }
+}
+
+// Com o timer parado a fase está alinhada a qualquer resolução mais fina
+void StepperController::restoreFineMicrostep() {
+    pendingShift = 0;
+    if (stepShift == 0) return;
+    uint8_t previousShift = stepShift;
+    stepShift = 0;
+    applyShift(0, previousShift);
+}
+
+void StepperController::stopVelocityMode() {
+    targetSpeed = 0;
+    currentSpeed = 0;
+    applySpeed();
+}
+
+float StepperController::getCurrentSpeed() {
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    if (rmtMoveActive) {
+        // Velocidade do último passo codificado, no máximo 64 símbolos à frente
+        uint32_t interval = rmtEncoder.lastInterval();
+        return interval > 0 ? stepSign * (float)RMT_TICKS_PER_SECOND / interval : 0;
+    }
+#endif
+    return currentSpeed;
+}
+
+bool StepperController::isStopped() {
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    if (rmtMoveActive) return false;
+#endif
+    return !timerRunning;
+}
+
+void StepperController::abortMotion() {
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    if (rmtMoveActive) {
+        rmt_tx_stop((rmt_channel_t)RMT_STEP_CHANNEL);
+        // Sob a trava: uma interrupção pendente não conta a mesma metade de novo
+        portENTER_CRITICAL(&positionLock);
+        rmtEnding = true;
+        countRmtSteps(rmtStepsSent());
+        rmtHalfSteps[0] = 0;
+        rmtHalfSteps[1] = 0;
+        portEXIT_CRITICAL(&positionLock);
+        rmtTransmitting = false;
+        finishRmtMove();
+    }
+#endif
+    stopVelocityMode();
+    stopArmed = false;
+    positionMoveActive = false;
+}
+
+void StepperController::startPositionMove(int64_t target, float maxSpeed, float stepsPerSec2) {
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    // O micro-passo automático troca a resolução entre pulsos: fica no timer
+    if (!autoMicrostep && enabled) {
+        startRmtMove(target, maxSpeed, stepsPerSec2);
+        return;
+    }
+#endif
+    portENTER_CRITICAL(&positionLock);
+    stopPosition = target;
+    stopArmed = true;
+    portEXIT_CRITICAL(&positionLock);
+
+    positionMoveTarget = target;
+    positionMoveMaxSpeed = maxSpeed;
+    acceleration = stepsPerSec2;
+    startVelocityMode();
+    positionMoveActive = true;
+}
+
+// A cada chamada limita a velocidade à que ainda permite frear até o alvo
+// (v = sqrt(2·a·d)); a ISR garante a parada exata mesmo com a rampa atrasada
+bool StepperController::updatePositionMove() {
+    if (!positionMoveActive) return false;
+
+#if STEP_BACKEND == STEP_BACKEND_RMT
+    if (rmtMoveActive) {
+        if (rmtTransmitting) return true;
+        finishRmtMove();
+        return false;
+    }
+#endif
+
+    int64_t remaining = positionMoveTarget - getAbsolutePosition();
+    if (remaining == 0) {
+        stopVelocityMode();
+        stopArmed = false;
+        positionMoveActive = false;
+        return false;
+    }
+
+    float distance = remaining > 0 ? (float)remaining : (float)-remaining;
+    float speed = min(positionMoveMaxSpeed, (float)sqrt(2.0 * acceleration * distance));
+    setTargetSpeed(remaining > 0 ? speed : -speed);
+    updateVelocity();
+    return true;
+}
+
+#if STEP_BACKEND == STEP_BACKEND_RMT
+// Canal do RMT sem rmt_driver_install(): a ISR própria recodifica a memória
+// do canal. Fora dos movimentos o pino continua no GPIO, para o timer e
+// pulseStep().
+void StepperController::beginRmt() {
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)STEP_PIN, (rmt_channel_t)RMT_STEP_CHANNEL);
+    config.clk_div = RMT_CLOCK_DIV;
+    config.mem_block_num = 1;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    rmt_config(&config);
+
+    RMT.apb_conf.fifo_mask = 1;         // CPU escreve direto na memória do canal
+    RMT.apb_conf.mem_tx_wrap_en = 1;    // No fim do bloco a leitura volta ao início
+    rmt_isr_register(onRmtInterrupt, NULL, ESP_INTR_FLAG_IRAM, NULL);
+    rmt_set_tx_thr_intr_en((rmt_channel_t)RMT_STEP_CHANNEL, true, RMT_HALF_SYMBOLS);
+    rmt_set_tx_intr_en((rmt_channel_t)RMT_STEP_CHANNEL, true);
+
+    pinMode(STEP_PIN, OUTPUT);
+    tracedWrite(STEP_PIN, LOW);
+}
+
+void StepperController::startRmtMove(int64_t target, float maxSpeed, float stepsPerSec2) {
+    positionMoveTarget = target;
+    int64_t distance = target - getAbsolutePosition();
+    if (distance == 0) {
+        positionMoveActive = false;
+        return;
+    }
+
+    // Sentido e folga ainda pelo GPIO, antes de o RMT assumir o pino
+    bool clockwise = distance > 0;
+    prepareMotion(clockwise);
+    stepSign = clockwise ? 1 : -1;
+
+    StepProfile profile;
+    profile.steps = (uint32_t)(clockwise ? distance : -distance);
+    profile.maxSpeed = min(maxSpeed, (float)RMT_MAX_STEP_RATE);
+    profile.acceleration = stepsPerSec2;
+    profile.ticksPerSecond = RMT_TICKS_PER_SECOND;
+    profile.pulseTicks = (uint16_t)(STEP_PULSE_US * (RMT_TICKS_PER_SECOND / 1000000UL));
+    rmtEncoder.begin(profile);
+
+    // As duas metades saem preenchidas; a ISR assume a partir da primeira
+    rmtHalfSteps[0] = 0;
+    rmtHalfSteps[1] = 0;
+    rmtActiveHalf = 0;
+    rmtEnding = false;
+    refillRmtHalf(0);
+    if (!rmtEnding) refillRmtHalf(1);
+
+    rmtTransmitting = true;
+    rmtMoveActive = true;
+    positionMoveActive = true;
+    Metrics::setGauge(GAUGE_STEP_RATE, (int32_t)profile.maxSpeed);
+    rmt_set_gpio((rmt_channel_t)RMT_STEP_CHANNEL, RMT_MODE_TX, (gpio_num_t)STEP_PIN, false);
+    rmt_tx_start((rmt_channel_t)RMT_STEP_CHANNEL, true);
+}
+
+void StepperController::finishRmtMove() {
+    pinMode(STEP_PIN, OUTPUT);      // Devolve o pino ao GPIO
+    tracedWrite(STEP_PIN, LOW);
+    rmtMoveActive = false;
+    positionMoveActive = false;
+}
+
+// Passos emitidos e ainda não contados, com o transmissor parado: a metade
+// em transmissão até o símbolo em leitura (o pulso sai no início dele) e,
+// se a ISR ainda não contou a metade anterior, ela inteira
+uint32_t StepperController::rmtStepsSent() {
+    uint32_t read = (RMT.status_ch[RMT_STEP_CHANNEL].mem_raddr_ex - RMT_STEP_CHANNEL * RMT_BLOCK_SYMBOLS)
+                    & (RMT_BLOCK_SYMBOLS - 1);
+    uint8_t half = rmtActiveHalf;
+    uint32_t steps = 0;
+    if (read / RMT_HALF_SYMBOLS != half) {
+        steps += rmtHalfSteps[half];
+        half ^= 1;
+    }
+    for (uint32_t i = half * RMT_HALF_SYMBOLS; i <= read; i++) {
+        if (RMTMEM.chan[RMT_STEP_CHANNEL].data32[i].level0) steps++;
+    }
+    return steps;
+}
+
+// Codifica a próxima parte do movimento numa metade da memória do canal.
+// Com o movimento no fim (ou a emergência acionada) grava o marcador de fim.
+void IRAM_ATTR StepperController::refillRmtHalf(uint8_t half) {
+    uint32_t symbols[RMT_HALF_SYMBOLS];
+    uint32_t steps = 0;
+    size_t count = 0;
+    if (!EmergencyStop::isTripped()) {
+        count = rmtEncoder.fill(symbols, RMT_HALF_SYMBOLS, steps);
+    }
+
+    volatile rmt_item32_t* memory = &RMTMEM.chan[RMT_STEP_CHANNEL].data32[half * RMT_HALF_SYMBOLS];
+    for (size_t i = 0; i < count; i++) {
+        memory[i].val = symbols[i];
+    }
+    if (count < RMT_HALF_SYMBOLS) {
+        memory[count].val = 0;
+        rmtEnding = true;
+    }
+    rmtHalfSteps[half] = steps;
+}
+
+// Passos já transmitidos pelo RMT, sempre na resolução escolhida
+void IRAM_ATTR StepperController::countRmtSteps(uint32_t steps) {
+    absolutePosition += stepSign * (int64_t)steps;
+    driverPhase += stepSign * steps * phasePerStep;
+}
+
+// Limiar: a metade em transmissão terminou e a outra já está saindo.
+// Fim: o marcador foi alcançado, o que sobrou nas duas metades saiu.
+void IRAM_ATTR StepperController::onRmtInterrupt(void* arg) {
+    uint32_t status = RMT.int_st.val & (RMT_TX_END_BIT | RMT_TX_THR_BIT);
+    RMT.int_clr.val = status;
+
+    if (status & RMT_TX_THR_BIT) {
+        portENTER_CRITICAL_ISR(&positionLock);
+        uint8_t half = rmtActiveHalf;
+        uint32_t steps = rmtHalfSteps[half];
+        countRmtSteps(steps);
+        rmtHalfSteps[half] = 0;
+        rmtActiveHalf = half ^ 1;
+        bool refill = !rmtEnding;
+        portEXIT_CRITICAL_ISR(&positionLock);
+
+        Metrics::count(CNT_STEPS_EMITTED, steps);
+        if (refill) refillRmtHalf(half);
+    }
+
+    if (status & RMT_TX_END_BIT) {
+        portENTER_CRITICAL_ISR(&positionLock);
+        uint32_t steps = rmtHalfSteps[0] + rmtHalfSteps[1];
+        countRmtSteps(steps);
+        rmtHalfSteps[0] = 0;
+        rmtHalfSteps[1] = 0;
+        portEXIT_CRITICAL_ISR(&positionLock);
+
+        Metrics::count(CNT_STEPS_EMITTED, steps);
+        rmtTransmitting = false;
+    }
+}
+#endif
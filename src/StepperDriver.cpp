@@ -0,0 +1,179 @@
+#include "StepperDriver.h"
+#include "PinTrace.h"
+
+// Pulso no RESET: os pulsos de STEP são ignorados com ele em LOW, e o
+// tradutor volta ao Home (45° elétricos, uma posição de passo inteiro)
+static void resetDriverTranslator() {
+#if DRIVER_RESET_PIN >= 0
+    digitalWrite(DRIVER_RESET_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(DRIVER_RESET_PIN, HIGH);
+    delayMicroseconds(5);
+#endif
+}
+
+// ================= A4988 =================
+
+const uint16_t A4988Driver::multipliers[A4988Driver::MICROSTEP_COUNT] = {1, 2, 4, 8, 16};
+const char* const A4988Driver::labels[A4988Driver::MICROSTEP_COUNT] = {
+    "Full Step", "1/2 Step", "1/4 Step", "1/8 Step", "1/16 Step"
+};
+
+void A4988Driver::begin() {
+    pinMode(MS1_PIN, OUTPUT);
+    pinMode(MS2_PIN, OUTPUT);
+    pinMode(MS3_PIN, OUTPUT);
+#if DRIVER_RESET_PIN >= 0
+    pinMode(DRIVER_RESET_PIN, OUTPUT);
+    resetTranslator();
+#endif
+}
+
+void A4988Driver::resetTranslator() {
+    resetDriverTranslator();
+}
+
+// Tabela de configuração do A4988
+// Index   | MS1   | MS2   | MS3   | Resolução
+// ------------------------------------------------
+// 0 (Full)| LOW   | LOW   | LOW   | 1
+// 1 (Half)| HIGH  | LOW   | LOW   | 1/2
+// 2 (1/4) | LOW   | HIGH  | LOW   | 1/4
+// 3 (1/8) | HIGH  | HIGH  | LOW   | 1/8
+// 4 (1/16)| HIGH  | HIGH  | HIGH  | 1/16
+const uint8_t A4988Driver::modeBits[A4988Driver::MICROSTEP_COUNT] = {0b000, 0b001, 0b010, 0b011, 0b111};
+
+void A4988Driver::applyMicrostep(int index) {
+    uint8_t bits = modeBits[index];
+
+    tracedWrite(MS1_PIN, (bits & 0b001) ? HIGH : LOW);
+    tracedWrite(MS2_PIN, (bits & 0b010) ? HIGH : LOW);
+    tracedWrite(MS3_PIN, (bits & 0b100) ? HIGH : LOW);
+}
+
+// ================= DRV8825 =================
+
+const uint16_t DRV8825Driver::multipliers[DRV8825Driver::MICROSTEP_COUNT] = {1, 2, 4, 8, 16, 32};
+const char* const DRV8825Driver::labels[DRV8825Driver::MICROSTEP_COUNT] = {
+    "Full Step", "1/2 Step", "1/4 Step", "1/8 Step", "1/16 Step", "1/32 Step"
+};
+
+void DRV8825Driver::begin() {
+    pinMode(MS1_PIN, OUTPUT);
+    pinMode(MS2_PIN, OUTPUT);
+    pinMode(MS3_PIN, OUTPUT);
+#if DRIVER_RESET_PIN >= 0
+    pinMode(DRIVER_RESET_PIN, OUTPUT);
+    resetTranslator();
+#endif
+}
+
+void DRV8825Driver::resetTranslator() {
+    resetDriverTranslator();
+}
+
+// Tabela de configuração do DRV8825 (M0 = MS1, M1 = MS2, M2 = MS3)
+// Index   | M0    | M1    | M2    | Resolução
+// ------------------------------------------------
+// 0 (Full)| LOW   | LOW   | LOW   | 1
+// 1 (Half)| HIGH  | LOW   | LOW   | 1/2
+// 2 (1/4) | LOW   | HIGH  | LOW   | 1/4
+// 3 (1/8) | HIGH  | HIGH  | LOW   | 1/8
+// 4 (1/16)| LOW   | LOW   | HIGH  | 1/16
+// 5 (1/32)| HIGH  | LOW   | HIGH  | 1/32
+const uint8_t DRV8825Driver::modeBits[DRV8825Driver::MICROSTEP_COUNT] = {0b000, 0b001, 0b010, 0b011, 0b100, 0b101};
+
+void DRV8825Driver::applyMicrostep(int index) {
+    uint8_t bits = modeBits[index];
+
+    tracedWrite(MS1_PIN, (bits & 0b001) ? HIGH : LOW);
+    tracedWrite(MS2_PIN, (bits & 0b010) ? HIGH : LOW);
+    tracedWrite(MS3_PIN, (bits & 0b100) ? HIGH : LOW);
+}
+
+// ================= TMC2209 =================
+
+const uint16_t TMC2209Driver::multipliers[TMC2209Driver::MICROSTEP_COUNT] = {
+    1, 2, 4, 8, 16, 32, 64, 128, 256
+};
+const char* const TMC2209Driver::labels[TMC2209Driver::MICROSTEP_COUNT] = {
+    "Full Step", "1/2 Step", "1/4 Step", "1/8 Step", "1/16 Step",
+    "1/32 Step", "1/64 Step", "1/128 Step", "1/256 Step"
+};
+
+// Bits de GCONF
+#define TMC_GCONF_I_SCALE_ANALOG   (1UL << 0)  // Corrente de escala pelo VREF
+#define TMC_GCONF_PDN_DISABLE      (1UL << 6)  // PDN_UART usado como UART
+#define TMC_GCONF_MSTEP_REG_SELECT (1UL << 7)  // Micro-passo pelo registrador MRES
+#define TMC_GCONF_MULTISTEP_FILT   (1UL << 8)
+
+// Campos de CHOPCONF
+#define TMC_CHOPCONF_DEFAULT       0x10000053UL // TOFF=3, HSTRT=5, intpol=1 (valor de reset)
+#define TMC_CHOPCONF_MRES_SHIFT    24
+#define TMC_CHOPCONF_MRES_MASK     (0x0FUL << TMC_CHOPCONF_MRES_SHIFT)
+#define TMC_CHOPCONF_INTPOL        (1UL << 28)  // Interpola para 1/256 internamente
+
+TMC2209Driver::TMC2209Driver(Stream& uartPort, uint8_t slaveAddress)
+    : port(uartPort), address(slaveAddress) {
+    chopconf = TMC_CHOPCONF_DEFAULT;
+}
+
+void TMC2209Driver::begin() {
+    // MS1/MS2 definem o endereço UART do TMC2209
+    pinMode(MS1_PIN, OUTPUT);
+    pinMode(MS2_PIN, OUTPUT);
+    tracedWrite(MS1_PIN, (address & 0x01) ? HIGH : LOW);
+    tracedWrite(MS2_PIN, (address & 0x02) ? HIGH : LOW);
+
+    writeRegister(REG_GCONF, TMC_GCONF_I_SCALE_ANALOG | TMC_GCONF_PDN_DISABLE |
+                             TMC_GCONF_MSTEP_REG_SELECT | TMC_GCONF_MULTISTEP_FILT);
+    setCurrents(TMC_RUN_CURRENT, TMC_HOLD_CURRENT);
+}
+
+void TMC2209Driver::applyMicrostep(int index) {
+    // MRES: 0 = 1/256 ... 8 = full step
+    uint32_t mres = (MICROSTEP_COUNT - 1) - index;
+    chopconf = (chopconf & ~TMC_CHOPCONF_MRES_MASK) | (mres << TMC_CHOPCONF_MRES_SHIFT) | TMC_CHOPCONF_INTPOL;
+    writeRegister(REG_CHOPCONF, chopconf);
+}
+
+void TMC2209Driver::setCurrents(uint8_t runCurrent, uint8_t holdCurrent) {
+    // IHOLD (bits 0-4), IRUN (bits 8-12), IHOLDDELAY (bits 16-19)
+    uint32_t value = (uint32_t)(holdCurrent & 0x1F) |
+                     ((uint32_t)(runCurrent & 0x1F) << 8) |
+                     ((uint32_t)TMC_HOLD_DELAY << 16);
+    writeRegister(REG_IHOLD_IRUN, value);
+}
+
+// Datagrama de escrita: sync, endereço, registrador | 0x80, 4 bytes de dados (MSB primeiro), CRC
+void TMC2209Driver::writeRegister(uint8_t reg, uint32_t value) {
+    uint8_t datagram[8];
+    datagram[0] = 0x05;
+    datagram[1] = address;
+    datagram[2] = reg | 0x80;
+    datagram[3] = (value >> 24) & 0xFF;
+    datagram[4] = (value >> 16) & 0xFF;
+    datagram[5] = (value >> 8) & 0xFF;
+    datagram[6] = value & 0xFF;
+    datagram[7] = crc8(datagram, 7);
+
+    port.write(datagram, sizeof(datagram));
+    port.flush();
+}
+
+// CRC8 do datasheet do TMC2209 (polinômio x^8 + x^2 + x + 1, bits do LSB para o MSB)
+uint8_t TMC2209Driver::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t current = data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            if ((crc >> 7) ^ (current & 0x01)) {
+                crc = (crc << 1) ^ 0x07;
+            } else {
+                crc = crc << 1;
+            }
+            current >>= 1;
+        }
+    }
+    return crc;
+}
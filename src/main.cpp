@@ -2,28 +2,80 @@
 #include "StepperController.h"
 #include "DisplayManager.h"
 #include "EncoderHandler.h"
+#include "PowerManager.h"
+#include "MotionTask.h"
 #include "config.h"
-#include "logo.h"
+#include "Metrics.h"
+#include "MotionMath.h"
+#include "Benchmark.h"
+#include "InputTrace.h"
+#include "EmergencyStop.h"
+#include "PinTrace.h"
+#include "History.h"
+#include "MenuTree.h"
+#include "ResumeState.h"
+#include "Assets.h"
 
 // Protótipos das funções
+void showMenu();
 void handleMainMenu();
 void handleRunningCycle();
 // void handleAngleSetup();
 void handlePositioning();
 void handleMotorDisabled();
-void startFullCycle();
-void finishCycle();
+void finishBatch();
+void startBatch(int totalCycles);
+void commandQueueFull(const char* operation);
+void showCycleScreen();
+int batchPartsPerHour();
+void pauseCycle();
+void handleCyclePaused();
+void startSingleCycle();
+void openBatchSetup();
+void startBatchFromEditor();
+void openIndexSetup();
+void handleIndexSetup();
+void openPositioningSetup();
+void openAbsolutePositioningSetup();
 void startPositioning(int targetStep);
+void handleAbsolutePositioningSetup();
+void startAbsolutePositioning(int64_t target);
 void handlePositioningSetup(); 
+void openMicrostepSetup();
 void handleMicrostepSetup();
 void applyMicrostepSetting(int setting);
-void handleRelayTimeSetup();
-void handleRelayOffTimeSetup();
+void openNumberEditor(const NumberEditor& editor);
+void handleNumberEditor();
+void applyRelayTiming();
+void openSpeedSetup();
+void showSpeedSetup();
+void handleSpeedSetup();
+void openHistoryStats();
+void handleHistoryStats();
+int maxSpeedSetting(int mode);
+void applySpeedProfiles();
+void disableMotor();
+void openDiagnostics();
+void handleDiagnostics();
+void handleSerialCommands();
+bool isSystemIdle();
+void startJog();
+void handleJog();
+void enterEmergencyStop();
+void handleEmergencyStop();
+bool loadResumePoint();
+void showResumePrompt();
+void openResumePrompt();
+void handleResumePrompt();
+void resumeBatch();
 
 // Instâncias dos controladores
 StepperController stepper;
 DisplayManager display;
 EncoderHandler encoder;
+// Motor e relé ficam com a tarefa de movimento; a interface só envia comandos
+MotionTask motion(stepper);
+PowerManager power(motion, encoder);
 
 // Variáveis de estado
 enum SystemState {
@@ -34,21 +86,18 @@ enum SystemState {
   POSITIONING_SETUP,
   MOTOR_DISABLED,
   MICROSTEP_SETUP,
-  RELAY_TIME_SETUP,
-  RELAY_OFF_TIME_SETUP
+  NUMBER_EDITOR,
+  DIAGNOSTICS,
+  JOG,
+  CYCLE_PAUSED,
+  ABSOLUTE_POSITIONING_SETUP,
+  INDEX_SETUP,
+  EMERGENCY_STOP,
+  SPEED_SETUP,
+  HISTORY_STATS,
+  RESUME_PROMPT
 };
 
-const char* menuItems[] = {
-  "1. Ciclo Completo",
-  "2. Posicionamento",
-  "3. Micro-passo",
-  "4. Tempo do Rele",
-  "5. Tempo Rele Desl.",
-  "6. Desligar Motor"
-  // Adicione mais itens aqui se precisar no futuro
-};
-const int totalMenuItems = sizeof(menuItems) / sizeof(char*);
-
 SystemState currentState = MENU_MAIN;
 int targetAngle = 0;
 int currentPosition = 0; // Posição atual em steps (0-199)
@@ -58,67 +107,180 @@ bool motorEnabled = true;
 // --- NOVAS VARIÁVEIS PARA MICRO-PASSO ---
 // 0=Full, 1=Half, 2=1/4, 3=1/8, 4=1/16
 int currentMicrostep = 0; // Inicia em Full Step por padrão
-// Array com os multiplicadores de passo
-const int microstepMultipliers[] = {1, 2, 4, 8, 16};
+// Multiplicadores de passo do driver selecionado em config.h (STEPPER_DRIVER)
+const uint16_t* const microstepMultipliers = ActiveDriver::multipliers;
+// Micro-passo automático: resolução mais fina parada/devagar, mais grossa nas
+// rampas rápidas. É a última opção do menu Micro-passo.
+bool autoMicrostep = false;
+#if AUTO_MICROSTEP_SUPPORTED
+const int MICROSTEP_OPTION_COUNT = ActiveDriver::MICROSTEP_COUNT + 1;
+#else
+const int MICROSTEP_OPTION_COUNT = ActiveDriver::MICROSTEP_COUNT;
+#endif
+const int AUTO_MICROSTEP_OPTION = ActiveDriver::MICROSTEP_COUNT;
+const char* microstepOptions[MICROSTEP_OPTION_COUNT];
 // Variável para guardar os passos por volta atuais
 int activeStepsPerRev = BASE_STEPS_PER_REV;
 
-// Variáveis para controle de timing
-unsigned long lastStepTime = 0;
-unsigned long relayStartTime = 0;
-int cycleStep = 0; // 0: relay on, 1: relay off wait, 2: move step, 3: step wait
-int cyclePosition = 0; // posição atual no ciclo completo
+// Último estado publicado pela tarefa de movimento (lido a cada loop)
+MotionStatus motionStatus;
+
+// Progresso do ciclo já mostrado no display
+int shownCyclePosition = -1;
+int shownCyclesCompleted = -1;
+
+// Posicionamento: instante em que o movimento terminou (0 = em andamento)
+unsigned long positioningDoneTime = 0;
+
+// Posicionamento absoluto (multivoltas): volta e passo alvo em edição
+int32_t absTargetRevolution = 0;
+int absTargetStep = 0;
+bool absEditingRevolution = true;   // true = editando a volta, false = o passo
+
+// Variáveis do lote de produção (N ciclos seguidos)
+int batchTotal = 1;                 // Ciclos no lote atual (editado na tela de lote)
+bool batchIndexing = false;         // O lote usa o modo indexador
+int indexStations = INDEX_DEFAULT_STATIONS; // Estações do indexador (0 = tabela de config.h)
+unsigned long batchStartTime = 0;
+int batchStartCycles = 0;           // Ciclos já concluídos ao iniciar/retomar (fora das peças/hora)
+unsigned long batchPausedTime = 0;  // Tempo total em pausa (fora do cálculo de peças/hora)
+unsigned long pauseStartTime = 0;
+int pauseSelection = 0;             // 0 = Continuar, 1 = Cancelar
 
+// Lote interrompido por um reinício (ResumeState), oferecido na partida
+ResumeSnapshot resumePoint;
+bool resumeOffered = false;         // Aguardando a decisão do operador
+int resumeSelection = 0;            // 0 = Continuar, 1 = Descartar
+
+// Variáveis do modo Jog
+unsigned long jogLastDetentTime = 0;
+float jogDetentRate = 0;            // Passos do encoder por segundo (com sinal)
+bool jogStopping = false;
+
+// Velocidade de cada modo em RPM (menu Velocidades), na ordem de SpeedMode
+int speedRpm[SPEED_MODE_COUNT] = {POSITIONING_DEFAULT_RPM, CYCLE_DEFAULT_RPM, JOG_DEFAULT_RPM};
+const char* const speedModeNames[SPEED_MODE_COUNT] = {"Posicion.", "Ciclo", "Jog"};
+int speedSelection = 0;             // Modo em foco (SPEED_MODE_COUNT = Voltar)
+bool speedEditing = false;          // true = o encoder ajusta o RPM do modo em foco
+
+// Redesenha o menu ao voltar de uma tela, no nível de onde ela foi aberta
 bool resetMenuState = false;
-unsigned long RELAY_ON_TIME = 1000;
-unsigned long STEP_SETTLE_TIME = 1000;
+int RELAY_ON_TIME = 1000;
+int STEP_SETTLE_TIME = 1000;
+
+// Editor numérico aberto (estado NUMBER_EDITOR) e o valor ainda não confirmado
+const NumberEditor* activeEditor = NULL;
+int editorValue = 0;
+
+// ================= Árvore de menus =================
+// Fica na flash; para um item novo basta uma linha aqui (e o tratador)
+
+constexpr NumberEditor relayOnEditor = {"TEMPO DO RELE", "s", &RELAY_ON_TIME, 50, 5000, 50, 1000, applyRelayTiming};
+constexpr NumberEditor relayOffEditor = {"TEMPO RELE DESL.", "s", &STEP_SETTLE_TIME, 50, 5000, 50, 1000, applyRelayTiming};
+constexpr NumberEditor batchEditor = {"CICLO EM LOTE", "ciclos", &batchTotal, 1, BATCH_MAX_CYCLES, 1, 1, startBatchFromEditor};
+
+constexpr MenuNode motionMenuItems[] = {
+  menuAction("Posicionamento", openPositioningSetup),
+  menuAction("Posicao Absoluta", openAbsolutePositioningSetup),
+  menuAction("Jog Manual", startJog)
+};
+
+constexpr MenuNode settingsMenuItems[] = {
+  menuAction("Micro-passo", openMicrostepSetup),
+  menuNumber("Tempo do Rele", relayOnEditor),
+  menuNumber("Tempo Rele Desl.", relayOffEditor),
+  menuAction("Velocidades", openSpeedSetup)
+};
+
+constexpr MenuNode mainMenuItems[] = {
+  menuAction("Ciclo Completo", startSingleCycle),
+  menuAction("Ciclo em Lote", openBatchSetup),
+  menuAction("Indexador", openIndexSetup),
+  menuSubmenu("Movimento", motionMenuItems),
+  menuSubmenu("Configuracoes", settingsMenuItems),
+  menuAction("Desligar Motor", disableMotor),
+  menuAction("Diagnostico", openDiagnostics),
+  menuAction("Historico", openHistoryStats)
+};
+
+constexpr MenuNode mainMenu = menuSubmenu("Menu Principal", mainMenuItems);
+static_assert(menuDepth(mainMenu) <= MENU_MAX_DEPTH, "Aumente MENU_MAX_DEPTH em config.h");
+
+MenuNavigator menu(mainMenu);
 
 void setup() {
   Serial.begin(115200);
+  Metrics::reset();
 
-  // --- INICIALIZAÇÃO DOS PINOS DE MICRO-PASSO ---
-  pinMode(MS1_PIN, OUTPUT);
-  pinMode(MS2_PIN, OUTPUT);
-  pinMode(MS3_PIN, OUTPUT);
-  
-  // Inicializa os componentes
+  // Inicializa os componentes (os pinos de micro-passo são configurados pelo driver)
   stepper.begin();
+  EmergencyStop::begin(); // Antes de qualquer saída ser energizada
+  ResumeState::begin();
   display.begin();
   encoder.begin();
-  
-  // Configuração do relé
-  pinMode(RELAY_PIN, OUTPUT);
-  digitalWrite(RELAY_PIN, HIGH);
+  power.begin();
+  History::begin(); // Pode apagar setores da flash: antes da tarefa de movimento
 
-  // Aplica a configuração de micro-passo inicial (Full Step)
-  applyMicrostepSetting(currentMicrostep);
-  
-  Adafruit_SSD1306* logoDisplay = display.getDisplay();
-
-  logoDisplay->clearDisplay();
-  logoDisplay->drawBitmap(
-      0, 0,
-      epd_bitmap_logo,
-      128, 64,
-      SSD1306_WHITE
-  );
-  logoDisplay->display(); // Mostra o logo no display
-  delay(2500);
-  logoDisplay->clearDisplay(); // Limpa o display após mostrar o logo
-
-  // Tela inicial
-  // display.showMainMenu();
-
-  // Tela inicial
-  // MODIFICADO: Primeira chamada para a função de menu atualizada
-  display.showMainMenu(menuItems, totalMenuItems, 0, 0);
+  // Configuração de antes do reinício, se houver (antes da tarefa de movimento)
+  bool resumeLoaded = loadResumePoint();
+
+  // A partir daqui o motor e o relé são controlados pela tarefa de movimento
+  motion.begin();
+  motion.setRelayTiming(RELAY_ON_TIME, STEP_SETTLE_TIME);
+
+  // Aplica a configuração de micro-passo inicial (Full Step, ou a restaurada)
+  for (int i = 0; i < MICROSTEP_OPTION_COUNT; i++) {
+    microstepOptions[i] = i == AUTO_MICROSTEP_OPTION ? "Auto" : ActiveDriver::labels[i];
+  }
+  applyMicrostepSetting(autoMicrostep ? AUTO_MICROSTEP_OPTION : currentMicrostep);
+
+  // Sem lote a retomar, só a posição volta (depois do micro-passo, que a zera)
+  if (resumeLoaded && !resumeOffered) {
+    motion.restoreResumePoint(false);
+  }
+
+  if (resumeOffered) {
+    // O lote interrompido vai direto para a tela de retomada, sem o logo
+    openResumePrompt();
+  } else {
+    // Mostra o logo pelo mesmo caminho de flush das demais telas
+    display.showBitmap(logoBitmap);
+    delay(2500);
+    display.clear(); // Limpa o display após mostrar o logo
+
+    // Tela inicial
+    // display.showMainMenu();
+
+    // Tela inicial
+    showMenu();
+  }
   
   Serial.println("Sistema inicializado");
 }
 
 void loop() {
+  uint32_t loopStart = micros();
+
   // Atualiza encoder
   encoder.update();
+
+  // Estado do motor publicado pela tarefa de movimento
+  motionStatus = motion.getStatus();
+  if (motion.isCaughtUp(motionStatus)) {
+    currentPosition = motionStatus.position;
+  }
+  // Latências entrada -> movimento e entrada -> painel medidas na mesma tarefa
+  // que reproduz os eventos
+  InputTrace::observeMotion(motionStatus.phase != PHASE_IDLE);
+  display.reportFlushes();
+
+  // A parada de emergência interrompe qualquer tela
+  if (motionStatus.emergencyStop && currentState != EMERGENCY_STOP) {
+    enterEmergencyStop();
+  }
+
+  // Comandos de diagnóstico pela serial
+  handleSerialCommands();
   
   // Máquina de estados principal
   switch(currentState) {
@@ -150,109 +312,197 @@ void loop() {
       handleMicrostepSetup();
       break;
 
-    case RELAY_TIME_SETUP:
-      handleRelayTimeSetup();
+    case NUMBER_EDITOR:
+      handleNumberEditor();
       break;
-    
-    case RELAY_OFF_TIME_SETUP: // <-- NOVO CASE
-      handleRelayOffTimeSetup();
+
+    case DIAGNOSTICS:
+      handleDiagnostics();
+      break;
+
+    case JOG:
+      handleJog();
+      break;
+
+    case CYCLE_PAUSED:
+      handleCyclePaused();
+      break;
+
+    case ABSOLUTE_POSITIONING_SETUP:
+      handleAbsolutePositioningSetup();
+      break;
+
+    case INDEX_SETUP:
+      handleIndexSetup();
+      break;
+
+    case EMERGENCY_STOP:
+      handleEmergencyStop();
+      break;
+
+    case SPEED_SETUP:
+      handleSpeedSetup();
+      break;
+
+    case HISTORY_STATS:
+      handleHistoryStats();
+      break;
+
+    case RESUME_PROMPT:
+      handleResumePrompt();
       break;
   }
   
+  Metrics::recordTime(TMR_LOOP, micros() - loopStart);
+  Metrics::count(CNT_LOOP_ITERATIONS);
+
+  // Libera o torque e dorme quando não há atividade
+  power.update(isSystemIdle(), motorEnabled);
+
   delay(10); // Pequeno delay para estabilidade
 }
 
-void handleMainMenu() {
-  // MODIFICADO: Variáveis de estado do menu
-  static int menuIndex = 0;         // Item atualmente selecionado
-  static int menuStartIndex = 0;    // Item no topo da "janela" visível
+// Estados em que nada se move nem precisa ser atualizado periodicamente
+bool isSystemIdle() {
+  return currentState != RUNNING_CYCLE &&
+         currentState != POSITIONING &&
+         currentState != DIAGNOSTICS &&
+         currentState != JOG &&
+         currentState != CYCLE_PAUSED;
+}
+
+void showMenu() {
+  display.showMainMenu(menu.current(), menu.selected(), menu.top(), !menu.atRoot());
+}
 
+void handleMainMenu() {
   if (resetMenuState) {
-    menuIndex = 0;
-    menuStartIndex = 0;
     resetMenuState = false; // Desativa o sinalizador
-    // Redesenha o menu com o estado reiniciado
-    display.showMainMenu(menuItems, totalMenuItems, menuIndex, menuStartIndex);
+    showMenu();
   }
 
   int direction = encoder.getDirection();
-  
   if (direction != 0) {
-    // Navega pelo índice
-    menuIndex += direction;
-    
-    // Lógica para o índice "dar a volta" na lista
-    if (menuIndex < 0) menuIndex = totalMenuItems - 1;
-    if (menuIndex >= totalMenuItems) menuIndex = 0;
-
-    // --- LÓGICA DE ROLAGEM (SCROLL) DA JANELA ---
-    // Se o item selecionado estiver acima da janela visível, rola para cima
-    if (menuIndex < menuStartIndex) {
-      menuStartIndex = menuIndex;
-    }
-    // Se o item selecionado estiver abaixo da janela visível, rola para baixo
-    if (menuIndex >= menuStartIndex + MAX_VISIBLE_MENU_ITEMS) {
-      menuStartIndex = menuIndex - MAX_VISIBLE_MENU_ITEMS + 1;
-    }
-    
-    // O display agora só precisa saber qual item está no topo e qual está selecionado
-    display.showMainMenu(menuItems, totalMenuItems, menuIndex, menuStartIndex);
+    menu.move(direction);
+    showMenu();
   }
-  
-  // A lógica de seleção não muda, continua usando o menuIndex
+
   if (encoder.isPressed()) {
-    switch (menuIndex) {
-      case 0: // Ciclo completo
-        startFullCycle();
-        break;
-      case 1: // Posicionamento
-        currentState = POSITIONING_SETUP;
-        targetStepValue = currentPosition;
-        // targetAngle = 0;
-        display.showPositioningSetup(targetStepValue);
-        break;
-      case 2: // Configurar Micro-passo
-        currentState = MICROSTEP_SETUP;
-        display.showMicrostepSetup(currentMicrostep);
-        break;
-      case 3: // Tempo do Relé <-- NOVA OPÇÃO
-        currentState = RELAY_TIME_SETUP;
-        // Chama a nova função de display (que criaremos a seguir)
-        display.showRelayTimeSetup(RELAY_ON_TIME);
-        break;
-      case 4: // Tempo do Relé Desligado
-        currentState = RELAY_OFF_TIME_SETUP;
-        display.showRelayOffTimeSetup(STEP_SETTLE_TIME);
-        break;
-      case 5: // Desabilitar motor
-        stepper.disable();
-        motorEnabled = false;
-        currentState = MOTOR_DISABLED;
-        display.showMotorDisabled();
-        break;
+    // Cada item leva o próprio tratador: sem switch por índice
+    const MenuNode* item = menu.select();
+    if (item == NULL) {
+      showMenu();   // Entrou num submenu ou voltou um nível
+    } else if (item->type == MENU_ACTION) {
+      item->action();
+    } else {
+      openNumberEditor(*item->editor);
     }
     delay(200);
   }
 }
 
-// Aplica a configuração de micro-passo nos pinos MS e atualiza a variável de passos
+void startSingleCycle() {
+  batchIndexing = false;
+  startBatch(1);
+}
+
+void openPositioningSetup() {
+  currentState = POSITIONING_SETUP;
+  targetStepValue = currentPosition;
+  // targetAngle = 0;
+  display.showPositioningSetup(targetStepValue);
+}
+
+void openMicrostepSetup() {
+  currentState = MICROSTEP_SETUP;
+  display.showMicrostepSetup(microstepOptions, MICROSTEP_OPTION_COUNT,
+                             autoMicrostep ? AUTO_MICROSTEP_OPTION : currentMicrostep);
+}
+
+void disableMotor() {
+  motion.setEnabled(false);
+  motorEnabled = false;
+  currentState = MOTOR_DISABLED;
+  display.showMotorDisabled();
+}
+
+void openDiagnostics() {
+  currentState = DIAGNOSTICS;
+  display.showDiagnostics();
+}
+
+void openBatchSetup() {
+  batchIndexing = false;
+  openNumberEditor(batchEditor);
+}
+
+// Posição absoluta (multivoltas)
+void openAbsolutePositioningSetup() {
+  currentState = ABSOLUTE_POSITIONING_SETUP;
+  absTargetRevolution = motionStatus.revolution;
+  absTargetStep = motionStatus.position;
+  absEditingRevolution = true;
+  display.showAbsolutePositioningSetup(absTargetRevolution, absTargetStep, absEditingRevolution);
+}
+
+void openIndexSetup() {
+  currentState = INDEX_SETUP;
+  display.showIndexSetup(indexStations);
+}
+
+// Velocidades por modo
+void openSpeedSetup() {
+  currentState = SPEED_SETUP;
+  speedSelection = 0;
+  speedEditing = false;
+  showSpeedSetup();
+}
+
+// Histórico de produção
+void openHistoryStats() {
+  currentState = HISTORY_STATS;
+  display.showHistoryStats(History::getStats());
+}
+
+// O editor trabalha numa cópia: o valor só muda ao confirmar
+void openNumberEditor(const NumberEditor& editor) {
+  activeEditor = &editor;
+  editorValue = *editor.value;
+  currentState = NUMBER_EDITOR;
+  display.showNumberEditor(editor, editorValue);
+}
+
+void handleNumberEditor() {
+  int direction = encoder.getDirection();
+  if (direction != 0) {
+    editorValue = constrain(editorValue + direction * activeEditor->step,
+                            activeEditor->min, activeEditor->max);
+    display.showNumberEditor(*activeEditor, editorValue);
+  }
+
+  if (encoder.isPressed()) {
+    *activeEditor->value = editorValue;
+    // apply() pode levar a outra tela (o lote inicia o ciclo)
+    currentState = MENU_MAIN;
+    resetMenuState = true;
+    activeEditor->apply();
+    delay(200);
+  }
+}
+
+void applyRelayTiming() {
+  motion.setRelayTiming(RELAY_ON_TIME, STEP_SETTLE_TIME);
+  Serial.printf("Tempos do rele: %d ms ligado, %d ms desligado\n", RELAY_ON_TIME, STEP_SETTLE_TIME);
+}
+
+// Aplica a configuração de micro-passo no driver e atualiza a variável de passos
 void applyMicrostepSetting(int setting) {
-  // Tabela de configuração do A4988
-  // Setting | MS1   | MS2   | MS3   | Resolução
-  // ------------------------------------------------
-  // 0 (Full)| LOW   | LOW   | LOW   | 1
-  // 1 (Half)| HIGH  | LOW   | LOW   | 1/2
-  // 2 (1/4) | LOW   | HIGH  | LOW   | 1/4
-  // 3 (1/8) | HIGH  | HIGH  | LOW   | 1/8
-  // 4 (1/16)| HIGH  | HIGH  | HIGH  | 1/16
-  
-  bool ms1 = (setting == 1 || setting == 3 || setting == 4);
-  bool ms2 = (setting == 2 || setting == 3 || setting == 4);
-  bool ms3 = (setting == 4);
+  // "Auto" trabalha (e conta a posição) na resolução mais fina do driver
+  autoMicrostep = setting == AUTO_MICROSTEP_OPTION;
+  if (autoMicrostep) setting = ActiveDriver::MICROSTEP_COUNT - 1;
 
-  digitalWrite(MS1_PIN, ms1 ? HIGH : LOW);
-  digitalWrite(MS2_PIN, ms2 ? HIGH : LOW);
-  digitalWrite(MS3_PIN, ms3 ? HIGH : LOW);
+  // O driver e a compensação de folga são ajustados pela tarefa de movimento
+  motion.setMicrostep(setting, autoMicrostep);
 
   // Atualiza a variável global de passos por revolução
   activeStepsPerRev = BASE_STEPS_PER_REV * microstepMultipliers[setting];
@@ -261,73 +511,100 @@ void applyMicrostepSetting(int setting) {
   // Zera a posição atual, pois a referência de passos mudou
   currentPosition = 0;
   
-  Serial.printf("Micro-passo configurado para: %dx\n", microstepMultipliers[setting]);
+  Serial.printf("Micro-passo configurado para: %dx%s\n", microstepMultipliers[setting], autoMicrostep ? " (auto)" : "");
   Serial.printf("Passos por volta agora: %d\n", activeStepsPerRev);
+
+  // Uma resolução mais fina pode baixar o limite das velocidades
+  applySpeedProfiles();
 }
 
-// Lida com a tela de configuração de micro-passo
-void handleMicrostepSetup() {
-  static int selectedMicrostep = currentMicrostep;
+// Maior RPM aceito no micro-passo ativo. Com "Auto" os pulsos rápidos saem
+// em full step, pelo timer, então o limite é o do full step. Sem ele os
+// movimentos até uma posição saem pelo emissor de STEP_BACKEND.
+int maxSpeedSetting(int mode) {
+  int pulseStepsPerRev = autoMicrostep ? BASE_STEPS_PER_REV : activeStepsPerRev;
+  int pulseRate = (mode == SPEED_JOG || autoMicrostep) ? MAX_STEP_PULSE_RATE : POSITION_MOVE_MAX_PULSE_RATE;
+  return maxSpeedRpm(pulseStepsPerRev, pulseRate, SPEED_MAX_RPM);
+}
+
+// Limita as velocidades ao micro-passo ativo e as envia à tarefa de movimento
+void applySpeedProfiles() {
+  for (int mode = 0; mode < SPEED_MODE_COUNT; mode++) {
+    int maxRpm = maxSpeedSetting(mode);
+    if (speedRpm[mode] > maxRpm) {
+      speedRpm[mode] = maxRpm;
+      Serial.printf("Velocidade de %s limitada a %d RPM\n", speedModeNames[mode], maxRpm);
+    }
+    motion.setSpeedProfile((SpeedMode)mode, speedRpm[mode]);
+  }
+}
 
+// O limite mostrado é o do modo em foco (nenhum em Voltar)
+void showSpeedSetup() {
+  int maxRpm = speedSelection < SPEED_MODE_COUNT ? maxSpeedSetting(speedSelection) : 0;
+  display.showSpeedSetup(speedModeNames, speedRpm, SPEED_MODE_COUNT, speedSelection,
+                         speedEditing, maxRpm);
+}
+
+// Lista dos modos com seus RPM e a opção Voltar. Clique num modo alterna entre
+// navegar e ajustar; o valor é enviado à tarefa de movimento ao confirmar.
+void handleSpeedSetup() {
   int direction = encoder.getDirection();
   if (direction != 0) {
-    selectedMicrostep += direction;
-    if (selectedMicrostep < 0) selectedMicrostep = 4;
-    if (selectedMicrostep > 4) selectedMicrostep = 0;
-    display.showMicrostepSetup(selectedMicrostep);
+    if (speedEditing) {
+      speedRpm[speedSelection] = constrain(speedRpm[speedSelection] + direction * SPEED_RPM_INCREMENT,
+                                           SPEED_MIN_RPM, maxSpeedSetting(speedSelection));
+    } else {
+      speedSelection = wrapPosition(speedSelection + direction, SPEED_MODE_COUNT + 1);
+    }
+    showSpeedSetup();
   }
 
   if (encoder.isPressed()) {
-    applyMicrostepSetting(selectedMicrostep);
-    currentState = MENU_MAIN;
-    // display.showMainMenu();
-    resetMenuState = true;
+    if (speedSelection == SPEED_MODE_COUNT) {
+      currentState = MENU_MAIN;
+      resetMenuState = true;
+      delay(200);
+      return;
+    }
+
+    if (speedEditing) {
+      motion.setSpeedProfile((SpeedMode)speedSelection, speedRpm[speedSelection]);
+      Serial.printf("Velocidade de %s definida para: %d RPM\n",
+                    speedModeNames[speedSelection], speedRpm[speedSelection]);
+    }
+    speedEditing = !speedEditing;
+    showSpeedSetup();
     delay(200);
   }
 }
 
-void handleRelayTimeSetup() {
-  static int selectedTime = RELAY_ON_TIME; // Inicia com o valor atual
-
-  int direction = encoder.getDirection();
-  if (direction != 0) {
-    // Incrementa ou decrementa o tempo em 50ms
-    selectedTime += direction * 50;
-    
-    // Define limites para o tempo (ex: 50ms a 5000ms)
-    if (selectedTime < 50) selectedTime = 50;
-    if (selectedTime > 5000) selectedTime = 5000;
-    
-    display.showRelayTimeSetup(selectedTime);
-  }
-
-  // Se o botão for pressionado, salva o valor e volta ao menu
+// Tela estática: o histórico só muda quando um ciclo termina
+void handleHistoryStats() {
   if (encoder.isPressed()) {
-    RELAY_ON_TIME = selectedTime; // Salva o novo valor na variável global
     currentState = MENU_MAIN;
     resetMenuState = true;
-    
-    Serial.printf("Novo tempo do rele definido para: %d ms\n", RELAY_ON_TIME);
     delay(200);
   }
 }
 
-void handleRelayOffTimeSetup() {
-  static int selectedTime = STEP_SETTLE_TIME;
+// Lida com a tela de configuração de micro-passo
+void handleMicrostepSetup() {
+  static int selectedMicrostep = autoMicrostep ? AUTO_MICROSTEP_OPTION : currentMicrostep;
 
   int direction = encoder.getDirection();
   if (direction != 0) {
-    selectedTime += direction * 50;
-    if (selectedTime < 50) selectedTime = 50;
-    if (selectedTime > 5000) selectedTime = 5000;
-    display.showRelayOffTimeSetup(selectedTime);
+    selectedMicrostep += direction;
+    if (selectedMicrostep < 0) selectedMicrostep = MICROSTEP_OPTION_COUNT - 1;
+    if (selectedMicrostep >= MICROSTEP_OPTION_COUNT) selectedMicrostep = 0;
+    display.showMicrostepSetup(microstepOptions, MICROSTEP_OPTION_COUNT, selectedMicrostep);
   }
 
   if (encoder.isPressed()) {
-    STEP_SETTLE_TIME = selectedTime;
+    applyMicrostepSetting(selectedMicrostep);
     currentState = MENU_MAIN;
+    // display.showMainMenu();
     resetMenuState = true;
-    Serial.printf("Novo tempo do rele DESLIGADO definido para: %d ms\n", STEP_SETTLE_TIME);
     delay(200);
   }
 }
@@ -347,82 +624,157 @@ void handlePositioningSetup() {
 
     if(encoder.isPressed()) {
       // Confirma o passo alvo e inicia o posicionamento
-      currentState = POSITIONING;
       startPositioning(targetStepValue);
       delay(200);
     }
 }
 
-void startFullCycle() {
-  currentState = RUNNING_CYCLE;
-  cycleStep = 0;
-  cyclePosition = 0;
-  currentPosition = 0;
-  stepper.enable();
+void startBatchFromEditor() {
+  startBatch(batchTotal);
+}
+
+// Escolha das estações do indexador: "Tabela" (ângulos de config.h) ou 2 a
+// INDEX_MAX_STATIONS estações iguais. Em seguida define o tamanho do lote.
+void handleIndexSetup() {
+  int direction = encoder.getDirection();
+  if (direction != 0) {
+    indexStations += direction;
+    if (indexStations == 1) indexStations = direction > 0 ? 2 : 0;
+    if (indexStations < 0) indexStations = INDEX_MAX_STATIONS;
+    if (indexStations > INDEX_MAX_STATIONS) indexStations = 0;
+    display.showIndexSetup(indexStations);
+  }
+
+  if (encoder.isPressed()) {
+    batchIndexing = true;
+    openNumberEditor(batchEditor);
+    delay(200);
+  }
+}
+
+// Inicia um lote de ciclos completos executados em sequência, sem pausa entre eles
+void startBatch(int totalCycles) {
+  batchTotal = totalCycles;
+  batchStartTime = millis();
+  batchStartCycles = 0;
+  batchPausedTime = 0;
+  motion.setEnabled(true);
   motorEnabled = true;
-  
-  // Inicia o primeiro passo do ciclo
-  digitalWrite(RELAY_PIN, LOW);
-  relayStartTime = millis();
-  
-  display.showCycleProgress(cyclePosition, activeStepsPerRev);
-  Serial.println("Iniciando ciclo completo");
+
+  // A tarefa de movimento executa os ciclos (relé, passo e estabilização);
+  // a interface só acompanha o progresso pelo instantâneo
+  bool sent = batchIndexing ? motion.startIndexing(totalCycles, indexStations)
+                            : motion.startCycle(totalCycles);
+  if (!sent) {
+    commandQueueFull("Lote");
+    return;
+  }
+  shownCyclePosition = -1;
+  shownCyclesCompleted = 0;
+  currentState = RUNNING_CYCLE;
+
+  Serial.printf("Iniciando lote de %d ciclo(s)%s\n", totalCycles, batchIndexing ? " no indexador" : "");
+}
+
+// Fila de comandos cheia: a operação não começou. Sem o aviso, a tela de
+// acompanhamento veria a tarefa de movimento parada e em dia e daria a
+// operação por concluída. Volta ao menu como em finishBatch().
+void commandQueueFull(const char* operation) {
+  char message[64];
+  snprintf(message, sizeof(message), "%s nao iniciado:\nfila de comandos\ncheia", operation);
+  display.showError(message);
+  Serial.printf("%s nao iniciado: fila de comandos cheia\n", operation);
+  currentState = MENU_MAIN;
+  delay(2000);
+  resetMenuState = true;
+}
+
+// Peças por hora no lote atual: ciclos concluídos mais a fração do ciclo em
+// andamento, divididos pelo tempo efetivo (sem as pausas)
+int batchPartsPerHour() {
+  unsigned long activeTime = millis() - batchStartTime - batchPausedTime;
+  if (activeTime < 1000) return 0;
+
+  float parts = motionStatus.cyclesCompleted - batchStartCycles +
+                (float)motionStatus.cyclePosition / motionStatus.cycleLength;
+  return (int)(parts * 3600000.0 / activeTime);
+}
+
+void showCycleScreen() {
+  int batchIndex = min(motionStatus.cyclesCompleted + 1, batchTotal);
+  display.showCycleProgress(motionStatus.cyclePosition, motionStatus.cycleLength,
+                            batchIndex, batchTotal, batchPartsPerHour());
 }
 
 void handleRunningCycle() {
-  unsigned long currentTime = millis();
-  
-  switch(cycleStep) {
-    case 0: // O relé está LIGADO, esperando o tempo definido.
-      // A constante RELAY_ON_TIME vem de config.h (500ms)
-      if (currentTime - relayStartTime >= RELAY_ON_TIME) {
-        // O tempo de 500ms passou. Agora, desligamos o relé e damos o passo.
-        digitalWrite(RELAY_PIN, HIGH); // Desliga o relé
-        stepper.moveOneStep();         // Move um passo imediatamente
-
-        // Atualiza as variáveis de posição e o display
-        currentPosition = (currentPosition + 1) % activeStepsPerRev;
-        cyclePosition++;
-        display.showCycleProgress(cyclePosition, activeStepsPerRev);
-        
-        // Guarda o tempo do passo para a pequena pausa de estabilização
-        lastStepTime = currentTime;
-        cycleStep = 1; // Vai para o estado de pausa
-      }
-      break;
-      
-    case 1: // Pausa de estabilização após o passo, antes de começar o próximo ciclo.
-      if (currentTime - lastStepTime >= STEP_SETTLE_TIME) {
-        // A pausa terminou. Vamos verificar se o ciclo completo acabou.
-        if (cyclePosition >= activeStepsPerRev) {
-          // Sim, todos os passos foram dados.
-          finishCycle();
-        } else {
-          // Não, ainda há passos a dar. Prepara para o próximo ciclo.
-          digitalWrite(RELAY_PIN, LOW); // Liga o relé novamente
-          relayStartTime = currentTime; // Reinicia o timer do relé
-          cycleStep = 0;                // Volta para o estado 0 para esperar os 500ms
-        }
-      }
-      break;
+  // Aguarda a tarefa de movimento processar o início do lote
+  if (!motion.isCaughtUp(motionStatus)) return;
+
+  if (motionStatus.cyclesCompleted != shownCyclesCompleted) {
+    shownCyclesCompleted = motionStatus.cyclesCompleted;
+    Serial.printf("Ciclo %d/%d finalizado\n", shownCyclesCompleted, batchTotal);
   }
-  
-  // A lógica para cancelar com o botão permanece a mesma e funciona perfeitamente.
+
+  if (motionStatus.phase == PHASE_IDLE) {
+    finishBatch();
+    return;
+  }
+
+  // Redesenha somente quando o passo do ciclo muda
+  if (motionStatus.cyclePosition != shownCyclePosition) {
+    shownCyclePosition = motionStatus.cyclePosition;
+    showCycleScreen();
+  }
+
+  // O botão pausa o ciclo; cancelar é uma opção da tela de pausa
   if (encoder.isPressed()) {
-    digitalWrite(RELAY_PIN, HIGH); // Garante que o relé seja desligado ao cancelar
+    pauseCycle();
+    delay(200);
+  }
+}
+
+// A tarefa de movimento preserva a fase e a posição do ciclo durante a pausa
+void pauseCycle() {
+  if (!motion.pause()) return;
+  pauseStartTime = millis();
+  pauseSelection = 0;
+  currentState = CYCLE_PAUSED;
+  display.showCyclePaused(motionStatus.cyclePosition, motionStatus.cycleLength,
+                          motionStatus.cyclesCompleted + 1, batchTotal, pauseSelection);
+  Serial.println("Ciclo pausado");
+}
+
+void handleCyclePaused() {
+  int direction = encoder.getDirection();
+  if (direction != 0) {
+    pauseSelection = pauseSelection ? 0 : 1;
+    display.showCyclePaused(motionStatus.cyclePosition, motionStatus.cycleLength,
+                            motionStatus.cyclesCompleted + 1, batchTotal, pauseSelection);
+  }
+
+  if (!encoder.isPressed()) return;
+
+  if (pauseSelection == 0) {
+    if (!motion.resume()) return;
+    batchPausedTime += millis() - pauseStartTime;
+    shownCyclePosition = -1; // Redesenha a tela do ciclo
+    currentState = RUNNING_CYCLE;
+    Serial.println("Ciclo retomado");
+  } else {
+    if (!motion.cancel()) return;
     currentState = MENU_MAIN;
     resetMenuState = true;
-    Serial.println("Ciclo cancelado");
-    delay(200);
+    Serial.printf("Lote cancelado apos %d ciclo(s)\n", motionStatus.cyclesCompleted);
   }
+  delay(200);
 }
 
-void finishCycle() {
+void finishBatch() {
   currentState = MENU_MAIN;
   display.showCycleComplete();
+  Serial.printf("Lote finalizado: %d ciclo(s), %d pecas/h\n", motionStatus.cyclesCompleted, batchPartsPerHour());
   delay(2000);
   resetMenuState = true;
-  Serial.println("Ciclo completo finalizado");
 }
 
 // void handleAngleSetup() {
@@ -447,7 +799,7 @@ void finishCycle() {
 // }
 
 void startPositioning(int targetStep) {
-  stepper.enable();
+  motion.setEnabled(true);
   motorEnabled = true;
 
   // float anglePerStep = 360.0 / activeStepsPerRev;
@@ -455,44 +807,310 @@ void startPositioning(int targetStep) {
   // // Calcula posição alvo em steps
   // int targetStep = round((targetAngle / 10.0) / anglePerStep);
   // Calcula menor caminho
-  int stepsToMove = targetStep - currentPosition;
-
-  int halfWay = activeStepsPerRev / 2;
-  
-  if(stepsToMove > halfWay) {
-    stepsToMove -= activeStepsPerRev;
-  } else if(stepsToMove < -halfWay) {
-    stepsToMove += activeStepsPerRev;
-  }
+  int stepsToMove = shortestPathSteps(currentPosition, targetStep, activeStepsPerRev);
   
   display.showPositioning(targetStep, stepsToMove);
   
-  // Executa movimento
-  if(stepsToMove != 0) {
-    stepper.moveSteps(stepsToMove);
-    // currentPosition = targetStep;
+  // Executa movimento na tarefa de movimento; handlePositioning() acompanha
+  if (!motion.move(stepsToMove)) {
+    commandQueueFull("Movimento");
+    return;
   }
-  currentPosition = targetStep;
-  
+  positioningDoneTime = 0;
+  currentState = POSITIONING;
+}
+
+void handlePositioning() {
+  // Aguarda o fim do movimento
+  if (!motion.isCaughtUp(motionStatus) || motionStatus.phase != PHASE_IDLE) return;
+
   // Mantém motor energizado para travar posição
-  // Serial.printf("Posicionado em %.1f graus (%d steps)\n", targetAngle/10.0, currentPosition);
-  Serial.printf("Posicionado no passo %d\n", currentPosition);
+  if (positioningDoneTime == 0) {
+    positioningDoneTime = millis();
+    Serial.printf("Posicionado no passo %d (volta %d, absoluto %lld)\n",
+                  motionStatus.position, motionStatus.revolution,
+                  (long long)motionStatus.absolutePosition);
+  }
 
   // Retorna ao menu após 2 segundos
-  delay(2000);
-  currentState = MENU_MAIN;
-  resetMenuState = true;
+  if (millis() - positioningDoneTime >= POSITIONING_HOLD_MS) {
+    currentState = MENU_MAIN;
+    resetMenuState = true;
+  }
 }
 
-void handlePositioning() {
-  // Estado transitório - o posicionamento é feito imediatamente
-  // Este método existe para futuras expansões
+// Alvo em volta + passo: um avanço de fuso de várias voltas é um único movimento
+void handleAbsolutePositioningSetup() {
+  int direction = encoder.getDirection();
+  if (direction != 0) {
+    if (absEditingRevolution) {
+      absTargetRevolution += direction;
+    } else {
+      absTargetStep = wrapPosition(absTargetStep + direction, activeStepsPerRev);
+    }
+    display.showAbsolutePositioningSetup(absTargetRevolution, absTargetStep, absEditingRevolution);
+  }
+
+  if (encoder.isPressed()) {
+    if (absEditingRevolution) {
+      // Primeiro clique confirma a volta, o segundo o passo
+      absEditingRevolution = false;
+      display.showAbsolutePositioningSetup(absTargetRevolution, absTargetStep, absEditingRevolution);
+    } else {
+      startAbsolutePositioning(absoluteFrom(absTargetRevolution, absTargetStep, activeStepsPerRev));
+    }
+    delay(200);
+  }
+}
+
+void startAbsolutePositioning(int64_t target) {
+  motion.setEnabled(true);
+  motorEnabled = true;
+
+  // Sem menor caminho: o motor percorre toda a distância até o alvo
+  int64_t stepsToMove = target - motionStatus.absolutePosition;
+  display.showAbsolutePositioning(absTargetRevolution, absTargetStep, stepsToMove);
+
+  if (!motion.moveTo(target)) {
+    commandQueueFull("Movimento");
+    return;
+  }
+  positioningDoneTime = 0;
+  currentState = POSITIONING;
+}
+
+void handleDiagnostics() {
+  static unsigned long lastRefresh = 0;
+
+  // Atualiza a tela periodicamente com os valores mais recentes
+  if (millis() - lastRefresh >= DIAGNOSTICS_REFRESH_MS) {
+    lastRefresh = millis();
+    display.showDiagnostics();
+  }
+
+  if (encoder.isPressed()) {
+    currentState = MENU_MAIN;
+    resetMenuState = true;
+    delay(200);
+  }
+}
+
+// Comandos de uma letra recebidos pela serial:
+//   'd' - imprime todas as métricas
+//   'z' - zera as métricas
+//   'b' - executa os benchmarks (somente no menu principal)
+//   'r' - inicia/para a gravação das entradas do encoder
+//   'p' - reproduz a gravação (somente no menu principal)
+//   'x' - exporta a gravação em hexadecimal
+//   'i' - importa uma gravação no formato de 'x'
+//   'h' - exporta o histórico de produção (somente no menu principal)
+void handleSerialCommands() {
+  if (!Serial.available()) return;
+
+  char command = Serial.read();
+  switch (command) {
+    case 'd':
+      Metrics::dump(Serial);
+      break;
+    case 'z':
+      Metrics::reset();
+      Serial.println("Metricas zeradas");
+      break;
+    case 'b':
+      if (currentState != MENU_MAIN) {
+        Serial.println("Benchmark disponivel apenas no menu principal");
+        break;
+      }
+      Benchmark::runAll(Serial, display, encoder);
+      resetMenuState = true; // Redesenha o menu sobre as telas do benchmark
+      break;
+    case 'r':
+      if (InputTrace::isRecording()) {
+        InputTrace::stopRecording();
+      } else if (currentState == MENU_MAIN) {
+        menu.reset(); // Gravação e reprodução partem do mesmo estado
+        resetMenuState = true;
+        InputTrace::startRecording();
+      } else {
+        Serial.println("Gravacao deve iniciar no menu principal");
+      }
+      break;
+    case 'p':
+      if (currentState != MENU_MAIN) {
+        Serial.println("Reproducao disponivel apenas no menu principal");
+        break;
+      }
+      menu.reset();
+      resetMenuState = true;
+      InputTrace::startReplay();
+      break;
+    case 'x':
+      InputTrace::exportHex(Serial);
+      break;
+    case 'i':
+      // A interface fica parada até a linha END (ou o tempo esgotar)
+      Serial.println("Envie a gravacao exportada por 'x'");
+      InputTrace::importHex(Serial);
+      break;
+    case 'h':
+      // O log cheio leva minutos a 115200 baud; a interface fica parada
+      if (currentState != MENU_MAIN) {
+        Serial.println("Historico disponivel apenas no menu principal");
+        break;
+      }
+      History::exportDump(Serial);
+      break;
+    case 'e':
+      // Aciona a emergência de verdade: o rearme é feito na tela, como sempre
+      if (currentState != MENU_MAIN) {
+        Serial.println("Teste do E-stop disponivel apenas no menu principal");
+        break;
+      }
+      EmergencyStop::runLatencyTest(Serial, motion);
+      break;
+#if PIN_TRACE_CAPACITY > 0
+    case 't':
+      if (PinTrace::isActive()) {
+        PinTrace::stop();
+      } else {
+        PinTrace::start();
+      }
+      break;
+    case 'w':
+      PinTrace::exportVcd(Serial);
+      break;
+#endif
+  }
+}
+
+void startJog() {
+  int multiplier = microstepMultipliers[currentMicrostep];
+
+  motion.setEnabled(true);
+  motorEnabled = true;
+  if (!motion.startJog(JOG_ACCELERATION * multiplier)) {
+    commandQueueFull("Jog");
+    return;
+  }
+
+  jogLastDetentTime = millis();
+  jogDetentRate = 0;
+  jogStopping = false;
+  currentState = JOG;
+
+  display.showJog(currentPosition, 0);
+  Serial.println("Modo jog iniciado");
+}
+
+// O encoder comanda velocidade: quanto mais rápido o giro, maior a velocidade.
+// Sem giro por JOG_RELEASE_MS o motor desacelera até parar. A rampa e o timer
+// de passos ficam na tarefa de movimento.
+void handleJog() {
+  static unsigned long lastDisplayUpdate = 0;
+  unsigned long now = millis();
+  int multiplier = microstepMultipliers[currentMicrostep];
+
+  int direction = encoder.getDirection();
+  if (direction != 0 && !jogStopping) {
+    // Taxa instantânea de giro do encoder (passos do encoder por segundo)
+    unsigned long interval = max(now - jogLastDetentTime, 10UL);
+    float instantRate = direction * (1000.0 / interval);
+
+    if (jogDetentRate * direction <= 0) {
+      jogDetentRate = instantRate;  // Partida ou inversão de sentido
+    } else {
+      jogDetentRate = (jogDetentRate + instantRate) / 2; // Suavização
+    }
+    jogLastDetentTime = now;
+
+    float maxSpeed = rpmToStepsPerSec(speedRpm[SPEED_JOG], activeStepsPerRev);
+    float speed = jogDetentRate * JOG_SPEED_PER_DETENT_RATE * multiplier;
+    motion.setSpeed((int32_t)constrain(speed, -maxSpeed, maxSpeed));
+  }
+
+  // Botão "solto": desacelera até parar (repete se a fila estava cheia)
+  if (now - jogLastDetentTime > JOG_RELEASE_MS && jogDetentRate != 0) {
+    if (motion.setSpeed(0)) {
+      jogDetentRate = 0;
+    }
+  }
+
+  if (now - lastDisplayUpdate >= JOG_DISPLAY_INTERVAL_MS) {
+    lastDisplayUpdate = now;
+    // No modo automático mostra a resolução em uso
+    const char* resolution = motionStatus.autoMicrostep
+        ? ActiveDriver::labels[currentMicrostep - motionStatus.microstepShift] : NULL;
+    display.showJog(currentPosition, motionStatus.speed, resolution);
+  }
+
+  if (encoder.isPressed() && !jogStopping) {
+    jogStopping = motion.cancel();
+  }
+
+  // Sai somente depois que o motor parou
+  if (jogStopping && motion.isCaughtUp(motionStatus) && motionStatus.phase == PHASE_IDLE) {
+    display.showJog(currentPosition, 0);
+    currentState = MENU_MAIN;
+    resetMenuState = true;
+    Serial.printf("Jog finalizado no passo %d\n", currentPosition);
+    delay(200);
+  }
+}
+
+// Variáveis da tela de emergência
+bool emergencyInputShown = false;   // Estado da entrada mostrado na tela
+bool emergencyResetSent = false;
+
+void enterEmergencyStop() {
+  // O motor fica desabilitado depois do rearme: o operador o reabilita na
+  // tela "Motor livre", sabendo que a posição pode ter se perdido
+  motorEnabled = false;
+  jogDetentRate = 0;
+  jogStopping = false;
+  emergencyResetSent = false;
+  emergencyInputShown = EmergencyStop::inputActive();
+  currentState = EMERGENCY_STOP;
+
+  display.showEmergencyStop(EmergencyStop::causeName(motionStatus.emergencyCause), emergencyInputShown);
+  Serial.printf("EMERGENCIA (%s): motor e rele desligados\n",
+                EmergencyStop::causeName(motionStatus.emergencyCause));
+}
+
+void handleEmergencyStop() {
+  bool inputActive = EmergencyStop::inputActive();
+  if (inputActive != emergencyInputShown) {
+    emergencyInputShown = inputActive;
+    display.showEmergencyStop(EmergencyStop::causeName(motionStatus.emergencyCause), inputActive);
+  }
+
+  if (emergencyResetSent && motion.isCaughtUp(motionStatus)) {
+    emergencyResetSent = false;
+    if (!motionStatus.emergencyStop) {
+      currentState = MOTOR_DISABLED;
+      display.showMotorDisabled();
+      Serial.println("Emergencia rearmada");
+      return;
+    }
+  }
+
+  // Só rearma com a entrada liberada
+  if (encoder.isPressed() && !inputActive && !emergencyResetSent) {
+    emergencyResetSent = motion.resetEmergencyStop();
+    delay(200);
+  }
 }
 
 void handleMotorDisabled() {
   if(encoder.isPressed()) {
+    // Um lote interrompido por reinício ainda aguarda a decisão do operador
+    if (resumeOffered) {
+      openResumePrompt();
+      delay(200);
+      return;
+    }
+
     // Reabilita motor e volta ao menu
-    stepper.enable();
+    motion.setEnabled(true);
     motorEnabled = true;
     currentState = MENU_MAIN;
     resetMenuState = true;
@@ -501,6 +1119,87 @@ void handleMotorDisabled() {
   }
 }
 
+// ================= Retomada após reinício =================
+
+// Restaura a configuração gravada antes do reinício e entrega o ponto de
+// retomada à tarefa de movimento. Chamar antes de motion.begin().
+bool loadResumePoint() {
+  if (!ResumeState::load(resumePoint)) return false;
+  // Gravado por um firmware com outro driver: a posição não vale mais
+  if (resumePoint.microstepIndex >= ActiveDriver::MICROSTEP_COUNT) return false;
+
+  currentMicrostep = resumePoint.microstepIndex;
+  autoMicrostep = resumePoint.autoMicrostep != 0 && AUTO_MICROSTEP_SUPPORTED;
+  RELAY_ON_TIME = resumePoint.relayOnMs;
+  STEP_SETTLE_TIME = resumePoint.settleMs;
+  for (int mode = 0; mode < SPEED_MODE_COUNT; mode++) {
+    speedRpm[mode] = resumePoint.speedRpm[mode];
+  }
+  indexStations = resumePoint.stations;
+
+  resumeOffered = resumePoint.phase != PHASE_IDLE;
+  if (resumeOffered) {
+    batchTotal = resumePoint.batchTotal;
+    batchIndexing = resumePoint.indexing;
+  }
+  motion.restore(resumePoint);
+
+  Serial.printf("Ponto de retomada restaurado (%s)%s\n", ResumeState::resetCauseName(),
+                resumeOffered ? ": lote interrompido" : "");
+  return true;
+}
+
+void showResumePrompt() {
+  display.showResumePrompt(ResumeState::resetCauseName(), resumePoint.cyclePosition, resumePoint.cycleLength,
+                           resumePoint.cyclesCompleted + 1, resumePoint.batchTotal,
+                           resumePoint.inMotion, resumeSelection);
+}
+
+void openResumePrompt() {
+  resumeSelection = 0;
+  currentState = RESUME_PROMPT;
+  showResumePrompt();
+}
+
+void handleResumePrompt() {
+  int direction = encoder.getDirection();
+  if (direction != 0) {
+    resumeSelection = resumeSelection ? 0 : 1;
+    showResumePrompt();
+  }
+
+  if (!encoder.isPressed()) return;
+
+  if (resumeSelection == 0) {
+    resumeBatch();
+  } else {
+    // A posição é restaurada mesmo assim; o ciclo fica para trás
+    if (!motion.restoreResumePoint(false)) return;
+    resumeOffered = false;
+    currentState = MENU_MAIN;
+    resetMenuState = true;
+    Serial.println("Lote interrompido descartado");
+  }
+  delay(200);
+}
+
+// Como startBatch(), mas a tarefa de movimento retoma o ciclo gravado
+void resumeBatch() {
+  motion.setEnabled(true);
+  if (!motion.restoreResumePoint(true)) return;
+  motorEnabled = true;
+  resumeOffered = false;
+  batchStartTime = millis();
+  batchStartCycles = resumePoint.cyclesCompleted;
+  batchPausedTime = 0;
+  shownCyclePosition = -1;
+  shownCyclesCompleted = resumePoint.cyclesCompleted;
+  currentState = RUNNING_CYCLE;
+
+  Serial.printf("Retomando lote no ciclo %d/%d, passo %d/%d\n", resumePoint.cyclesCompleted + 1,
+                resumePoint.batchTotal, resumePoint.cyclePosition, resumePoint.cycleLength);
+}
+
 
 // ====== TESTE 1: MOTOR DE PASSO ======
 // #include <Arduino.h>
@@ -0,0 +1,86 @@
+#include "Adafruit_GFX.h"
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {
+    cursor_x = 0;
+    cursor_y = 0;
+    textcolor = 0xFFFF;
+    textbgcolor = 0xFFFF;
+    textsize_x = 1;
+    textsize_y = 1;
+    wrap = true;
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+// Linhas de pixels, bit mais significativo à esquerda
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                              uint16_t color) {
+    int16_t rowBytes = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) {
+            if (bitmap[j * rowBytes + i / 8] & (0x80 >> (i & 7))) {
+                drawPixel(x + i, y + j, color);
+            }
+        }
+    }
+}
+
+// Mesma estrutura da drawChar() clássica: 5 colunas de 8 bits, pixel a pixel
+// (ou retângulos com escala), fundo só se bg != color. O glifo é sintético.
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg,
+                            uint8_t size) {
+    if (x >= _width || y >= _height || x + 6 * size - 1 < 0 || y + 8 * size - 1 < 0) return;
+
+    for (int8_t i = 0; i < 5; i++) {
+        uint8_t line = c == ' ' ? 0 : (uint8_t)((c * 0x9E + i * 0x3B) ^ (c >> 1)) & 0x7F;
+        for (int8_t j = 0; j < 8; j++, line >>= 1) {
+            if (line & 1) {
+                if (size == 1) drawPixel(x + i, y + j, color);
+                else fillRect(x + i * size, y + j * size, size, size, color);
+            } else if (bg != color) {
+                if (size == 1) drawPixel(x + i, y + j, bg);
+                else fillRect(x + i * size, y + j * size, size, size, bg);
+            }
+        }
+    }
+    if (bg != color) {
+        if (size == 1) drawFastVLine(x + 5, y, 8, bg);
+        else fillRect(x + 5 * size, y, size, 8 * size, bg);
+    }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+        if (wrap && cursor_x + textsize_x * 6 > _width) {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+        cursor_x += textsize_x * 6;
+    }
+    return 1;
+}
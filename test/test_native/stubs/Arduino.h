@@ -0,0 +1,135 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Subconjunto do núcleo Arduino-ESP32 usado pelo firmware, para os testes no
+// host (pio test -e native). O "hardware" por trás (relógio, pinos,
+// interrupções, timers) é simulado em HostHal.cpp e controlado por HostHal.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <ctype.h>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_system.h"
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+// Memória RTC sem inicialização: uma seção própria, que HostHal::rtcMemory()
+// expõe aos testes (reinício no meio de uma gravação, CRC corrompido)
+#define RTC_NOINIT_ATTR __attribute__((section("host_rtc_noinit")))
+#define PROGMEM
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+#define SERIAL_8N1      0x800001c
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+inline T constrain(T value, L low, H high) {
+    return value < low ? (T)low : (value > high ? (T)high : value);
+}
+
+// --- Tempo (relógio virtual, avançado pelos testes) ---
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// --- GPIO ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(pin) ((int)(pin))
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// --- Timer de hardware (esp32-hal-timer) ---
+typedef struct hw_timer_s hw_timer_t;
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerAttachInterrupt(hw_timer_t* timer, void (*handler)(void), bool edge);
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload);
+void timerAlarmEnable(hw_timer_t* timer);
+void timerAlarmDisable(hw_timer_t* timer);
+void timerWrite(hw_timer_t* timer, uint64_t value);
+
+// --- Print / Stream ---
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    virtual void flush() {}
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* text) { return write(text); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(long long value) { return printf("%lld", value); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    size_t println(double value, int digits) { size_t n = print(value, digits); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Serial do host: a saída é acumulada (HostHal::serialOutput) e a entrada
+// vem de HostHal::serialInput
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) {}
+    void end() {}
+    size_t write(uint8_t c) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+// --- ESP ---
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 240; }
+};
+
+extern EspClass ESP;
+
+#endif
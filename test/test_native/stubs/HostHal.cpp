@@ -0,0 +1,422 @@
+#include "HostHal.h"
+#include <esp_task_wdt.h>
+#include <esp_rom_crc.h>
+#include <esp_partition.h>
+#include <driver/rtc_cntl.h>
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include <hal/timer_ll.h>
+#include <chrono>
+
+#define HOST_PIN_COUNT          40
+#define HOST_FLASH_SECTOR_SIZE  4096
+#define HOST_FLASH_SECTORS      16
+
+struct hw_timer_s {
+    void (*handler)(void);
+    uint64_t interval;
+    uint64_t counterBase;   // Instante em que o contador foi zerado
+    uint64_t nextFire;
+    bool enabled;
+};
+
+struct HostPin {
+    uint8_t mode;
+    uint8_t output;
+    uint8_t input;
+    uint32_t rising;
+    void (*handler)(void);          // attachInterrupt()
+    gpio_isr_t isrHandler;          // gpio_isr_handler_add()
+    void* isrArg;
+    int interruptMode;
+    int8_t wiredTo;                 // Entrada ligada a esta saída (-1 = nenhuma)
+};
+
+static uint64_t nowUs = 0;
+static bool realClock = false;
+static HostPin pins[HOST_PIN_COUNT];
+static hw_timer_t stepTimer;
+// Limites da seção de RTC_NOINIT_ATTR, criados pelo linker
+extern "C" uint8_t __start_host_rtc_noinit[];
+extern "C" uint8_t __stop_host_rtc_noinit[];
+static esp_reset_reason_t resetReason = ESP_RST_POWERON;
+static esp_err_t watchdogInitResult = ESP_OK;
+static std::string serialOut;
+static std::string serialIn;
+static size_t serialInPos = 0;
+static int isrFlags = -1;
+static void (*backgroundTask)() = NULL;
+
+static uint8_t flash[HOST_FLASH_SECTORS * HOST_FLASH_SECTOR_SIZE];
+static const esp_partition_t historyPartition = {
+    ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, 0x290000,
+    sizeof(flash), "history", false
+};
+
+gpio_dev_t GPIO;
+HardwareSerial Serial;
+HardwareSerial Serial2;
+EspClass ESP;
+
+// ================= Controle pelos testes =================
+
+namespace HostHal {
+
+void reset() {
+    nowUs = 0;
+    realClock = false;
+    for (int i = 0; i < HOST_PIN_COUNT; i++) {
+        pins[i].mode = INPUT;
+        pins[i].output = LOW;
+        pins[i].input = HIGH;
+        pins[i].rising = 0;
+        pins[i].handler = NULL;
+        pins[i].isrHandler = NULL;
+        pins[i].isrArg = NULL;
+        pins[i].interruptMode = 0;
+        pins[i].wiredTo = -1;
+    }
+    isrFlags = -1;
+    backgroundTask = NULL;
+    memset(&stepTimer, 0, sizeof(stepTimer));
+    resetReason = ESP_RST_POWERON;
+    watchdogInitResult = ESP_OK;
+    serialOut.clear();
+    serialIn.clear();
+    serialInPos = 0;
+    memset(flash, 0xFF, sizeof(flash));
+}
+
+void advanceMicros(uint32_t us) {
+    uint64_t target = nowUs + us;
+    while (stepTimer.enabled && stepTimer.handler != NULL && stepTimer.nextFire <= target) {
+        uint64_t fireTime = stepTimer.nextFire;
+        if (fireTime > nowUs) nowUs = fireTime;
+        // Recarga automática: o contador volta a zero no alarme
+        stepTimer.counterBase = fireTime;
+        stepTimer.nextFire = fireTime + stepTimer.interval;
+        stepTimer.handler();
+        if (stepTimer.interval == 0) break;
+    }
+    if (target > nowUs) nowUs = target;
+}
+
+void advanceMillis(uint32_t ms) {
+    advanceMicros(ms * 1000UL);
+}
+
+void useRealClock(bool on) {
+    realClock = on;
+}
+
+static void firePin(HostPin& p) {
+    if (p.handler != NULL) p.handler();
+    if (p.isrHandler != NULL) p.isrHandler(p.isrArg);
+}
+
+void setInput(uint8_t pin, int level) {
+    HostPin& p = pins[pin];
+    uint8_t previous = p.input;
+    p.input = level ? HIGH : LOW;
+    if (previous == p.input) return;
+    bool rising = p.input == HIGH;
+    if (p.interruptMode == CHANGE || (p.interruptMode == RISING && rising) ||
+        (p.interruptMode == FALLING && !rising)) {
+        firePin(p);
+    }
+}
+
+int outputLevel(uint8_t pin) {
+    return pins[pin].output;
+}
+
+uint32_t risingEdges(uint8_t pin) {
+    return pins[pin].rising;
+}
+
+void raiseInterrupt(uint8_t pin) {
+    firePin(pins[pin]);
+}
+
+void wire(uint8_t output, uint8_t input) {
+    pins[output].wiredTo = input;
+}
+
+int isrServiceFlags() {
+    return isrFlags;
+}
+
+void setBackgroundTask(void (*task)()) {
+    backgroundTask = task;
+}
+
+bool timerRunning() {
+    return stepTimer.enabled;
+}
+
+uint64_t timerInterval() {
+    return stepTimer.interval;
+}
+
+void setResetReason(esp_reset_reason_t reason) {
+    resetReason = reason;
+}
+
+void setWatchdogInitResult(esp_err_t result) {
+    watchdogInitResult = result;
+}
+
+uint8_t* rtcMemory() {
+    return __start_host_rtc_noinit;
+}
+
+size_t rtcMemorySize() {
+    return __stop_host_rtc_noinit - __start_host_rtc_noinit;
+}
+
+void serialInput(const char* text) {
+    serialIn += text;
+}
+
+std::string serialOutput() {
+    return serialOut;
+}
+
+void clearSerialOutput() {
+    serialOut.clear();
+}
+
+}
+
+// ================= Núcleo Arduino =================
+
+static uint64_t hostMicros() {
+    if (!realClock) return nowUs;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long millis() { return (unsigned long)(hostMicros() / 1000); }
+unsigned long micros() { return (unsigned long)hostMicros(); }
+void delay(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        nowUs += 1000;
+        if (backgroundTask != NULL) backgroundTask();
+    }
+}
+
+void delayMicroseconds(uint32_t us) { nowUs += us; }
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    HostPin& p = pins[pin];
+    if (level && !p.output) p.rising++;
+    p.output = level ? HIGH : LOW;
+    if (p.wiredTo >= 0) HostHal::setInput(p.wiredTo, p.output);
+}
+
+int digitalRead(uint8_t pin) {
+    const HostPin& p = pins[pin];
+    return p.mode == OUTPUT ? p.output : p.input;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    pins[pin].handler = handler;
+    pins[pin].interruptMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    pins[pin].handler = NULL;
+}
+
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp) {
+    memset(&stepTimer, 0, sizeof(stepTimer));
+    return &stepTimer;
+}
+
+void timerAttachInterrupt(hw_timer_t* timer, void (*handler)(void), bool edge) {
+    timer->handler = handler;
+}
+
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload) {
+    timer->interval = alarmValue;
+    timer->nextFire = timer->counterBase + alarmValue;
+}
+
+timg_dev_t TIMERG0;
+timg_dev_t TIMERG1;
+
+// Recarga automática já configurada: só o valor do alarme muda
+void timer_ll_set_alarm_value(timg_dev_t* hw, timer_idx_t timer_num, uint64_t alarm_value) {
+    timerAlarmWrite(&stepTimer, alarm_value, true);
+}
+
+void timerAlarmEnable(hw_timer_t* timer) {
+    timer->enabled = true;
+    timer->nextFire = timer->counterBase + timer->interval;
+}
+
+void timerAlarmDisable(hw_timer_t* timer) {
+    timer->enabled = false;
+}
+
+void timerWrite(hw_timer_t* timer, uint64_t value) {
+    timer->counterBase = nowUs - value;
+    timer->nextFire = timer->counterBase + timer->interval;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write((const uint8_t*)text, min((size_t)length, sizeof(text) - 1));
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (this == &Serial) serialOut += (char)c;
+    return 1;
+}
+
+int HardwareSerial::available() {
+    return this == &Serial ? (int)(serialIn.size() - serialInPos) : 0;
+}
+
+int HardwareSerial::read() {
+    if (available() == 0) return -1;
+    return (uint8_t)serialIn[serialInPos++];
+}
+
+int HardwareSerial::peek() {
+    if (available() == 0) return -1;
+    return (uint8_t)serialIn[serialInPos];
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(hostMicros() * getCpuFreqMHz());
+}
+
+// ================= FreeRTOS =================
+
+void hostEnterCritical(portMUX_TYPE* mux) {
+    while (__atomic_exchange_n(&mux->owner, 1, __ATOMIC_ACQUIRE)) {
+    }
+    mux->count++;
+}
+
+void hostExitCritical(portMUX_TYPE* mux) {
+    mux->count--;
+    __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+}
+
+// Sem escalonador: quem depende de tarefas cai no caminho sem tarefa
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    if (handle != NULL) *handle = NULL;
+    return pdFAIL;
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+void vTaskDelay(TickType_t ticks) { HostHal::advanceMillis(ticks); }
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period) {
+    *previousWake += period;
+    if (*previousWake > millis()) HostHal::advanceMillis(*previousWake - millis());
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) { return 0; }
+
+// ================= ESP-IDF =================
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+    if (isrFlags >= 0) return ESP_ERR_INVALID_STATE;
+    isrFlags = intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    static const int modes[] = {0, RISING, FALLING, CHANGE, 0, 0};
+    pins[gpio_num].interruptMode = modes[intr_type];
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void* args) {
+    if (isrFlags < 0) return ESP_ERR_INVALID_STATE;
+    pins[gpio_num].isrHandler = isr_handler;
+    pins[gpio_num].isrArg = args;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+    pins[gpio_num].isrHandler = NULL;
+    return ESP_OK;
+}
+
+esp_reset_reason_t esp_reset_reason(void) { return resetReason; }
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic) { return watchdogInitResult; }
+esp_err_t esp_task_wdt_add(void* task) { return ESP_OK; }
+esp_err_t esp_task_wdt_reset(void) { return ESP_OK; }
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        default:                    return "ESP_FAIL";
+    }
+}
+
+esp_err_t rtc_isr_register(void (*handler)(void*), void* arg, uint32_t mask) { return ESP_OK; }
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    return (label != NULL && strcmp(label, historyPartition.label) == 0) ? &historyPartition : NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    if (offset + size > partition->size) return ESP_ERR_INVALID_ARG;
+    memcpy(dst, flash + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+    if (offset + size > partition->size) return ESP_ERR_INVALID_ARG;
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) {
+        flash[offset + i] &= bytes[i];   // A escrita só limpa bits
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    if (offset % HOST_FLASH_SECTOR_SIZE || size % HOST_FLASH_SECTOR_SIZE || offset + size > partition->size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(flash + offset, 0xFF, size);
+    return ESP_OK;
+}
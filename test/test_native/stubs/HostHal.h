@@ -0,0 +1,63 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <Arduino.h>
+#include <esp_err.h>
+#include <string>
+
+// Controle do hardware simulado dos testes no host. O relógio só anda quando
+// o teste manda (advance*/delay*); os alarmes do timer de passos e as
+// interrupções de GPIO disparam dentro desse avanço, como no chip.
+namespace HostHal {
+
+// Volta ao estado de partida: relógio em 0, pinos de entrada em HIGH
+// (pull-up), sem interrupções, timers parados, serial vazia
+void reset();
+
+// Avança o relógio disparando os alarmes do timer que vencerem no caminho
+void advanceMicros(uint32_t us);
+void advanceMillis(uint32_t ms);
+// micros()/millis() passam a seguir o relógio real do host (medições de
+// custo, como o desenho das telas); reset() volta ao relógio virtual
+void useRealClock(bool on);
+
+// Nível imposto de fora num pino de entrada; dispara a interrupção anexada
+// se a borda corresponder ao modo
+void setInput(uint8_t pin, int level);
+// Último nível escrito numa saída e quantas bordas de subida ela teve
+int outputLevel(uint8_t pin);
+uint32_t risingEdges(uint8_t pin);
+
+// Dispara a interrupção anexada ao pino sem mudar o nível (borda perdida ou
+// ruído), como a ISR entrando no meio de outra operação
+void raiseInterrupt(uint8_t pin);
+// Fio entre uma saída e uma entrada: cada escrita na saída chega à entrada
+// (com a interrupção, se houver), como o ESTOP_TEST_PIN ligado ao ESTOP_PIN
+void wire(uint8_t output, uint8_t input);
+// Flags do gpio_install_isr_service() (-1 = serviço não instalado)
+int isrServiceFlags();
+
+// Chamada a cada milissegundo de delay(), como uma tarefa de outro núcleo que
+// roda enquanto quem chamou espera (NULL = nenhuma)
+void setBackgroundTask(void (*task)());
+
+// Timer de passos: ativo e intervalo atual (us)
+bool timerRunning();
+uint64_t timerInterval();
+
+void setResetReason(esp_reset_reason_t reason);
+// Retorno de esp_task_wdt_init() (ESP_OK por padrão; reset() volta a ele)
+void setWatchdogInitResult(esp_err_t result);
+// Variáveis RTC_NOINIT_ATTR do firmware, na ordem de declaração. reset() não
+// mexe nelas: sobrevivem ao reinício simulado, como no chip.
+uint8_t* rtcMemory();
+size_t rtcMemorySize();
+
+// Serial: entrada a ser lida pelo firmware e saída acumulada
+void serialInput(const char* text);
+std::string serialOutput();
+void clearSerialOutput();
+
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+#include <Arduino.h>
+#include <esp_err.h>
+#include "hal/gpio_types.h"
+
+#define ESP_INTR_FLAG_LEVEL1    (1 << 1)
+#define ESP_INTR_FLAG_IRAM      (1 << 10)
+
+typedef void (*gpio_isr_t)(void* arg);
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags);
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void* args);
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_DRIVER_RTC_CNTL_H
+#define HOST_DRIVER_RTC_CNTL_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+esp_err_t rtc_isr_register(void (*handler)(void*), void* arg, uint32_t mask);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_ROM_SYS_H
+#define HOST_ESP_ROM_SYS_H
+
+#include <Arduino.h>
+
+// Espera da ROM: no host avança o relógio virtual como delayMicroseconds()
+static inline void esp_rom_delay_us(uint32_t us) {
+    delayMicroseconds(us);
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic);
+esp_err_t esp_task_wdt_add(void* task);
+esp_err_t esp_task_wdt_reset(void);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <Arduino.h>
+
+// Mesmo relógio virtual de micros()
+static inline int64_t esp_timer_get_time() {
+    return (int64_t)micros();
+}
+
+#endif
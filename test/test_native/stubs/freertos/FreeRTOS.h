@@ -0,0 +1,48 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// FreeRTOS do ESP-IDF no host: sem tarefas (os testes chamam MotionTask::tick()
+// e desenham as telas direto). As seções críticas são spinlocks de verdade,
+// para que os testes com std::thread exercitem as travas do firmware.
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE          1
+#define pdFALSE         0
+#define pdPASS          1
+#define pdFAIL          0
+#define portMAX_DELAY   0xFFFFFFFFUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+typedef struct {
+    volatile uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+
+void hostEnterCritical(portMUX_TYPE* mux);
+void hostExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)         hostEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)          hostExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)     hostEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)      hostExitCritical(mux)
+#define portENTER_CRITICAL_SAFE(mux)    hostEnterCritical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)     hostExitCritical(mux)
+#define portYIELD_FROM_ISR(...)
+
+BaseType_t xTaskCreatePinnedToCore(void (*task)(void*), const char* name, uint32_t stack, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t period);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_HAL_GPIO_LL_H
+#define HOST_HAL_GPIO_LL_H
+
+#include <Arduino.h>
+#include "hal/gpio_types.h"
+
+// Registradores do GPIO: no host a escrita vai para o mesmo pino simulado
+// que digitalWrite()
+typedef struct { int unused; } gpio_dev_t;
+extern gpio_dev_t GPIO;
+
+static inline void gpio_ll_set_level(gpio_dev_t* hw, gpio_num_t gpio_num, uint32_t level) {
+    digitalWrite((uint8_t)gpio_num, level ? HIGH : LOW);
+}
+
+#endif
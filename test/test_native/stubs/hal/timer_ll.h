@@ -0,0 +1,15 @@
+#ifndef HOST_HAL_TIMER_LL_H
+#define HOST_HAL_TIMER_LL_H
+
+#include <Arduino.h>
+
+// Registradores dos grupos de timer: no host o alarme vai para o único timer
+// simulado, o mesmo de timerAlarmWrite()
+typedef struct { int unused; } timg_dev_t;
+typedef enum { TIMER_0 = 0, TIMER_1 = 1 } timer_idx_t;
+extern timg_dev_t TIMERG0;
+extern timg_dev_t TIMERG1;
+
+void timer_ll_set_alarm_value(timg_dev_t* hw, timer_idx_t timer_num, uint64_t alarm_value);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_SOC_RTC_CNTL_REG_H
+#define HOST_SOC_RTC_CNTL_REG_H
+
+#define RTC_CNTL_BROWN_OUT_INT_ENA_M (1UL << 9)
+
+#endif
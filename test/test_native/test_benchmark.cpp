@@ -0,0 +1,32 @@
+#include <unity.h>
+#include <string>
+#include "HostHal.h"
+#include "Benchmark.h"
+#include "Metrics.h"
+
+// Os benchmarks do comando 'b' rodam no host com o backend de arquivos PBM:
+// as verificações embutidas passam e o flush aparece só no modo bloqueante,
+// já que no host não há tarefa de flush
+static void test_benchmarks_pass_on_host() {
+    DisplayManager display;
+    EncoderHandler encoder;
+    display.begin();
+    encoder.begin();
+    HostHal::useRealClock(true);
+
+    HostHal::clearSerialOutput();
+    Benchmark::runAll(Serial, display, encoder);
+    std::string output = HostHal::serialOutput();
+    printf("%s", output.c_str());
+
+    TEST_ASSERT_TRUE(output.find("\"bench\":\"summary\",\"pass\":true") != std::string::npos);
+    TEST_ASSERT_TRUE(output.find("\"pass\":false") == std::string::npos);
+    TEST_ASSERT_TRUE(output.find("\"bench\":\"display_flush\",\"mode\":\"blocking\"") != std::string::npos);
+    TEST_ASSERT_TRUE(output.find("\"mode\":\"async\"") == std::string::npos);
+    TEST_ASSERT_TRUE(output.find("\"render_us_per_frame\"") != std::string::npos);
+    TEST_ASSERT_FALSE(display.isAsyncFlush());
+}
+
+void runBenchmarkTests() {
+    RUN_TEST(test_benchmarks_pass_on_host);
+}
@@ -0,0 +1,217 @@
+#include <unity.h>
+#include <driver/gpio.h>
+#include "HostHal.h"
+#include "EmergencyStop.h"
+#include "MotionTask.h"
+#include "Metrics.h"
+
+// Parada de emergência: a ISR entra pela borda do ESTOP_PIN simulado, no meio
+// do que a tarefa de movimento estiver fazendo.
+
+static StepperController stepper;
+static MotionTask* backgroundMotion;
+
+static void tickFor(MotionTask& motion, unsigned long ms) {
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += MOTION_TASK_PERIOD_MS) {
+        motion.tick();
+        HostHal::advanceMillis(MOTION_TASK_PERIOD_MS);
+    }
+}
+
+static void startMotion(MotionTask& motion) {
+    stepper.begin();
+    stepper.setAbsolutePosition(0);
+    EmergencyStop::begin();
+    motion.begin();
+    motion.setEnabled(true);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+}
+
+static void pressEstop() {
+    HostHal::setInput(ESTOP_PIN, ESTOP_ACTIVE_LEVEL);
+}
+
+static void releaseEstop() {
+    HostHal::setInput(ESTOP_PIN, !ESTOP_ACTIVE_LEVEL);
+}
+
+// A ISR sai do serviço de ISR em IRAM, para valer durante as operações de flash
+static void test_isr_registered_in_iram() {
+    EmergencyStop::begin();
+    TEST_ASSERT_TRUE(HostHal::isrServiceFlags() >= 0);
+    TEST_ASSERT_TRUE(HostHal::isrServiceFlags() & ESP_INTR_FLAG_IRAM);
+
+    pressEstop();
+    TEST_ASSERT_TRUE(EmergencyStop::isTripped());
+}
+
+// A borda corta ENABLE e relé na própria ISR e trava o estado
+static void test_trip_cuts_outputs() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    EmergencyStop::guardedWrite(RELAY_PIN, LOW);
+    TEST_ASSERT_EQUAL(LOW, HostHal::outputLevel(ENABLE_PIN));
+
+    pressEstop();
+
+    TEST_ASSERT_TRUE(EmergencyStop::isTripped());
+    TEST_ASSERT_EQUAL_UINT8(ESTOP_INPUT, EmergencyStop::getCause());
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(ENABLE_PIN));
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(RELAY_PIN));
+
+    // Um segundo acionamento não troca a causa
+    EmergencyStop::trip(ESTOP_WATCHDOG);
+    TEST_ASSERT_EQUAL_UINT8(ESTOP_INPUT, EmergencyStop::getCause());
+}
+
+// Com a trava ativa as escritas que energizam saídas são recusadas
+static void test_guarded_write_refused_while_tripped() {
+    pinMode(RELAY_PIN, OUTPUT);
+    TEST_ASSERT_TRUE(EmergencyStop::guardedWrite(RELAY_PIN, LOW));
+    TEST_ASSERT_EQUAL(LOW, HostHal::outputLevel(RELAY_PIN));
+
+    EmergencyStop::trip(ESTOP_INPUT);
+    TEST_ASSERT_FALSE(EmergencyStop::guardedWrite(RELAY_PIN, LOW));
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(RELAY_PIN));
+}
+
+// O rearme só é aceito com a entrada liberada
+static void test_reset_requires_released_input() {
+    EmergencyStop::begin();
+    pressEstop();
+
+    TEST_ASSERT_FALSE(EmergencyStop::reset());
+    TEST_ASSERT_TRUE(EmergencyStop::isTripped());
+
+    releaseEstop();
+    TEST_ASSERT_TRUE(EmergencyStop::reset());
+    TEST_ASSERT_FALSE(EmergencyStop::isTripped());
+    TEST_ASSERT_EQUAL_UINT8(ESTOP_NONE, EmergencyStop::getCause());
+    TEST_ASSERT_TRUE(EmergencyStop::guardedWrite(RELAY_PIN, LOW));
+}
+
+// Reinício pelo watchdog volta com a parada acionada
+static void test_watchdog_reset_trips_on_boot() {
+    HostHal::setResetReason(ESP_RST_TASK_WDT);
+    EmergencyStop::begin();
+    TEST_ASSERT_TRUE(EmergencyStop::isTripped());
+    TEST_ASSERT_EQUAL_UINT8(ESTOP_WATCHDOG, EmergencyStop::getCause());
+}
+
+// Watchdog que não pôde ser configurado: aparece na serial e nas métricas
+static void test_watchdog_init_failure_is_reported() {
+    HostHal::setWatchdogInitResult(ESP_ERR_INVALID_STATE);
+    stepper.begin();
+    MotionTask motion(stepper);
+    motion.begin();
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_WATCHDOG_ERRORS));
+    TEST_ASSERT_TRUE(HostHal::serialOutput().find("esp_task_wdt_init falhou (ESP_ERR_INVALID_STATE)") !=
+                     std::string::npos);
+}
+
+// Interrupção no meio de um ciclo: as saídas caem na hora, a tarefa aborta
+// no tick seguinte, registra o ciclo interrompido e recusa movimentos até o
+// rearme, depois do qual o motor continua desabilitado
+static void test_abort_for_emergency_during_cycle() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    motion.setRelayTiming(20, 10);
+    motion.startCycle(1);
+    tickFor(motion, 95);
+    uint32_t steps = HostHal::risingEdges(STEP_PIN);
+    TEST_ASSERT_TRUE(steps > 0);
+
+    pressEstop();
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(ENABLE_PIN));
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(RELAY_PIN));
+
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    MotionStatus s = motion.getStatus();
+    TEST_ASSERT_TRUE(s.emergencyStop);
+    TEST_ASSERT_EQUAL_UINT8(ESTOP_INPUT, s.emergencyCause);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+    TEST_ASSERT_FALSE(s.enabled);
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_EMERGENCY_STOPS));
+    TEST_ASSERT_EQUAL_UINT32(1, History::getStats().outcomes[HIST_EMERGENCY]);
+
+    // Nada se move nem energiza enquanto a trava está ativa
+    motion.startCycle(1);
+    motion.move(100);
+    tickFor(motion, 200);
+    TEST_ASSERT_EQUAL_UINT32(steps, HostHal::risingEdges(STEP_PIN));
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(RELAY_PIN));
+
+    // Rearme com a entrada acionada é ignorado
+    motion.resetEmergencyStop();
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    TEST_ASSERT_TRUE(motion.getStatus().emergencyStop);
+
+    releaseEstop();
+    motion.resetEmergencyStop();
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    s = motion.getStatus();
+    TEST_ASSERT_FALSE(s.emergencyStop);
+    TEST_ASSERT_FALSE(s.enabled);
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(ENABLE_PIN));
+}
+
+// Interrupção no meio de um posicionamento pelo timer: a ISR de passos para
+// de pulsar na hora, antes de a tarefa abortar
+static void test_abort_for_emergency_during_move() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    motion.move(10 * BASE_STEPS_PER_REV);
+    tickFor(motion, 50);
+    TEST_ASSERT_TRUE(HostHal::timerRunning());
+
+    pressEstop();
+    uint32_t steps = HostHal::risingEdges(STEP_PIN);
+    HostHal::advanceMillis(20);
+    TEST_ASSERT_EQUAL_UINT32(steps, HostHal::risingEdges(STEP_PIN));
+
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    MotionStatus s = motion.getStatus();
+    TEST_ASSERT_TRUE(s.emergencyStop);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+    TEST_ASSERT_FALSE(HostHal::timerRunning());
+    TEST_ASSERT_EQUAL_INT64((int64_t)steps, s.absolutePosition);
+}
+
+static void tickBackgroundMotion() {
+    backgroundMotion->tick();
+}
+
+// Teste de latência ('e') com o ESTOP_TEST_PIN ligado ao ESTOP_PIN: a cada
+// acionamento a tarefa de movimento (rodando durante os delay()) trata a
+// parada e o rearme passa pela fila de comandos
+static void test_latency_test_rearms_through_motion_task() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    HostHal::wire(ESTOP_TEST_PIN, ESTOP_PIN);
+    backgroundMotion = &motion;
+    HostHal::setBackgroundTask(tickBackgroundMotion);
+
+    EmergencyStop::runLatencyTest(Serial, motion);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+
+    std::string out = HostHal::serialOutput();
+    TEST_ASSERT_TRUE(out.find("\"bench\":\"estop_latency\",\"samples\":20,") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("\"pass\":true") != std::string::npos);
+    // Todos os acionamentos chegaram à tarefa, inclusive o último, que fica
+    // travado para o rearme pela tela
+    TEST_ASSERT_EQUAL_UINT32(20, Metrics::getCounter(CNT_EMERGENCY_STOPS));
+    TEST_ASSERT_TRUE(motion.getStatus().emergencyStop);
+    TEST_ASSERT_TRUE(EmergencyStop::isTripped());
+}
+
+void runEmergencyStopTests() {
+    RUN_TEST(test_isr_registered_in_iram);
+    RUN_TEST(test_trip_cuts_outputs);
+    RUN_TEST(test_guarded_write_refused_while_tripped);
+    RUN_TEST(test_reset_requires_released_input);
+    RUN_TEST(test_watchdog_reset_trips_on_boot);
+    RUN_TEST(test_watchdog_init_failure_is_reported);
+    RUN_TEST(test_abort_for_emergency_during_cycle);
+    RUN_TEST(test_abort_for_emergency_during_move);
+    RUN_TEST(test_latency_test_rearms_through_motion_task);
+}
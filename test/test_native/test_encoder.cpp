@@ -0,0 +1,127 @@
+#include <unity.h>
+#include "HostHal.h"
+#include "EncoderHandler.h"
+#include "Metrics.h"
+
+// Decodificação do encoder por amostragem: update() é chamado a cada
+// milissegundo, como no loop(), enquanto o teste gira o eixo simulado.
+
+static int clkLevel;
+static int dtLevel;
+
+static void pollFor(EncoderHandler& encoder, unsigned long ms) {
+    for (unsigned long i = 0; i < ms; i++) {
+        encoder.update();
+        HostHal::advanceMillis(1);
+    }
+}
+
+// Uma mudança de CLK em quadratura. No sentido horário o DT já está no
+// nível oposto ao novo CLK quando este muda; no anti-horário, igual.
+static void clkEdge(EncoderHandler& encoder, bool clockwise) {
+    clkLevel = !clkLevel;
+    dtLevel = clockwise ? !clkLevel : clkLevel;
+    HostHal::setInput(ENCODER_DT, dtLevel);
+    pollFor(encoder, 1);
+    HostHal::setInput(ENCODER_CLK, clkLevel);
+    pollFor(encoder, 1);
+}
+
+static void detent(EncoderHandler& encoder, bool clockwise) {
+    for (int i = 0; i < ENCODER_PULSES_PER_STEP; i++) {
+        clkEdge(encoder, clockwise);
+    }
+}
+
+// O estado filtrado do botão é estático em update(): cada caso termina com o
+// botão solto e estável para não contaminar o seguinte
+static void startEncoder(EncoderHandler& encoder) {
+    clkLevel = HIGH;
+    dtLevel = HIGH;
+    encoder.begin();
+    pollFor(encoder, 100);
+}
+
+static void test_clockwise_detent() {
+    EncoderHandler encoder;
+    startEncoder(encoder);
+
+    detent(encoder, true);
+
+    TEST_ASSERT_EQUAL_INT(1, encoder.getDirection());
+    TEST_ASSERT_EQUAL_INT(0, encoder.getDirection());
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_ENCODER_DETENTS));
+}
+
+static void test_counterclockwise_detent() {
+    EncoderHandler encoder;
+    startEncoder(encoder);
+
+    detent(encoder, false);
+
+    TEST_ASSERT_EQUAL_INT(-1, encoder.getDirection());
+}
+
+// Menos de ENCODER_PULSES_PER_STEP mudanças não geram passo; um recuo
+// desconta os pulsos já acumulados
+static void test_partial_detent_and_reversal() {
+    EncoderHandler encoder;
+    startEncoder(encoder);
+
+    for (int i = 0; i < ENCODER_PULSES_PER_STEP - 1; i++) {
+        clkEdge(encoder, true);
+    }
+    TEST_ASSERT_EQUAL_INT(0, encoder.getDirection());
+
+    clkEdge(encoder, false);
+    clkEdge(encoder, true);
+    TEST_ASSERT_EQUAL_INT(0, encoder.getDirection());
+
+    clkEdge(encoder, true);
+    TEST_ASSERT_EQUAL_INT(1, encoder.getDirection());
+}
+
+// Um passo não lido é sobrescrito pelo seguinte e contado como perdido
+static void test_unread_detent_is_dropped() {
+    EncoderHandler encoder;
+    startEncoder(encoder);
+
+    detent(encoder, true);
+    detent(encoder, false);
+
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_ENCODER_DROPPED));
+    TEST_ASSERT_EQUAL_INT(-1, encoder.getDirection());
+}
+
+// Trepidação mais curta que o debounce não gera clique; o nível estável gera
+// exatamente um, e soltar não gera outro
+static void test_button_debounce() {
+    EncoderHandler encoder;
+    startEncoder(encoder);
+
+    for (int i = 0; i < 5; i++) {
+        HostHal::setInput(ENCODER_SW, LOW);
+        pollFor(encoder, 10);
+        HostHal::setInput(ENCODER_SW, HIGH);
+        pollFor(encoder, 10);
+    }
+    TEST_ASSERT_FALSE(encoder.isPressed());
+
+    HostHal::setInput(ENCODER_SW, LOW);
+    pollFor(encoder, 100);
+    TEST_ASSERT_TRUE(encoder.isPressed());
+    TEST_ASSERT_FALSE(encoder.isPressed());
+
+    HostHal::setInput(ENCODER_SW, HIGH);
+    pollFor(encoder, 100);
+    TEST_ASSERT_FALSE(encoder.isPressed());
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_BUTTON_PRESSES));
+}
+
+void runEncoderTests() {
+    RUN_TEST(test_clockwise_detent);
+    RUN_TEST(test_counterclockwise_detent);
+    RUN_TEST(test_partial_detent_and_reversal);
+    RUN_TEST(test_unread_detent_is_dropped);
+    RUN_TEST(test_button_debounce);
+}
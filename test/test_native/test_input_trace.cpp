@@ -0,0 +1,166 @@
+#include <unity.h>
+#include <string>
+#include "HostHal.h"
+#include "InputTrace.h"
+#include "DisplayManager.h"
+
+// Relógio próprio do teste para a gravação e a reprodução (setClock), sem
+// passar pelo relógio virtual do HostHal
+static unsigned long traceClockUs;
+
+static unsigned long traceClock() {
+    return traceClockUs;
+}
+
+// Grava: horário em 10 ms, anti-horário em 30 ms e clique em 20,03 s (o
+// intervalo de 20 s passa de 14 bits e usa uma palavra de extensão)
+static std::string recordAndExport() {
+    InputTrace::setClock(traceClock);
+    traceClockUs = 1000000;
+    InputTrace::startRecording();
+    traceClockUs += 10000;
+    InputTrace::record(INPUT_CW);
+    traceClockUs += 20000;
+    InputTrace::record(INPUT_CCW);
+    traceClockUs += 20000000;
+    InputTrace::record(INPUT_PRESS);
+    InputTrace::stopRecording();
+
+    HostHal::clearSerialOutput();
+    InputTrace::exportHex(Serial);
+    return HostHal::serialOutput();
+}
+
+// Avança o relógio até 'us' e retorna o evento entregue nesse instante
+static int eventAt(unsigned long us) {
+    traceClockUs = us;
+    return InputTrace::nextDueEvent();
+}
+
+static void test_export_import_round_trip() {
+    std::string exported = recordAndExport();
+    TEST_ASSERT_EQUAL_UINT32(8, InputTrace::size());
+    TEST_ASSERT_TRUE(exported.find("=== TRACE 8 bytes ===") != std::string::npos);
+    TEST_ASSERT_TRUE(exported.find("=== END ===") != std::string::npos);
+
+    // Uma gravação nova por cima, depois a importação do texto exportado
+    InputTrace::startRecording();
+    InputTrace::record(INPUT_PRESS);
+    InputTrace::stopRecording();
+    HostHal::serialInput(exported.c_str());
+    TEST_ASSERT_TRUE(InputTrace::importHex(Serial));
+    TEST_ASSERT_EQUAL_UINT32(8, InputTrace::size());
+
+    HostHal::clearSerialOutput();
+    InputTrace::exportHex(Serial);
+    TEST_ASSERT_EQUAL_STRING(exported.c_str(), HostHal::serialOutput().c_str());
+}
+
+// A reprodução entrega cada evento no mesmo intervalo da gravação
+static void test_replay_follows_recorded_timing() {
+    std::string exported = recordAndExport();
+    HostHal::serialInput(exported.c_str());
+    TEST_ASSERT_TRUE(InputTrace::importHex(Serial));
+
+    unsigned long start = 5000000;
+    traceClockUs = start;
+    InputTrace::startReplay();
+    TEST_ASSERT_TRUE(InputTrace::isReplaying());
+
+    TEST_ASSERT_EQUAL_INT(-1, eventAt(start + 9999));
+    TEST_ASSERT_EQUAL_INT(INPUT_CW, eventAt(start + 10000));
+    TEST_ASSERT_EQUAL_INT(-1, eventAt(start + 10000));
+    TEST_ASSERT_EQUAL_INT(-1, eventAt(start + 29999));
+    TEST_ASSERT_EQUAL_INT(INPUT_CCW, eventAt(start + 30000));
+    TEST_ASSERT_EQUAL_INT(-1, eventAt(start + 20029999));
+    TEST_ASSERT_EQUAL_INT(INPUT_PRESS, eventAt(start + 20030000));
+    TEST_ASSERT_EQUAL_INT(-1, eventAt(start + 20040000));
+    TEST_ASSERT_FALSE(InputTrace::isReplaying());
+}
+
+// Latências medidas na tarefa da interface: flush e a primeira passagem
+// para uma fase de movimento vista no snapshot
+static void test_replay_latency_from_motion_snapshot() {
+    recordAndExport();
+    unsigned long start = 5000000;
+    traceClockUs = start;
+    InputTrace::observeMotion(false);
+    InputTrace::startReplay();
+
+    uint32_t staleFrame = InputTrace::currentEvent();   // Desenhado antes do evento
+    TEST_ASSERT_EQUAL_INT(INPUT_CW, eventAt(start + 10000));
+    traceClockUs += 200;
+    InputTrace::markFlush(staleFrame, InputTrace::now());   // Ainda estava na fila: não conta
+    traceClockUs += 500;
+    uint32_t frame = InputTrace::currentEvent();
+    InputTrace::markFlush(frame, InputTrace::now());
+    traceClockUs += 300;
+    InputTrace::markFlush(frame, InputTrace::now());        // Só o primeiro flush conta
+    InputTrace::observeMotion(false);
+    traceClockUs += 1500;
+    InputTrace::observeMotion(true);    // Primeiro snapshot fora de PHASE_IDLE
+
+    // O movimento continua: o evento seguinte não gerou um movimento novo, e
+    // o quadro do evento anterior que termina depois dele também não conta
+    TEST_ASSERT_EQUAL_INT(INPUT_CCW, eventAt(start + 30000));
+    InputTrace::observeMotion(true);
+    InputTrace::markFlush(frame, InputTrace::now());
+    TEST_ASSERT_EQUAL_INT(INPUT_PRESS, eventAt(start + 20030000));
+
+    std::string output = HostHal::serialOutput();
+    TEST_ASSERT_TRUE(output.find("{\"replay_event\":0,\"type\":\"cw\",\"flush_us\":700,\"motion_us\":2500}") !=
+                     std::string::npos);
+    TEST_ASSERT_TRUE(output.find("{\"replay_event\":1,\"type\":\"ccw\",\"flush_us\":-1,\"motion_us\":-1}") !=
+                     std::string::npos);
+    InputTrace::stopReplay();
+    InputTrace::observeMotion(false);
+}
+
+// Flush direto (backend do host): o quadro desenhado depois do evento é
+// marcado na própria chamada da tela
+static void test_replay_flush_latency_from_display() {
+    DisplayManager display;
+    display.begin();
+    recordAndExport();
+    unsigned long start = 5000000;
+    traceClockUs = start;
+    InputTrace::startReplay();
+
+    TEST_ASSERT_EQUAL_INT(INPUT_CW, eventAt(start + 10000));
+    traceClockUs += 1200;
+    display.showMotorDisabled();
+    display.reportFlushes();            // Nada pendente sem a tarefa de flush
+    InputTrace::stopReplay();
+
+    TEST_ASSERT_TRUE(HostHal::serialOutput().find("{\"replay_event\":0,\"type\":\"cw\",\"flush_us\":1200,") !=
+                     std::string::npos);
+}
+
+static void test_import_rejects_bad_text() {
+    static const char* const bad[] = {
+        "=== TRACE 2 bytes ===\n0g40\n=== END ===\n",      // Dígito inválido
+        "=== TRACE 2 bytes ===\n0a4\n=== END ===\n",       // Número ímpar de dígitos
+        "=== TRACE 4 bytes ===\n0a40\n=== END ===\n",      // Tamanho diferente do cabeçalho
+        "=== TRACE 2 bytes ===\n0a40\n",                   // Sem END: tempo esgotado
+    };
+    for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        HostHal::serialInput(bad[i]);
+        TEST_ASSERT_FALSE(InputTrace::importHex(Serial));
+        TEST_ASSERT_EQUAL_UINT32(0, InputTrace::size());
+        // O resto do texto foi consumido: nada vira comando serial
+        TEST_ASSERT_EQUAL_INT(0, Serial.available());
+    }
+    // Quebras de linha CRLF do terminal
+    HostHal::serialInput("=== TRACE 2 bytes ===\r\n0A40\r\n=== END ===\r\n");
+    TEST_ASSERT_TRUE(InputTrace::importHex(Serial));
+    TEST_ASSERT_EQUAL_UINT32(2, InputTrace::size());
+}
+
+void runInputTraceTests() {
+    RUN_TEST(test_export_import_round_trip);
+    RUN_TEST(test_replay_follows_recorded_timing);
+    RUN_TEST(test_replay_latency_from_motion_snapshot);
+    RUN_TEST(test_replay_flush_latency_from_display);
+    RUN_TEST(test_import_rejects_bad_text);
+    InputTrace::setClock(micros);
+}
@@ -0,0 +1,48 @@
+// Testes no host (pio test -e native): o firmware compilado para o PC, sobre
+// o hardware simulado de stubs/HostHal. Um único executável; cada arquivo
+// registra os seus casos numa função run*Tests().
+#include <unity.h>
+#include "HostHal.h"
+#include "config.h"
+#include "Metrics.h"
+#include "EmergencyStop.h"
+#include "History.h"
+
+void runMotionMathTests();
+void runMotionTaskTests();
+void runEncoderTests();
+void runEmergencyStopTests();
+void runStepPulseEncoderTests();
+void runTmc2209Tests();
+void runInputTraceTests();
+void runBenchmarkTests();
+void runResumeStateTests();
+void runScreenTests();
+
+// Cada caso parte do hardware em repouso: relógio em 0, entrada de
+// emergência desacionada, métricas zeradas e histórico vazio
+void setUp() {
+    HostHal::reset();
+    HostHal::setInput(ESTOP_PIN, !ESTOP_ACTIVE_LEVEL);
+    EmergencyStop::reset();
+    Metrics::reset();
+    History::begin();
+    HostHal::clearSerialOutput();
+}
+
+void tearDown() {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    runMotionMathTests();
+    runMotionTaskTests();
+    runEncoderTests();
+    runEmergencyStopTests();
+    runStepPulseEncoderTests();
+    runTmc2209Tests();
+    runInputTraceTests();
+    runBenchmarkTests();
+    runResumeStateTests();
+    runScreenTests();
+    return UNITY_END();
+}
@@ -0,0 +1,37 @@
+#include <unity.h>
+#include "MotionMath.h"
+
+// Mesmos casos do benchShortestPath() (comando serial 'b')
+static void test_shortest_path_known_cases() {
+    // {atual, alvo, passos/volta, esperado}
+    static const int cases[][4] = {
+        {0,    0,    200,  0},
+        {0,    50,   200,  50},
+        {0,    150,  200,  -50},
+        {199,  0,    200,  1},
+        {0,    199,  200,  -1},
+        {0,    100,  200,  100},
+        {10,   3190, 3200, -20},
+        {3190, 10,   3200, 20},
+    };
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(cases[i][3], shortestPathSteps(cases[i][0], cases[i][1], cases[i][2]));
+    }
+}
+
+// O caminho nunca passa de meia volta e sempre chega ao alvo
+static void test_shortest_path_reaches_target_within_half_turn() {
+    const int stepsPerRev = 400;
+    for (int current = 0; current < stepsPerRev; current += 7) {
+        for (int target = 0; target < stepsPerRev; target += 11) {
+            int steps = shortestPathSteps(current, target, stepsPerRev);
+            TEST_ASSERT_TRUE(steps >= -stepsPerRev / 2 && steps <= stepsPerRev / 2);
+            TEST_ASSERT_EQUAL_INT(target, wrapPosition(current + steps, stepsPerRev));
+        }
+    }
+}
+
+void runMotionMathTests() {
+    RUN_TEST(test_shortest_path_known_cases);
+    RUN_TEST(test_shortest_path_reaches_target_within_half_turn);
+}
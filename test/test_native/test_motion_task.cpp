@@ -0,0 +1,164 @@
+#include <unity.h>
+#include "HostHal.h"
+#include "MotionTask.h"
+#include "Metrics.h"
+
+// A tarefa de movimento sem FreeRTOS: o teste faz o papel do vTaskDelayUntil,
+// chamando tick() e avançando o relógio virtual um período por vez. Os
+// alarmes do timer de passos disparam dentro desse avanço.
+
+static StepperController stepper;
+
+// Transições do relé (ativo em LOW) e instantes das bordas de STEP
+struct CycleTrace {
+    unsigned long relayOn[8];
+    unsigned long relayOff[8];
+    unsigned long steps[8];
+    int relayOnCount;
+    int relayOffCount;
+    int stepCount;
+};
+
+static void tickFor(MotionTask& motion, unsigned long ms, CycleTrace* trace = NULL) {
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += MOTION_TASK_PERIOD_MS) {
+        int relayBefore = HostHal::outputLevel(RELAY_PIN);
+        uint32_t stepsBefore = HostHal::risingEdges(STEP_PIN);
+        unsigned long now = millis();
+        motion.tick();
+        if (trace != NULL) {
+            int relay = HostHal::outputLevel(RELAY_PIN);
+            if (relay != relayBefore && relay == LOW && trace->relayOnCount < 8) {
+                trace->relayOn[trace->relayOnCount++] = now;
+            } else if (relay != relayBefore && relay == HIGH && trace->relayOffCount < 8) {
+                trace->relayOff[trace->relayOffCount++] = now;
+            }
+            if (HostHal::risingEdges(STEP_PIN) != stepsBefore && trace->stepCount < 8) {
+                trace->steps[trace->stepCount++] = now;
+            }
+        }
+        HostHal::advanceMillis(MOTION_TASK_PERIOD_MS);
+    }
+}
+
+// Roda até a tarefa voltar ao repouso (ou estourar o limite)
+static MotionStatus tickUntilIdle(MotionTask& motion, unsigned long limitMs) {
+    MotionStatus s = motion.getStatus();
+    for (unsigned long elapsed = 0; elapsed < limitMs; elapsed += MOTION_TASK_PERIOD_MS) {
+        tickFor(motion, MOTION_TASK_PERIOD_MS);
+        s = motion.getStatus();
+        if (motion.isCaughtUp(s) && s.phase == PHASE_IDLE) break;
+    }
+    return s;
+}
+
+static void startMotion(MotionTask& motion) {
+    stepper.begin();
+    stepper.setAbsolutePosition(0);
+    motion.begin();
+    motion.setEnabled(true);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+}
+
+// Cada passo do ciclo: relé ligado pelo tempo configurado, passo na
+// desligada, estabilização e o relé de novo
+static void test_cycle_phase_timing() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    motion.setRelayTiming(20, 10);
+    motion.startCycle(1);
+
+    CycleTrace trace;
+    memset(&trace, 0, sizeof(trace));
+    tickFor(motion, 200, &trace);
+
+    TEST_ASSERT_GREATER_OR_EQUAL(5, trace.relayOffCount);
+    for (int i = 0; i < 5; i++) {
+        // Relé ligado: exatamente o tempo pedido, com o período da tarefa de folga
+        TEST_ASSERT_UINT32_WITHIN(MOTION_TASK_PERIOD_MS, 20, trace.relayOff[i] - trace.relayOn[i]);
+        // O passo sai no mesmo tick que desliga o relé
+        TEST_ASSERT_EQUAL_UINT32(trace.relayOff[i], trace.steps[i]);
+        // Estabilização até o próximo acionamento
+        TEST_ASSERT_UINT32_WITHIN(MOTION_TASK_PERIOD_MS, 10, trace.relayOn[i + 1] - trace.relayOff[i]);
+    }
+    TEST_ASSERT_UINT32_WITHIN(MOTION_TASK_PERIOD_MS, 0, Metrics::getTimer(TMR_RELAY_OVERRUN).max);
+    TEST_ASSERT_UINT32_WITHIN(MOTION_TASK_PERIOD_MS, 0, Metrics::getTimer(TMR_SETTLE_OVERRUN).max);
+}
+
+// Um ciclo completo: uma volta em passos inteiros, registrado no histórico
+// com a duração ativa
+static void test_cycle_completes_one_revolution() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    motion.setRelayTiming(20, 10);
+    motion.startCycle(1);
+
+    MotionStatus s = tickUntilIdle(motion, BASE_STEPS_PER_REV * 40);
+
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+    TEST_ASSERT_EQUAL_INT32(1, s.cyclesCompleted);
+    TEST_ASSERT_EQUAL_UINT32(BASE_STEPS_PER_REV, HostHal::risingEdges(STEP_PIN));
+    TEST_ASSERT_EQUAL_INT64(BASE_STEPS_PER_REV, s.absolutePosition);
+    TEST_ASSERT_EQUAL(HIGH, HostHal::outputLevel(RELAY_PIN));
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_CYCLES_COMPLETED));
+
+    HistoryStats stats = History::getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.outcomes[HIST_COMPLETED]);
+    // 200 x (20 + 10) ms, com a folga de um período por fase
+    TEST_ASSERT_UINT32_WITHIN(2 * BASE_STEPS_PER_REV * MOTION_TASK_PERIOD_MS,
+                              BASE_STEPS_PER_REV * 30, (uint32_t)stats.completedDurationMs);
+}
+
+// Posicionamento pelo timer de passos: para exatamente no alvo
+static void test_position_move_stops_on_target() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    motion.move(3 * BASE_STEPS_PER_REV / 2);
+
+    MotionStatus s = tickUntilIdle(motion, 10000);
+
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+    TEST_ASSERT_EQUAL_INT64(3 * BASE_STEPS_PER_REV / 2, s.absolutePosition);
+    TEST_ASSERT_EQUAL_UINT32(3 * BASE_STEPS_PER_REV / 2, HostHal::risingEdges(STEP_PIN));
+    TEST_ASSERT_FALSE(HostHal::timerRunning());
+}
+
+// O micro-passo automático troca de resolução pela fase do tradutor, não
+// pela posição: com o tradutor fora de fase em relação à posição zerada,
+// toda resolução grossa em uso ainda cai numa fase múltipla do seu passo
+static void test_auto_microstep_aligns_to_driver_phase() {
+    MotionTask motion(stepper);
+    startMotion(motion);
+    const int finest = ActiveDriver::MICROSTEP_COUNT - 1;
+    motion.setMicrostep(finest);
+    motion.move(3);
+    tickUntilIdle(motion, 1000);
+    // Zera a posição; sem DRIVER_RESET_PIN a fase continua 3 micro-passos à frente
+    motion.setMicrostep(finest, true);
+    motion.setSpeedProfile(SPEED_POSITIONING, 300);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    TEST_ASSERT_EQUAL_UINT32(3, stepper.getDriverPhase());
+
+    const int64_t target = 10LL * BASE_STEPS_PER_REV * ActiveDriver::multipliers[finest];
+    motion.move(target);
+    int maxShift = 0;
+    for (int i = 0; i < 20000 && (i < 2 || motion.getStatus().phase != PHASE_IDLE); i++) {
+        motion.tick();
+        for (int j = 0; j < 10; j++) {
+            HostHal::advanceMicros(100);
+            int shift = stepper.getStepShift();
+            maxShift = max(maxShift, shift);
+            TEST_ASSERT_EQUAL_UINT32(0, stepper.getDriverPhase() & ((1UL << shift) - 1));
+        }
+    }
+
+    TEST_ASSERT_TRUE(maxShift > 0);
+    TEST_ASSERT_EQUAL_INT64(target, motion.getStatus().absolutePosition);
+    TEST_ASSERT_EQUAL_UINT32(3 + (uint32_t)target, stepper.getDriverPhase());
+}
+
+void runMotionTaskTests() {
+    RUN_TEST(test_cycle_phase_timing);
+    RUN_TEST(test_cycle_completes_one_revolution);
+    RUN_TEST(test_position_move_stops_on_target);
+    RUN_TEST(test_auto_microstep_aligns_to_driver_phase);
+}
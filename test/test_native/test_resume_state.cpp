@@ -0,0 +1,324 @@
+#include <unity.h>
+#include <new>
+#include "HostHal.h"
+#include "MotionTask.h"
+#include "ResumeState.h"
+
+// Ponto de retomada: os slots na memória RTC e a retomada de cada fase pela
+// tarefa de movimento depois de um reinício simulado. A memória RTC do host
+// (HostHal::rtcMemory()) atravessa o reinício; o resto volta à partida.
+
+static StepperController stepper;
+
+// Mesmo layout do ResumeSlot de ResumeState.cpp
+struct SlotView {
+    uint32_t magic;
+    uint32_t sequence;
+    ResumeSnapshot snapshot;
+    uint32_t crc;
+};
+
+static SlotView* slotViews() {
+    TEST_ASSERT_EQUAL_UINT32(2 * sizeof(SlotView), HostHal::rtcMemorySize());
+    return (SlotView*)HostHal::rtcMemory();
+}
+
+// Slot gravado por último (maior sequência entre os que têm a marca)
+static SlotView& newestSlot() {
+    SlotView* slots = slotViews();
+    if (slots[0].magic == 0) return slots[1];
+    if (slots[1].magic == 0) return slots[0];
+    return slots[0].sequence > slots[1].sequence ? slots[0] : slots[1];
+}
+
+// Partida como no setup(): ResumeState::begin() e o instantâneo restaurado
+static bool reboot(esp_reset_reason_t reason, ResumeSnapshot& point) {
+    HostHal::setResetReason(reason);
+    ResumeState::begin();
+    return ResumeState::load(point);
+}
+
+static void saveAt(int64_t position) {
+    ResumeSnapshot point;
+    memset(&point, 0, sizeof(point));
+    point.absolutePosition = position;
+    ResumeState::save(point);
+}
+
+static void tickFor(MotionTask& motion, unsigned long ms) {
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += MOTION_TASK_PERIOD_MS) {
+        motion.tick();
+        HostHal::advanceMillis(MOTION_TASK_PERIOD_MS);
+    }
+}
+
+static MotionStatus tickUntilIdle(MotionTask& motion, unsigned long limitMs) {
+    MotionStatus s = motion.getStatus();
+    for (unsigned long elapsed = 0; elapsed < limitMs; elapsed += MOTION_TASK_PERIOD_MS) {
+        tickFor(motion, MOTION_TASK_PERIOD_MS);
+        s = motion.getStatus();
+        if (motion.isCaughtUp(s) && s.phase == PHASE_IDLE) break;
+    }
+    return s;
+}
+
+// Roda até o instantâneo chegar à fase e à posição no ciclo pedidas
+static MotionStatus tickUntilPhase(MotionTask& motion, uint8_t phase, int32_t cyclePosition,
+                                   int32_t cyclesCompleted = 0) {
+    MotionStatus s = motion.getStatus();
+    for (int i = 0; i < 100000; i++) {
+        if (s.phase == phase && s.cyclePosition == cyclePosition && s.cyclesCompleted == cyclesCompleted) break;
+        tickFor(motion, MOTION_TASK_PERIOD_MS);
+        s = motion.getStatus();
+    }
+    TEST_ASSERT_EQUAL_UINT8(phase, s.phase);
+    TEST_ASSERT_EQUAL_INT32(cyclePosition, s.cyclePosition);
+    return s;
+}
+
+// O controlador volta ao estado de construção, como depois de um reinício
+// (a posição e o timer em andamento se perdem)
+static void restartStepper() {
+    stepper.~StepperController();
+    new (&stepper) StepperController();
+    stepper.begin();
+    stepper.setAbsolutePosition(0);
+}
+
+static void startMotion(MotionTask& motion) {
+    restartStepper();
+    motion.begin();
+    motion.setEnabled(true);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+}
+
+// Depois do reinício, na ordem do setup() e da tela de retomada
+static MotionStatus restartAndRestore(MotionTask& motion, const ResumeSnapshot& point, bool continueCycle) {
+    motion.restore(point);
+    restartStepper();
+    motion.begin();
+    motion.setRelayTiming(point.relayOnMs, point.settleMs);
+    motion.setEnabled(true);
+    motion.restoreResumePoint(continueCycle);
+    tickFor(motion, MOTION_TASK_PERIOD_MS);
+    return motion.getStatus();
+}
+
+// Cada gravação vai para o slot mais antigo; load() devolve a mais recente,
+// também depois de um reinício
+static void test_load_returns_newest_slot() {
+    ResumeSnapshot point;
+    TEST_ASSERT_FALSE(reboot(ESP_RST_POWERON, point));
+
+    for (int64_t position = 1; position <= 3; position++) {
+        saveAt(position);
+        TEST_ASSERT_TRUE(ResumeState::load(point));
+        TEST_ASSERT_EQUAL_INT64(position, point.absolutePosition);
+    }
+    SlotView* slots = slotViews();
+    TEST_ASSERT_EQUAL_UINT32(1, slots[0].sequence > slots[1].sequence ? slots[0].sequence - slots[1].sequence
+                                                                       : slots[1].sequence - slots[0].sequence);
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_SW, point));
+    TEST_ASSERT_EQUAL_INT64(3, point.absolutePosition);
+    saveAt(4);
+    TEST_ASSERT_TRUE(ResumeState::load(point));
+    TEST_ASSERT_EQUAL_INT64(4, point.absolutePosition);
+}
+
+// Reinício no meio de uma gravação: a marca só volta depois do CRC, e o
+// slot anterior continua valendo
+static void test_torn_write_keeps_previous_slot() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    saveAt(10);
+    saveAt(11);
+
+    SlotView& torn = newestSlot();
+    torn.snapshot.absolutePosition = 12;    // Dado novo já escrito, CRC e marca ainda não
+    torn.magic = 0;
+    TEST_ASSERT_TRUE(reboot(ESP_RST_BROWNOUT, point));
+    TEST_ASSERT_EQUAL_INT64(10, point.absolutePosition);
+
+    // A próxima gravação reaproveita o slot rasgado, não o válido
+    saveAt(13);
+    TEST_ASSERT_TRUE(ResumeState::load(point));
+    TEST_ASSERT_EQUAL_INT64(13, point.absolutePosition);
+    SlotView* slots = slotViews();
+    TEST_ASSERT_TRUE(slots[0].snapshot.absolutePosition == 10 || slots[1].snapshot.absolutePosition == 10);
+}
+
+static void test_bad_crc_is_rejected() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    saveAt(20);
+    saveAt(21);
+
+    SlotView* slots = slotViews();
+    SlotView& corrupted = newestSlot();
+    SlotView& previous = &corrupted == &slots[0] ? slots[1] : slots[0];
+    corrupted.snapshot.cyclePosition ^= 1;
+    TEST_ASSERT_TRUE(reboot(ESP_RST_TASK_WDT, point));
+    TEST_ASSERT_EQUAL_INT64(20, point.absolutePosition);
+
+    // Os dois corrompidos: nada a restaurar
+    previous.crc ^= 0x80000000UL;
+    TEST_ASSERT_FALSE(reboot(ESP_RST_TASK_WDT, point));
+}
+
+// Ao ligar a placa a memória RTC tem lixo: o instantâneo é descartado mesmo
+// com CRC válido, e os outros reinícios o mantêm
+static void test_power_on_discards_snapshot() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    saveAt(30);
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_BROWNOUT, point));
+    TEST_ASSERT_EQUAL_STRING("Queda de tensao", ResumeState::resetCauseName());
+    TEST_ASSERT_TRUE(reboot(ESP_RST_PANIC, point));
+    TEST_ASSERT_EQUAL_INT64(30, point.absolutePosition);
+
+    TEST_ASSERT_FALSE(reboot(ESP_RST_POWERON, point));
+    TEST_ASSERT_EQUAL_UINT32(0, slotViews()[0].magic);
+    TEST_ASSERT_EQUAL_UINT32(0, slotViews()[1].magic);
+}
+
+// Reinício na estabilização: a retomada continua do mesmo passo, e a volta
+// termina com o total de passos de um ciclo sem interrupção
+static void test_restore_resumes_cycle() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    {
+        MotionTask motion(stepper);
+        startMotion(motion);
+        motion.setRelayTiming(20, 10);
+        motion.startCycle(1);
+        tickUntilPhase(motion, PHASE_SETTLE, 37);
+    }
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_BROWNOUT, point));
+    TEST_ASSERT_EQUAL_UINT8(PHASE_SETTLE, point.phase);
+    TEST_ASSERT_EQUAL_INT64(37, point.absolutePosition);
+    TEST_ASSERT_EQUAL_INT32(20, point.relayOnMs);
+
+    MotionTask motion(stepper);
+    MotionStatus s = restartAndRestore(motion, point, true);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_SETTLE, s.phase);
+    TEST_ASSERT_EQUAL_INT64(37, s.absolutePosition);
+    TEST_ASSERT_EQUAL_INT32(37, s.cyclePosition);
+
+    s = tickUntilIdle(motion, BASE_STEPS_PER_REV * 40);
+    TEST_ASSERT_EQUAL_INT32(1, s.cyclesCompleted);
+    TEST_ASSERT_EQUAL_INT64(BASE_STEPS_PER_REV, s.absolutePosition);
+    TEST_ASSERT_EQUAL_UINT32(BASE_STEPS_PER_REV, HostHal::risingEdges(STEP_PIN));
+}
+
+// Reinício no segundo ciclo de um lote de 3: os ciclos concluídos e a origem
+// do ciclo em andamento voltam com ele
+static void test_restore_resumes_batch() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    {
+        MotionTask motion(stepper);
+        startMotion(motion);
+        motion.setRelayTiming(20, 10);
+        motion.startCycle(3);
+        tickUntilPhase(motion, PHASE_RELAY_ON, 50, 1);
+    }
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_TASK_WDT, point));
+    TEST_ASSERT_EQUAL_INT32(1, point.cyclesCompleted);
+    TEST_ASSERT_EQUAL_INT32(3, point.batchTotal);
+
+    MotionTask motion(stepper);
+    MotionStatus s = restartAndRestore(motion, point, true);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_RELAY_ON, s.phase);
+    TEST_ASSERT_EQUAL_INT64(BASE_STEPS_PER_REV + 50, s.absolutePosition);
+    TEST_ASSERT_EQUAL_INT32(1, s.cyclesCompleted);
+    TEST_ASSERT_EQUAL_INT32(3, s.batchTotal);
+
+    s = tickUntilIdle(motion, 3 * BASE_STEPS_PER_REV * 40);
+    TEST_ASSERT_EQUAL_INT32(3, s.cyclesCompleted);
+    TEST_ASSERT_EQUAL_INT64(3 * BASE_STEPS_PER_REV, s.absolutePosition);
+    TEST_ASSERT_EQUAL_UINT32(3 * BASE_STEPS_PER_REV, HostHal::risingEdges(STEP_PIN));
+}
+
+// Posicionamento: sem ciclo a retomar, só a posição volta. Um reinício no
+// meio do movimento deixa a posição sem referência.
+static void test_restore_positioning() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    {
+        MotionTask motion(stepper);
+        startMotion(motion);
+        motion.move(300);
+        TEST_ASSERT_EQUAL_INT64(300, tickUntilIdle(motion, 10000).absolutePosition);
+    }
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_SW, point));
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, point.phase);
+    TEST_ASSERT_FALSE(point.inMotion);
+    {
+        MotionTask motion(stepper);
+        MotionStatus s = restartAndRestore(motion, point, false);
+        TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+        TEST_ASSERT_EQUAL_INT64(300, s.absolutePosition);
+
+        motion.move(500);
+        tickUntilPhase(motion, PHASE_MOVING, 0);
+        tickFor(motion, 50);
+    }
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_SW, point));
+    TEST_ASSERT_TRUE(point.inMotion);
+    MotionTask motion(stepper);
+    MotionStatus s = restartAndRestore(motion, point, false);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_IDLE, s.phase);
+    TEST_ASSERT_EQUAL_INT64(0, s.absolutePosition);
+}
+
+// Indexador: reinício entre as estações 1 e 2. A retomada volta à estação de
+// partida e refaz o movimento até a seguinte.
+static void test_restore_resumes_indexer() {
+    ResumeSnapshot point;
+    reboot(ESP_RST_POWERON, point);
+    int32_t station = BASE_STEPS_PER_REV / 4;
+    {
+        MotionTask motion(stepper);
+        startMotion(motion);
+        motion.setRelayTiming(20, 10);
+        motion.startIndexing(1, 4);
+        tickUntilPhase(motion, PHASE_INDEX_MOVE, 1);
+        tickFor(motion, 20);
+        TEST_ASSERT_TRUE(motion.getStatus().absolutePosition > station);
+    }
+
+    TEST_ASSERT_TRUE(reboot(ESP_RST_BROWNOUT, point));
+    TEST_ASSERT_EQUAL_UINT8(PHASE_INDEX_MOVE, point.phase);
+    TEST_ASSERT_EQUAL_INT64(station, point.absolutePosition);
+    TEST_ASSERT_TRUE(point.indexing);
+
+    MotionTask motion(stepper);
+    MotionStatus s = restartAndRestore(motion, point, true);
+    TEST_ASSERT_EQUAL_UINT8(PHASE_INDEX_MOVE, s.phase);
+    TEST_ASSERT_EQUAL_INT32(1, s.cyclePosition);
+    TEST_ASSERT_EQUAL_INT32(4, s.cycleLength);
+    TEST_ASSERT_TRUE(s.absolutePosition >= station && s.absolutePosition < 2 * station);
+
+    s = tickUntilPhase(motion, PHASE_RELAY_ON, 2);
+    TEST_ASSERT_EQUAL_INT64(2 * station, s.absolutePosition);
+    s = tickUntilIdle(motion, 20000);
+    TEST_ASSERT_EQUAL_INT32(1, s.cyclesCompleted);
+    TEST_ASSERT_EQUAL_INT64(BASE_STEPS_PER_REV, s.absolutePosition);
+}
+
+void runResumeStateTests() {
+    RUN_TEST(test_load_returns_newest_slot);
+    RUN_TEST(test_torn_write_keeps_previous_slot);
+    RUN_TEST(test_bad_crc_is_rejected);
+    RUN_TEST(test_power_on_discards_snapshot);
+    RUN_TEST(test_restore_resumes_cycle);
+    RUN_TEST(test_restore_resumes_batch);
+    RUN_TEST(test_restore_positioning);
+    RUN_TEST(test_restore_resumes_indexer);
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <stdio.h>
+#include "HostHal.h"
+#include "DisplayManager.h"
+#include "StepperDriver.h"
+#include "Metrics.h"
+
+// Custo de desenho de cada tela no FrameCanvas, medido no relógio real do
+// host. O backend host grava cada quadro em .pio/; a transferência
+// (TMR_DISPLAY_TRANSFER) é descontada do tempo do chamador, sobrando o
+// desenho. Uma linha JSON por tela, no formato dos benchmarks ('b').
+
+#define SCREEN_ITERATIONS 50
+#define SCREEN_COUNT      8
+
+static DisplayManager display;
+
+static constexpr MenuNode sampleItems[] = {
+    menuAction("Item", NULL), menuAction("Item", NULL), menuAction("Item", NULL), menuAction("Item", NULL)
+};
+static constexpr MenuNode sampleMenu = menuSubmenu("Menu", sampleItems);
+static int sampleValue = 0;
+static constexpr NumberEditor sampleEditor = {"TEMPO DO RELE", "s", &sampleValue, 50, 5000, 50, 1000, NULL};
+
+static const char* drawScreen(int screen, int i) {
+    switch (screen) {
+        case 0: display.showMainMenu(sampleMenu, i % 4, 0, false); return "screen_main_menu";
+        case 1: display.showCycleProgress(i, 200, 1, 1, 0); return "screen_cycle_progress";
+        case 2: display.showPositioningSetup(i); return "screen_positioning_setup";
+        case 3: display.showPositioning(i, -i); return "screen_positioning";
+        case 4: display.showMicrostepSetup(ActiveDriver::labels, ActiveDriver::MICROSTEP_COUNT,
+                                           i % ActiveDriver::MICROSTEP_COUNT);
+                return "screen_microstep_setup";
+        case 5: display.showNumberEditor(sampleEditor, i * 50); return "screen_relay_time";
+        case 6: display.showDiagnostics(); return "screen_diagnostics";
+        default: display.showMotorDisabled(); return "screen_motor_disabled";
+    }
+}
+
+static bool frameHasPixels() {
+    const uint8_t* frame = display.getDisplay()->getBuffer();
+    for (int i = 0; i < FRAMEBUFFER_SIZE; i++) {
+        if (frame[i] != 0) return true;
+    }
+    return false;
+}
+
+// Cada chamada gera exatamente um quadro, com algo desenhado
+static void test_screen_render_cost() {
+    display.begin();
+    HostHal::useRealClock(true);
+
+    for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+        Metrics::reset();
+        const char* name = "";
+        uint32_t start = micros();
+        for (int i = 0; i < SCREEN_ITERATIONS; i++) {
+            name = drawScreen(screen, i);
+        }
+        uint32_t callerUs = micros() - start;
+        uint32_t transferUs = (uint32_t)Metrics::getTimer(TMR_DISPLAY_TRANSFER).total;
+
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(SCREEN_ITERATIONS, Metrics::getCounter(CNT_DISPLAY_FLUSHES), name);
+        TEST_ASSERT_TRUE_MESSAGE(frameHasPixels(), name);
+
+        uint32_t renderUs = callerUs > transferUs ? callerUs - transferUs : 0;
+        printf("{\"fw\":\"%s\",\"bench\":\"%s\",\"iterations\":%u,\"render_ns_per_frame\":%u,"
+               "\"transfer_ns_per_frame\":%u,\"backend\":\"%s\"}\n",
+               FIRMWARE_VERSION, name, SCREEN_ITERATIONS,
+               (unsigned)((uint64_t)renderUs * 1000 / SCREEN_ITERATIONS),
+               (unsigned)((uint64_t)transferUs * 1000 / SCREEN_ITERATIONS), ActiveDisplayBackend::NAME);
+    }
+}
+
+// A tarefa de flush não existe no host: com OLED_ASYNC_FLUSH ligado, a
+// guarda de DISPLAY_ASYNC_FLUSH deixa a gravação direta na chamada da tela
+static_assert(OLED_ASYNC_FLUSH && !DISPLAY_ASYNC_FLUSH, "Backend do host deve gravar na hora");
+
+static void test_host_backend_flushes_synchronously() {
+    display.begin();
+    Metrics::reset();
+    display.showMotorDisabled();
+    TEST_ASSERT_FALSE(display.flushPending());
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getCounter(CNT_DISPLAY_FLUSHES));
+    TEST_ASSERT_EQUAL_UINT32(1, Metrics::getTimer(TMR_DISPLAY_TRANSFER).count);
+}
+
+// PBM P4: linhas de 16 bytes, bit mais significativo à esquerda, pixel
+// aceso no OLED = bit 0 (branco)
+static void test_host_backend_writes_pbm() {
+    static uint8_t frame[FRAMEBUFFER_SIZE];
+    memset(frame, 0, sizeof(frame));
+    frame[(10 / 8) * SCREEN_WIDTH + 3] = 1 << (10 & 7);      // Pixel (3, 10)
+
+    HostDisplayBackend backend;
+    TEST_ASSERT_TRUE(backend.begin());
+    TEST_ASSERT_TRUE(backend.transferFrame(frame));
+
+    FILE* file = fopen(OLED_HOST_FRAME_PREFIX "00001.pbm", "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    char header[16] = {0};
+    TEST_ASSERT_TRUE(fgets(header, sizeof(header), file) != NULL);
+    TEST_ASSERT_EQUAL_STRING("P4\n", header);
+    TEST_ASSERT_TRUE(fgets(header, sizeof(header), file) != NULL);
+    TEST_ASSERT_EQUAL_STRING("128 64\n", header);
+    static uint8_t pixels[SCREEN_WIDTH / 8 * SCREEN_HEIGHT + 1];
+    size_t read = fread(pixels, 1, sizeof(pixels), file);
+    fclose(file);
+
+    TEST_ASSERT_EQUAL_UINT32(SCREEN_WIDTH / 8 * SCREEN_HEIGHT, read);
+    for (size_t i = 0; i < read; i++) {
+        uint8_t expected = (i == 10 * (SCREEN_WIDTH / 8)) ? (uint8_t)~(0x80 >> 3) : 0xFF;
+        TEST_ASSERT_EQUAL_HEX8(expected, pixels[i]);
+    }
+}
+
+void runScreenTests() {
+    RUN_TEST(test_screen_render_cost);
+    RUN_TEST(test_host_backend_flushes_synchronously);
+    RUN_TEST(test_host_backend_writes_pbm);
+}
@@ -0,0 +1,137 @@
+#include <unity.h>
+#include <vector>
+#include "StepPulseEncoder.h"
+
+// Os símbolos do RMT são decodificados de volta em passos: cada passo começa
+// num pulso em nível alto e dura até a próxima borda de subida, somando os
+// símbolos de continuação só em nível baixo. Os símbolos saem em blocos de
+// 32, a metade da memória do canal que a ISR do RMT recodifica.
+
+#define TEST_TICKS_PER_SECOND 10000000UL   // RMT_CLOCK_DIV 8: 10 MHz
+#define TEST_PULSE_TICKS      20           // 2 us
+#define TEST_BLOCK_SYMBOLS    32
+
+struct DecodedMove {
+    std::vector<uint32_t> pulses;       // Largura de cada pulso (ticks)
+    std::vector<uint32_t> intervals;    // De uma borda de subida à seguinte (ticks)
+    uint32_t reportedSteps;             // Soma dos passos informados por fill()
+    uint32_t zeroDurations;             // Metades de símbolo com duração 0
+    uint32_t highSecondHalves;          // Nível alto na segunda metade de um símbolo
+    uint32_t shortBlocks;               // Blocos incompletos antes do fim
+    bool done;
+};
+
+static DecodedMove encodeAndDecode(uint32_t steps, float maxSpeed, float acceleration) {
+    StepProfile profile = {steps, maxSpeed, acceleration, TEST_TICKS_PER_SECOND, TEST_PULSE_TICKS};
+    StepPulseEncoder encoder;
+    encoder.begin(profile);
+
+    DecodedMove move = {};
+    uint32_t block[TEST_BLOCK_SYMBOLS];
+    uint64_t now = 0;
+    uint64_t lastRise = 0;
+    size_t count;
+    do {
+        uint32_t blockSteps;
+        count = encoder.fill(block, TEST_BLOCK_SYMBOLS, blockSteps);
+        move.reportedSteps += blockSteps;
+        if (count < TEST_BLOCK_SYMBOLS && !encoder.done()) move.shortBlocks++;
+
+        for (size_t i = 0; i < count; i++) {
+            uint32_t duration0 = block[i] & 0x7FFF;
+            uint32_t duration1 = (block[i] >> 16) & 0x7FFF;
+            if (duration0 == 0 || duration1 == 0) move.zeroDurations++;
+            if (block[i] & (1UL << 31)) move.highSecondHalves++;
+            if (block[i] & (1UL << 15)) {
+                if (!move.pulses.empty()) move.intervals.push_back((uint32_t)(now - lastRise));
+                lastRise = now;
+                move.pulses.push_back(duration0);
+            }
+            now += duration0 + duration1;
+        }
+    } while (count == TEST_BLOCK_SYMBOLS);
+    move.done = encoder.done();
+    return move;
+}
+
+// Mesmos casos do benchStepEncoding() (comando serial 'b')
+static void test_step_count_and_pulse_width() {
+    // {passos, velocidade, aceleração}
+    static const uint32_t cases[][3] = {
+        {1,     1000,   1000},
+        {33,    100000, 200000},
+        {5000,  2000,   3000},      // Intervalos longos: símbolos só em nível baixo
+        {20000, 200000, 400000},
+    };
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        DecodedMove move = encodeAndDecode(cases[i][0], (float)cases[i][1], (float)cases[i][2]);
+        TEST_ASSERT_TRUE(move.done);
+        TEST_ASSERT_EQUAL_UINT32(0, move.shortBlocks);
+        TEST_ASSERT_EQUAL_UINT32(cases[i][0], move.reportedSteps);
+        TEST_ASSERT_EQUAL_UINT32(cases[i][0], move.pulses.size());
+        for (size_t s = 0; s < move.pulses.size(); s++) {
+            TEST_ASSERT_EQUAL_UINT32(TEST_PULSE_TICKS, move.pulses[s]);
+        }
+        // O marcador de fim do RMT nunca aparece no meio do movimento
+        TEST_ASSERT_EQUAL_UINT32(0, move.zeroDurations);
+        TEST_ASSERT_EQUAL_UINT32(0, move.highSecondHalves);
+    }
+}
+
+// Perfil de referência: trapézio com 400 passos de rampa e c0 = 0,01 s, de
+// modo que os primeiros passos passam de um símbolo (continuações)
+#define REF_STEPS        2000
+#define REF_MAX_SPEED    4000.0f
+#define REF_ACCELERATION 20000.0f
+#define REF_RAMP_STEPS   400        // v² / (2a)
+
+// Na aceleração, c(n) = c0·(√(n+1) − √n), com c0 = f·√(2/a); o primeiro
+// passo leva a correção de 0,676 de Austin e os seguintes convergem para a
+// fórmula exata (erro da recorrência < 3% em n = 1, < 0,1% a partir de 8)
+static void test_ramp_follows_exact_profile() {
+    DecodedMove move = encodeAndDecode(REF_STEPS, REF_MAX_SPEED, REF_ACCELERATION);
+    TEST_ASSERT_EQUAL_UINT32(REF_STEPS - 1, move.intervals.size());
+
+    double c0 = TEST_TICKS_PER_SECOND * sqrt(2.0 / REF_ACCELERATION);
+    TEST_ASSERT_TRUE(c0 > STEP_SYMBOL_MAX_DURATION);
+    TEST_ASSERT_UINT32_WITHIN(2, (uint32_t)(0.676 * c0), move.intervals[0]);
+    for (uint32_t n = 1; n < REF_RAMP_STEPS; n++) {
+        double exact = c0 * (sqrt(n + 1.0) - sqrt((double)n));
+        double tolerance = n < 8 ? 0.03 : 0.001;
+        TEST_ASSERT_FLOAT_WITHIN((float)(exact * tolerance), (float)exact, (float)move.intervals[n]);
+    }
+
+    // No platô o intervalo não passa do fim da rampa, c(rampa - 1), que fica
+    // uma fração de tick acima do da velocidade máxima
+    uint32_t cruise = (uint32_t)(TEST_TICKS_PER_SECOND / REF_MAX_SPEED);
+    uint32_t rampEnd = move.intervals[REF_RAMP_STEPS - 1];
+    for (uint32_t n = REF_RAMP_STEPS; n < REF_STEPS - REF_RAMP_STEPS; n++) {
+        TEST_ASSERT_GREATER_OR_EQUAL(cruise, move.intervals[n]);
+        TEST_ASSERT_LESS_OR_EQUAL(rampEnd, move.intervals[n]);
+    }
+}
+
+// A frenagem é a aceleração ao contrário, a partir de c(1): o último
+// intervalo é o segundo da rampa, sem a correção do primeiro passo
+static void test_deceleration_mirrors_acceleration() {
+    // Trapézio e triângulo (sem platô: a rampa é limitada à metade)
+    static const float cases[][3] = {
+        {REF_STEPS, REF_MAX_SPEED, REF_ACCELERATION},
+        {301,       REF_MAX_SPEED, REF_ACCELERATION},
+    };
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t steps = (uint32_t)cases[i][0];
+        DecodedMove move = encodeAndDecode(steps, cases[i][1], cases[i][2]);
+        uint32_t last = move.intervals.size() - 1;
+        uint32_t ramp = std::min((uint32_t)REF_RAMP_STEPS, steps / 2);
+        for (uint32_t n = 1; n < ramp; n++) {
+            TEST_ASSERT_UINT32_WITHIN(2, move.intervals[n], move.intervals[last + 1 - n]);
+        }
+    }
+}
+
+void runStepPulseEncoderTests() {
+    RUN_TEST(test_step_count_and_pulse_width);
+    RUN_TEST(test_ramp_follows_exact_profile);
+    RUN_TEST(test_deceleration_mirrors_acceleration);
+}
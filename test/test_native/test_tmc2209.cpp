@@ -0,0 +1,114 @@
+#include <unity.h>
+#include <vector>
+#include "HostHal.h"
+#include "StepperDriver.h"
+#include "config.h"
+
+// O TMC2209Driver aceita qualquer Stream como UART: aqui uma porta falsa
+// captura os datagramas para conferir o protocolo byte a byte.
+class CaptureStream : public Stream {
+public:
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> flushedAt;     // Bytes escritos a cada flush()
+
+    size_t write(uint8_t c) override { bytes.push_back(c); return 1; }
+    using Print::write;
+    void flush() override { flushedAt.push_back(bytes.size()); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+#define TEST_TMC_ADDRESS 2
+#define DATAGRAM_SIZE    8
+
+// CRC8 do datasheet escrito de outro jeito: bytes espelhados e CRC-8
+// comum (polinômio 0x07, MSB primeiro), para não conferir o driver com ele mesmo
+static uint8_t referenceCrc(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t reflected = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (data[i] & (1 << bit)) reflected |= 0x80 >> bit;
+        }
+        crc ^= reflected;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Confere o datagrama de escrita 'index' capturado: sync, endereço,
+// registrador | 0x80, dados com o MSB primeiro e CRC; cada um sai inteiro
+// antes do flush()
+static void assertWriteDatagram(const CaptureStream& port, size_t index, uint8_t reg, uint32_t value) {
+    TEST_ASSERT_TRUE(port.bytes.size() >= (index + 1) * DATAGRAM_SIZE);
+    TEST_ASSERT_TRUE(port.flushedAt.size() > index);
+    TEST_ASSERT_EQUAL_UINT32((index + 1) * DATAGRAM_SIZE, port.flushedAt[index]);
+
+    const uint8_t* datagram = &port.bytes[index * DATAGRAM_SIZE];
+    TEST_ASSERT_EQUAL_HEX8(0x05, datagram[0]);
+    TEST_ASSERT_EQUAL_HEX8(TEST_TMC_ADDRESS, datagram[1]);
+    TEST_ASSERT_EQUAL_HEX8(reg | 0x80, datagram[2]);
+    uint32_t data = ((uint32_t)datagram[3] << 24) | ((uint32_t)datagram[4] << 16) |
+                    ((uint32_t)datagram[5] << 8) | datagram[6];
+    TEST_ASSERT_EQUAL_HEX32(value, data);
+    TEST_ASSERT_EQUAL_HEX8(referenceCrc(datagram, 7), datagram[7]);
+}
+
+// Datagramas conhecidos, CRC calculado à parte
+static void test_crc8_known_datagrams() {
+    static const uint8_t gconf[7] = {0x05, 0x00, 0x80, 0x00, 0x00, 0x01, 0xC1};
+    static const uint8_t readIfcnt[3] = {0x05, 0x00, 0x02};
+    TEST_ASSERT_EQUAL_HEX8(0x7F, TMC2209Driver::crc8(gconf, 7));
+    TEST_ASSERT_EQUAL_HEX8(0x8F, TMC2209Driver::crc8(readIfcnt, 3));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, referenceCrc(gconf, 7));
+    TEST_ASSERT_EQUAL_HEX8(0x00, TMC2209Driver::crc8(gconf, 0));
+}
+
+// begin(): endereço nos pinos MS1/MS2, GCONF (corrente pelo VREF, UART,
+// micro-passo pelo MRES, filtro) e IHOLD_IRUN com as correntes de config.h
+static void test_begin_writes_gconf_and_currents() {
+    CaptureStream port;
+    TMC2209Driver driver(port, TEST_TMC_ADDRESS);
+    driver.begin();
+
+    TEST_ASSERT_EQUAL_INT(LOW, HostHal::outputLevel(MS1_PIN));
+    TEST_ASSERT_EQUAL_INT(HIGH, HostHal::outputLevel(MS2_PIN));
+    TEST_ASSERT_EQUAL_UINT32(2 * DATAGRAM_SIZE, port.bytes.size());
+    assertWriteDatagram(port, 0, TMC2209Driver::REG_GCONF, 0x000001C1);
+    uint32_t iholdIrun = TMC_HOLD_CURRENT | (TMC_RUN_CURRENT << 8) | ((uint32_t)TMC_HOLD_DELAY << 16);
+    assertWriteDatagram(port, 1, TMC2209Driver::REG_IHOLD_IRUN, iholdIrun);
+}
+
+// Cada resolução vai para o MRES do CHOPCONF (8 = passo inteiro ... 0 =
+// 1/256), preservando o resto do registrador e com a interpolação ligada
+static void test_each_microstep_writes_chopconf_mres() {
+    CaptureStream port;
+    TMC2209Driver driver(port, TEST_TMC_ADDRESS);
+    for (int index = 0; index < TMC2209Driver::MICROSTEP_COUNT; index++) {
+        driver.applyMicrostep(index);
+        uint32_t mres = TMC2209Driver::MICROSTEP_COUNT - 1 - index;
+        TEST_ASSERT_EQUAL_UINT32(256 >> mres, TMC2209Driver::multipliers[index]);
+        assertWriteDatagram(port, index, TMC2209Driver::REG_CHOPCONF, 0x10000053UL | (mres << 24));
+    }
+    TEST_ASSERT_EQUAL_UINT32(TMC2209Driver::MICROSTEP_COUNT * DATAGRAM_SIZE, port.bytes.size());
+}
+
+static void test_set_currents_masks_fields() {
+    CaptureStream port;
+    TMC2209Driver driver(port, TEST_TMC_ADDRESS);
+    driver.setCurrents(31, 0);
+    driver.setCurrents(0xFF, 0xFF);
+    assertWriteDatagram(port, 0, TMC2209Driver::REG_IHOLD_IRUN, (31UL << 8) | ((uint32_t)TMC_HOLD_DELAY << 16));
+    assertWriteDatagram(port, 1, TMC2209Driver::REG_IHOLD_IRUN,
+                        0x1FUL | (0x1FUL << 8) | ((uint32_t)TMC_HOLD_DELAY << 16));
+}
+
+void runTmc2209Tests() {
+    RUN_TEST(test_crc8_known_datagrams);
+    RUN_TEST(test_begin_writes_gconf_and_currents);
+    RUN_TEST(test_each_microstep_writes_chopconf_mres);
+    RUN_TEST(test_set_currents_masks_fields);
+}
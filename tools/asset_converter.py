@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+# Conversor de imagens e conjuntos de glifos para o display (etapa de build).
+#
+# Lê assets/assets.json e as imagens PBM (P1 ou P4) de assets/, converte para
+# o formato de páginas do SSD1306 (cada byte é uma coluna de 8 pixels, bit 0
+# em cima), comprime em RLE ou RLE com delta e gera include/Assets.h e
+# src/Assets.cpp. Pixel aceso no OLED = branco na imagem, como nos quadros do
+# backend do host.
+#
+# Fluxo comprimido (decodificado por FrameCanvas::drawPacked):
+#   0x00-0x7F  literal: seguem c + 1 bytes
+#   0x80-0xFF  repetição: o byte seguinte, c - 0x80 + 3 vezes
+# Com delta, cada byte é o XOR com o byte anterior da mesma página.
+#
+# Roda antes de cada build pelo PlatformIO (extra_scripts) ou à mão:
+#   python tools/asset_converter.py
+# Os arquivos gerados só são regravados quando o conteúdo muda.
+
+import json
+import os
+import sys
+
+ENCODING_RLE = "ASSET_RLE"
+ENCODING_RLE_DELTA = "ASSET_RLE_DELTA"
+
+MAX_LITERAL = 128
+MIN_RUN = 3
+MAX_RUN = 127 + MIN_RUN
+
+
+def read_pbm(path):
+    """Devolve (largura, altura, linhas de pixels acesos)."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    # Cabeçalho: tipo, largura e altura, com comentários '#'
+    tokens = []
+    pos = 0
+    while len(tokens) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            while data[pos:pos + 1] not in (b"\n", b""):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(data[start:pos].decode("ascii"))
+    kind, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+
+    if kind == "P4":
+        pos += 1  # Um único espaço antes dos dados binários
+        stride = (width + 7) // 8
+        bits = data[pos:pos + stride * height]
+        if len(bits) != stride * height:
+            raise ValueError("%s: dados incompletos" % path)
+        # Bit 1 = preto = pixel apagado
+        rows = [[not (bits[y * stride + x // 8] & (0x80 >> (x & 7))) for x in range(width)]
+                for y in range(height)]
+    elif kind == "P1":
+        values = [c for c in data[pos:].decode("ascii") if c in "01"]
+        if len(values) != width * height:
+            raise ValueError("%s: dados incompletos" % path)
+        rows = [[values[y * width + x] == "0" for x in range(width)] for y in range(height)]
+    else:
+        raise ValueError("%s: use PBM P1 ou P4" % path)
+    return width, height, rows
+
+
+def to_pages(rows, x0, width, height):
+    """Colunas x0..x0+width-1 em páginas; bits abaixo da altura ficam em 0."""
+    pages = []
+    for page in range((height + 7) // 8):
+        for x in range(x0, x0 + width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and rows[y][x]:
+                    byte |= 1 << bit
+            pages.append(byte)
+    return pages
+
+
+def delta(data, width):
+    out = []
+    for i, byte in enumerate(data):
+        previous = 0 if i % width == 0 else data[i - 1]
+        out.append(byte ^ previous)
+    return out
+
+
+def rle(data):
+    out = []
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            del literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < MAX_RUN:
+            run += 1
+        if run >= MIN_RUN:
+            flush_literal()
+            out.append(0x80 + run - MIN_RUN)
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush_literal()
+    return out
+
+
+def compress(pages, width):
+    """Escolhe a codificação menor para o fluxo de páginas."""
+    plain = rle(pages)
+    delta_coded = rle(delta(pages, width))
+    if len(delta_coded) < len(plain):
+        return ENCODING_RLE_DELTA, delta_coded
+    return ENCODING_RLE, plain
+
+
+def compress_set(glyphs, width):
+    """Um conjunto de glifos usa a mesma codificação em todos."""
+    plain = [rle(g) for g in glyphs]
+    delta_coded = [rle(delta(g, width)) for g in glyphs]
+    if sum(map(len, delta_coded)) < sum(map(len, plain)):
+        return ENCODING_RLE_DELTA, delta_coded
+    return ENCODING_RLE, plain
+
+
+def c_array(data, indent="    "):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def convert_bitmap(entry, assets_dir):
+    width, height, rows = read_pbm(os.path.join(assets_dir, entry["source"]))
+    if width > 255 or height > 255:
+        raise ValueError("%s: maior que 255 pixels" % entry["source"])
+    pages = to_pages(rows, 0, width, height)
+    encoding, data = compress(pages, width)
+    name = entry["name"]
+
+    declaration = "extern const CompressedBitmap %s;" % name
+    comment = "// %s: %dx%d, %d -> %d bytes (%s)" % (entry["source"], width, height,
+                                                     width * height // 8, len(data), encoding)
+    definition = "\n".join([
+        comment,
+        "static const uint8_t %sData[] PROGMEM = {" % name,
+        c_array(data),
+        "};",
+        "const CompressedBitmap %s = {%d, %d, %s, sizeof(%sData), %sData};" % (
+            name, width, height, encoding, name, name),
+    ])
+    return declaration, comment, definition, (width * height + 7) // 8, len(data)
+
+
+def convert_font(entry, assets_dir):
+    width, height, rows = read_pbm(os.path.join(assets_dir, entry["source"]))
+    cell = entry["cell_width"]
+    first = entry["first"]
+    if width % cell or cell > 255 or height > 255:
+        raise ValueError("%s: largura não é múltipla de cell_width" % entry["source"])
+    count = width // cell
+    if ord(first) + count > 256:
+        raise ValueError("%s: glifos além do código 255" % entry["source"])
+
+    glyphs = [to_pages(rows, i * cell, cell, height) for i in range(count)]
+    encoding, coded = compress_set(glyphs, cell)
+    offsets = [0]
+    for glyph in coded:
+        offsets.append(offsets[-1] + len(glyph))
+    data = [b for glyph in coded for b in glyph]
+    name = entry["name"]
+    raw = count * cell * ((height + 7) // 8)
+    size = len(data) + 2 * len(offsets)
+
+    declaration = "extern const CompressedFont %s;" % name
+    comment = "// %s: %d glifos %dx%d a partir de '%s', %d -> %d bytes (%s)" % (
+        entry["source"], count, cell, height, first, raw, size, encoding)
+    definition = "\n".join([
+        comment,
+        "static const uint8_t %sData[] PROGMEM = {" % name,
+        c_array(data),
+        "};",
+        "static const uint16_t %sOffsets[] PROGMEM = {" % name,
+        "    " + ", ".join(str(o) for o in offsets) + ",",
+        "};",
+        "const CompressedFont %s = {%d, %d, %s, %d, %d, %sOffsets, %sData};" % (
+            name, cell, height, encoding, ord(first), count, name, name),
+    ])
+    return declaration, comment, definition, raw, size
+
+
+def write_if_changed(path, content):
+    if os.path.exists(path):
+        with open(path, "r") as f:
+            if f.read() == content:
+                return False
+    with open(path, "w") as f:
+        f.write(content)
+    return True
+
+
+def convert(project_dir):
+    assets_dir = os.path.join(project_dir, "assets")
+    with open(os.path.join(assets_dir, "assets.json")) as f:
+        manifest = json.load(f)
+
+    results = [convert_bitmap(e, assets_dir) for e in manifest.get("bitmaps", [])]
+    results += [convert_font(e, assets_dir) for e in manifest.get("fonts", [])]
+
+    banner = "// Gerado por tools/asset_converter.py a partir de assets/assets.json. Não editar.\n"
+    header = banner + "\n".join([
+        "#ifndef ASSETS_H",
+        "#define ASSETS_H",
+        "",
+        '#include "CompressedAsset.h"',
+        "",
+    ] + ["%s\n%s" % (comment, declaration) for declaration, comment, _, _, _ in results] + [
+        "",
+        "#endif",
+        "",
+    ])
+    source = banner + "\n".join([
+        '#include "Assets.h"',
+        "",
+    ] + ["%s\n" % definition for _, _, definition, _, _ in results])
+
+    changed = write_if_changed(os.path.join(project_dir, "include", "Assets.h"), header)
+    changed = write_if_changed(os.path.join(project_dir, "src", "Assets.cpp"), source) or changed
+
+    raw = sum(r[3] for r in results)
+    packed = sum(r[4] for r in results)
+    print("Assets: %d -> %d bytes na flash (%d%%)%s" % (
+        raw, packed, 100 * packed // max(raw, 1), "" if changed else ", sem alterações"))
+
+
+try:
+    Import("env")  # noqa: F821 (definido pelo SCons do PlatformIO)
+    convert(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        convert(os.path.dirname(os.path.dirname(os.path.abspath(sys.argv[0]))))